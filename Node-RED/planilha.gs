@@ -0,0 +1,55 @@
+/**
+ * Apps Script da planilha do BotoSmart (Implantar > Aplicativo da Web, acesso "Qualquer pessoa").
+ *
+ * doPost: recebe os lotes do fluxo do Node-RED, {"linhas": [{id, inicio, fim, n, min_mm, max_mm, media_mm}]},
+ * e grava todas as linhas numa chamada só (uma execução do script por lote, não por leitura).
+ * doGet: mantém o formato antigo (?id=...&distancia=...) para nós ainda não migrados.
+ */
+var ABA = "Leituras";
+var COLUNAS = ["id", "inicio", "fim", "n", "min_mm", "max_mm", "media_mm"];
+
+function aba_() {
+  var planilha = SpreadsheetApp.getActiveSpreadsheet();
+  var aba = planilha.getSheetByName(ABA) || planilha.insertSheet(ABA);
+  if (aba.getLastRow() === 0) {
+    aba.appendRow(COLUNAS);
+  }
+  return aba;
+}
+
+function responder_(corpo) {
+  return ContentService.createTextOutput(JSON.stringify(corpo)).setMimeType(ContentService.MimeType.JSON);
+}
+
+function doPost(e) {
+  var linhas;
+  try {
+    linhas = JSON.parse(e.postData.contents).linhas;
+  } catch (erro) {
+    return responder_({ ok: false, erro: "JSON inválido" });
+  }
+  if (!Array.isArray(linhas) || linhas.length === 0) {
+    return responder_({ ok: false, erro: "sem linhas" });
+  }
+
+  // Lotes simultâneos de fluxos diferentes não podem intercalar a escrita
+  var trava = LockService.getScriptLock();
+  trava.waitLock(20000);
+  try {
+    var aba = aba_();
+    var valores = linhas.map(function (l) {
+      return COLUNAS.map(function (c) { return l[c]; });
+    });
+    aba.getRange(aba.getLastRow() + 1, 1, valores.length, COLUNAS.length).setValues(valores);
+  } finally {
+    trava.releaseLock();
+  }
+  return responder_({ ok: true, linhas: linhas.length });
+}
+
+function doGet(e) {
+  var agora = new Date().toISOString();
+  var d = parseFloat(e.parameter.distancia);
+  aba_().appendRow([e.parameter.id, agora, agora, 1, d, d, d]);
+  return responder_({ ok: true, linhas: 1 });
+}
@@ -0,0 +1,52 @@
+// bench_estatistica.c
+
+#include "bench_estatistica.h"
+#include <stdlib.h>
+#include <string.h>
+
+// xorshift32: determinístico entre rodadas, sem depender da libc
+static uint32_t sorteio(void) {
+    static uint32_t x = 2463534242u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return x;
+}
+
+void bench_registrar(bench_etapa_t *etapa, uint64_t duracao_us, uint64_t bytes_i2c) {
+    uint32_t d = (uint32_t)duracao_us;
+    if (etapa->n == 0 || d < etapa->min_us) etapa->min_us = d;
+    etapa->soma_us += d;
+    etapa->bytes_i2c += bytes_i2c;
+    etapa->n++;
+    // Reservatório (algoritmo R): a n-ésima execução entra com probabilidade MAX/n
+    if (etapa->n <= BENCH_MAX_AMOSTRAS) {
+        etapa->duracoes_us[etapa->n - 1] = d;
+    } else {
+        uint32_t k = sorteio() % etapa->n;
+        if (k < BENCH_MAX_AMOSTRAS) etapa->duracoes_us[k] = d;
+    }
+}
+
+static int comparar_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void bench_imprimir(bench_etapa_t *const etapas[], int num_etapas) {
+    printf("%-20s %6s %10s %10s %10s %12s\n", "etapa", "n", "min_us", "media_us", "p99_us", "bytes_i2c/op");
+    for (int i = 0; i < num_etapas; i++) {
+        bench_etapa_t *e = etapas[i];
+        if (e->n == 0) {
+            printf("%-20s %6s\n", e->nome, "-");
+            continue;
+        }
+        // Ordena no próprio vetor: o relatório é o fim da rodada
+        uint32_t guardadas = e->n < BENCH_MAX_AMOSTRAS ? e->n : BENCH_MAX_AMOSTRAS;
+        qsort(e->duracoes_us, guardadas, sizeof(uint32_t), comparar_u32);
+        uint32_t p99 = e->duracoes_us[(guardadas * 99 + 99) / 100 - 1];
+        printf("%-20s %6lu %10lu %10.1f %10lu %12.1f\n", e->nome, (unsigned long)e->n,
+               (unsigned long)e->min_us, (double)e->soma_us / e->n, (unsigned long)p99,
+               (double)e->bytes_i2c / e->n);
+    }
+}
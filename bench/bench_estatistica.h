@@ -0,0 +1,37 @@
+// bench_estatistica.h - Amostras de duração por etapa e relatório min/média/p99
+
+#ifndef BENCH_ESTATISTICA_H
+#define BENCH_ESTATISTICA_H
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+#define BENCH_MAX_AMOSTRAS 1024
+
+// n, mínimo, média e bytes contam todas as execuções; o p99 sai de uma amostra uniforme de
+// até BENCH_MAX_AMOSTRAS durações (reservatório), que é exata enquanto n não passa disso
+typedef struct {
+    const char *nome;
+    uint32_t n;
+    uint32_t min_us;
+    uint64_t soma_us;
+    uint64_t bytes_i2c;
+    uint32_t duracoes_us[BENCH_MAX_AMOSTRAS];
+} bench_etapa_t;
+
+// Bytes trafegados nos barramentos I2C desde o boot (bench_i2c.c)
+uint64_t bench_i2c_bytes(void);
+
+void bench_registrar(bench_etapa_t *etapa, uint64_t duracao_us, uint64_t bytes_i2c);
+void bench_imprimir(bench_etapa_t *const etapas[], int num_etapas);
+
+// Mede 'codigo' como uma execução da etapa: tempo por time_us_64() e bytes no I2C
+#define BENCH_MEDIR(etapa, codigo)                                                      \
+    do {                                                                                \
+        uint64_t bench_bytes0_ = bench_i2c_bytes();                                     \
+        uint64_t bench_t0_ = time_us_64();                                              \
+        codigo;                                                                         \
+        bench_registrar(&(etapa), time_us_64() - bench_t0_, bench_i2c_bytes() - bench_bytes0_); \
+    } while (0)
+
+#endif // BENCH_ESTATISTICA_H
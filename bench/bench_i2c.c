@@ -0,0 +1,41 @@
+// bench_i2c.c - Conta os bytes de cada transação I2C (ligado com -Wl,--wrap=...)
+//
+// Os contadores incluem o byte de endereço, como no barramento físico.
+
+#include "bench_estatistica.h"
+#include "hardware/i2c.h"
+
+static volatile uint64_t bytes_i2c;
+
+uint64_t bench_i2c_bytes(void) {
+    return bytes_i2c;
+}
+
+int __real_i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int __real_i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+int __real_i2c_write_blocking_until(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                                    absolute_time_t until);
+int __real_i2c_read_blocking_until(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop,
+                                   absolute_time_t until);
+
+int __wrap_i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    bytes_i2c += len + 1;
+    return __real_i2c_write_blocking(i2c, addr, src, len, nostop);
+}
+
+int __wrap_i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    bytes_i2c += len + 1;
+    return __real_i2c_read_blocking(i2c, addr, dst, len, nostop);
+}
+
+int __wrap_i2c_write_blocking_until(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                                    absolute_time_t until) {
+    bytes_i2c += len + 1;
+    return __real_i2c_write_blocking_until(i2c, addr, src, len, nostop, until);
+}
+
+int __wrap_i2c_read_blocking_until(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop,
+                                   absolute_time_t until) {
+    bytes_i2c += len + 1;
+    return __real_i2c_read_blocking_until(i2c, addr, dst, len, nostop, until);
+}
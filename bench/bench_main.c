@@ -0,0 +1,94 @@
+// bench_main.c - Latência e custo em I2C de cada etapa do ciclo de medição
+//
+// Roda na placa (relatório pela USB) e no host (cmake -DBOTOSMART_HOST=ON, tempo virtual).
+// No host o tempo medido é o modelado pela simulação: sleeps e bytes no barramento;
+// etapas só de CPU aparecem como 0 us.
+
+#include "config.h"
+#include "bench_estatistica.h"
+#include "energia.h"
+#include "hardware_oled.h"
+#include "intertravamento.h"
+#include "monitor.h"
+#include "mqtt_config.h"
+
+#define BENCH_JANELAS 100
+
+static bench_etapa_t leitura      = {.nome = "leitura_sensor"};
+static bench_etapa_t janela_total = {.nome = "janela_aquisicao"};
+static bench_etapa_t filtragem    = {.nome = "filtragem"};
+static bench_etapa_t decisao      = {.nome = "decisao_alerta"};
+static bench_etapa_t publicacao   = {.nome = "publicacao_mqtt"};
+static bench_etapa_t grafico      = {.nome = "render_grafico"};
+static bench_etapa_t tela_cheia   = {.nome = "render_tela_cheia"};
+
+static bool bench_conectar() {
+    if (cyw43_arch_init()) return false;
+    cyw43_arch_enable_sta_mode();
+    if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 30000)) {
+        return false;
+    }
+    mqtt_iniciar();
+    for (int i = 0; i < 100 && !mqtt_esta_conectado(); i++) sleep_ms(100);
+    return mqtt_esta_conectado();
+}
+
+int main() {
+    stdio_init_all();
+#if PICO_ON_DEVICE
+    while (!stdio_usb_connected()) sleep_ms(100);
+#endif
+
+    energia_iniciar();
+    hardware_init();
+    monitor_iniciar();
+    bool rede_ok = bench_conectar();
+    printf("[bench] rede %s, %d janelas de %d leituras\n", rede_ok ? "conectada" : "indisponível",
+           BENCH_JANELAS, MONITOR_AMOSTRAS_JANELA);
+
+    // O display é exercitado direto, sem a tarefa do core 1, para medir o envio em si
+    hardware_oled_grafico_iniciar("Benchmark");
+    SystemState estado = ESTADO_ANALISANDO;
+
+    for (int j = 0; j < BENCH_JANELAS; j++) {
+        monitor_janela_t janela;
+        BENCH_MEDIR(janela_total, {
+            monitor_janela_limpar(&janela);
+            for (int i = 0; i < MONITOR_AMOSTRAS_JANELA; i++) {
+                uint16_t dist = 0;
+                uint8_t qualidade = 0;
+                bool ok;
+                BENCH_MEDIR(leitura, ok = monitor_ler_amostra(&dist, &qualidade));
+                if (ok) monitor_janela_adicionar(&janela, dist, qualidade);
+                else monitor_janela_descartar(&janela, 1);
+                sleep_ms(6);
+            }
+        });
+
+        uint16_t media = 0;
+        bool tem_media;
+        BENCH_MEDIR(filtragem, tem_media = monitor_janela_media(&janela, &media));
+        if (!tem_media) continue;
+
+        BENCH_MEDIR(decisao, {
+            intertravamento_avaliar(media);
+            monitor_decidir(&estado, media);
+        });
+        if (rede_ok) {
+            BENCH_MEDIR(publicacao, monitor_publicar_medicao(media));
+        }
+        BENCH_MEDIR(grafico, hardware_oled_grafico_adicionar(media));
+    }
+
+    for (int k = 0; k < 20; k++) {
+        BENCH_MEDIR(tela_cheia, hardware_oled_exibir("Benchmark", "Tela cheia"));
+    }
+
+    bench_etapa_t *const etapas[] = {&leitura, &janela_total, &filtragem, &decisao, &publicacao, &grafico, &tela_cheia};
+    bench_imprimir(etapas, count_of(etapas));
+
+#if PICO_ON_DEVICE
+    while (true) sleep_ms(1000);
+#endif
+    return 0;
+}
@@ -0,0 +1,41 @@
+// boot_ota.c - Estágio de boot fixo: conclui a troca de slots pedida pela OTA e salta para o slot A
+//
+// Fica nos primeiros OTA_BOOT_TAMANHO bytes da flash, com o boot2 do SDK, e a OTA nunca o
+// regrava. Gravado uma vez por USB (botosmart_boot.uf2); o firmware vem depois, no slot A.
+
+#include "ota_troca.h"
+#include "hardware/regs/m0plus.h"
+#include "hardware/watchdog.h"
+#include "pico/bootrom.h"
+#include "pico/stdlib.h"
+
+// O firmware é ligado para o slot A e começa com o próprio boot2 (256 bytes, sem uso aqui)
+#define VETORES_FIRMWARE (XIP_BASE + OTA_SLOT_A_OFFSET + 0x100)
+
+static void alimentar() {
+    watchdog_update();
+}
+
+static void __attribute__((noreturn)) saltar(uint32_t vetores) {
+    const uint32_t *v = (const uint32_t *)vetores;
+    // Nada deste estágio pode disparar no firmware: interrupções desligadas e sem pendências
+    *(io_rw_32 *)(PPB_BASE + M0PLUS_NVIC_ICER_OFFSET) = 0xFFFFFFFFu;
+    *(io_rw_32 *)(PPB_BASE + M0PLUS_NVIC_ICPR_OFFSET) = 0xFFFFFFFFu;
+    *(io_rw_32 *)(PPB_BASE + M0PLUS_VTOR_OFFSET) = vetores;
+    __asm volatile("msr msp, %0\n\tbx %1" : : "r"(v[0]), "r"(v[1]));
+    __builtin_unreachable();
+}
+
+int main() {
+    if (ota_troca_pendente()) {
+        // Segue armado no firmware: se a imagem nova travar antes de ota_iniciar(), o watchdog
+        // reinicia e ela conta como um boot sem confirmação
+        watchdog_enable(OTA_TROCA_WATCHDOG_MS, true);
+        ota_troca_executar(alimentar);
+    }
+
+    // Slot A apagado (primeira gravação incompleta): só resta o USB
+    uint32_t pilha = *(const uint32_t *)VETORES_FIRMWARE;
+    if (pilha < SRAM_BASE || pilha > SRAM_END) reset_usb_boot(0, 0);
+    saltar(VETORES_FIRMWARE);
+}
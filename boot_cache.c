@@ -0,0 +1,60 @@
+// boot_cache.c - Um setor no fim da flash com BSSID, canal e concessão DHCP, protegido por CRC
+
+#include "config.h"
+#include "boot_cache.h"
+#include "crc32.h"
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include <string.h>
+
+#define BOOT_CACHE_MAGICA 0x424F4F54u // "BOOT"
+#define BOOT_CACHE_VERSAO 1
+#define BOOT_CACHE_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+typedef struct {
+    uint32_t magica;
+    uint32_t versao;
+    boot_cache_t dados;
+    uint32_t crc;
+} registro_t;
+
+static_assert(sizeof(registro_t) <= FLASH_PAGE_SIZE, "a cache deve caber em uma página");
+
+static const registro_t *registro_flash() {
+    return (const registro_t *)(XIP_BASE + BOOT_CACHE_OFFSET);
+}
+
+bool boot_cache_ler(boot_cache_t *cache) {
+    const registro_t *r = registro_flash();
+    if (r->magica != BOOT_CACHE_MAGICA || r->versao != BOOT_CACHE_VERSAO) return false;
+    if (r->crc != crc32_calcular(&r->dados, sizeof(r->dados))) return false;
+    *cache = r->dados;
+    return true;
+}
+
+// Roda com o XIP desligado: não pode ler a flash nem chamar código fora da RAM além destas funções
+static void gravar_setor(void *param) {
+    flash_range_erase(BOOT_CACHE_OFFSET, FLASH_SECTOR_SIZE);
+    if (param) flash_range_program(BOOT_CACHE_OFFSET, param, FLASH_PAGE_SIZE);
+}
+
+bool boot_cache_salvar(const boot_cache_t *cache) {
+    static uint8_t pagina[FLASH_PAGE_SIZE];
+    registro_t r = {0};
+    r.magica = BOOT_CACHE_MAGICA;
+    r.versao = BOOT_CACHE_VERSAO;
+    r.dados = *cache;
+    r.crc = crc32_calcular(&r.dados, sizeof(r.dados));
+
+    // Flash tem ciclos de escrita limitados: só grava quando algo mudou
+    if (memcmp(registro_flash(), &r, sizeof(r)) == 0) return true;
+
+    memset(pagina, 0xFF, sizeof(pagina));
+    memcpy(pagina, &r, sizeof(r));
+    return flash_safe_execute(gravar_setor, pagina, FLASH_SEGURA_TIMEOUT_MS) == PICO_OK;
+}
+
+bool boot_cache_apagar() {
+    if (registro_flash()->magica == 0xFFFFFFFFu) return true;
+    return flash_safe_execute(gravar_setor, NULL, FLASH_SEGURA_TIMEOUT_MS) == PICO_OK;
+}
@@ -0,0 +1,39 @@
+// boot_cache.h - Dados da última conexão Wi-Fi guardados em flash para a inicialização rápida
+
+#ifndef BOOT_CACHE_H
+#define BOOT_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    char ssid[33];        // a cache só vale para a rede em que foi gravada
+    uint8_t bssid[6];
+    uint8_t canal;
+    // Última concessão DHCP (0 = nenhuma), no formato de ip4_addr_get_u32()
+    uint32_t ip;
+    uint32_t mascara;
+    uint32_t gateway;
+} boot_cache_t;
+
+/**
+ * @brief Lê a cache do último setor da flash.
+ *
+ * @return false se o setor está apagado, corrompido ou é de outra versão.
+ */
+bool boot_cache_ler(boot_cache_t *cache);
+
+/**
+ * @brief Grava a cache, se ela mudou. Apaga e programa um setor (~50 ms com o XIP parado).
+ *
+ * O core 1 precisa ter chamado multicore_lockout_victim_init().
+ * @return true se a cache em flash está igual à informada ao final.
+ */
+bool boot_cache_salvar(const boot_cache_t *cache);
+
+/**
+ * @brief Invalida a cache (ex.: o AP mudou de canal ou a concessão não vale mais).
+ */
+bool boot_cache_apagar();
+
+#endif // BOOT_CACHE_H
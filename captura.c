@@ -0,0 +1,100 @@
+// captura.c - Fila da IRQ para a USB, sem printf: quadros prontos escritos de uma vez
+
+#include "config.h"
+#include "captura.h"
+#include "crc16.h"
+#include "metricas.h"
+#include "pico/stdlib.h"
+#include <string.h>
+
+#define CAPTURA_SINCRONIA_0   0xA5
+#define CAPTURA_SINCRONIA_1   0x5A
+#define CAPTURA_TIPO_AMOSTRA  1
+#define CAPTURA_PAYLOAD       16
+#define CAPTURA_PAYLOAD_MAX   64
+
+#define CAPTURA_FLAG_ERRO     0x01
+#define CAPTURA_FLAG_ACEITA   0x02
+
+typedef struct {
+    uint32_t seq;
+    uint32_t t_us;
+    vl53l0x_medicao_t medicao;
+    uint8_t flags;
+} registro_t;
+
+// Mesma fila de um produtor (IRQ) e um consumidor (laço) do intertravamento, no core 0
+static struct {
+    volatile bool ativa;
+    uint32_t seq;
+    registro_t fila[CAPTURA_FILA];
+    volatile uint32_t escrita, leitura;
+} cap;
+
+void captura_alternar() {
+    if (!cap.ativa) cap.seq = 0; // cada captura começa do seq 0
+    cap.ativa = !cap.ativa;
+}
+
+bool captura_ativa() {
+    return cap.ativa;
+}
+
+void captura_registrar(const vl53l0x_medicao_t *medicao, uint32_t t_us, bool aceita) {
+    if (!cap.ativa) return;
+    uint32_t seq = cap.seq++;
+    if (cap.escrita - cap.leitura == CAPTURA_FILA) {
+        metricas_incrementar(METRICA_CAPTURA_DESCARTES);
+        return;
+    }
+    registro_t *r = &cap.fila[cap.escrita % CAPTURA_FILA];
+    r->seq = seq;
+    r->t_us = t_us;
+    r->medicao = medicao ? *medicao : (vl53l0x_medicao_t){0};
+    r->flags = (medicao ? 0 : CAPTURA_FLAG_ERRO) | (aceita ? CAPTURA_FLAG_ACEITA : 0);
+    __compiler_memory_barrier();
+    cap.escrita++;
+}
+
+static uint8_t *le16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint8_t *le32(uint8_t *p, uint32_t v) {
+    return le16(le16(p, (uint16_t)v), (uint16_t)(v >> 16));
+}
+
+void captura_quadro(uint8_t tipo, const uint8_t *payload, uint8_t tamanho) {
+    uint8_t quadro[4 + CAPTURA_PAYLOAD_MAX + 2];
+    if (tamanho > CAPTURA_PAYLOAD_MAX) return;
+    quadro[0] = CAPTURA_SINCRONIA_0;
+    quadro[1] = CAPTURA_SINCRONIA_1;
+    quadro[2] = tipo;
+    quadro[3] = tamanho;
+    memcpy(quadro + 4, payload, tamanho);
+    le16(quadro + 4 + tamanho, crc16_calcular(quadro + 2, 2 + tamanho));
+    // Sem tradução de \n para \r\n: os bytes saem como estão
+    stdio_put_string((const char *)quadro, 4 + tamanho + 2, false, false);
+}
+
+static void enviar(const registro_t *r) {
+    uint8_t payload[CAPTURA_PAYLOAD];
+    uint8_t *p = le32(le32(payload, r->seq), r->t_us);
+    p = le16(p, r->medicao.distancia_mm);
+    *p++ = r->medicao.status;
+    *p++ = r->flags;
+    le16(le16(p, r->medicao.sinal_mcps), r->medicao.ambiente_mcps);
+    captura_quadro(CAPTURA_TIPO_AMOSTRA, payload, sizeof(payload));
+}
+
+void captura_processar() {
+    while (cap.leitura != cap.escrita) {
+        __compiler_memory_barrier();
+        registro_t r = cap.fila[cap.leitura % CAPTURA_FILA];
+        __compiler_memory_barrier();
+        cap.leitura++;
+        enviar(&r);
+    }
+}
@@ -0,0 +1,43 @@
+// captura.h - Cada leitura bruta do VL53L0X em quadros binários pela USB, para o laboratório
+
+#ifndef CAPTURA_H
+#define CAPTURA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "vl53l0x.h"
+
+/**
+ * @brief Liga ou desliga a captura (tecla CAPTURA_COMANDO_USB no terminal).
+ *
+ * Ligada, cada medição terminada pela IRQ do intertravamento vira um quadro:
+ *
+ *   0xA5 0x5A | tipo (1) | tamanho (16) | seq u32 | t_us u32 | distancia_mm u16 |
+ *   status u8 | flags u8 | sinal u16 | ambiente u16 | CRC-16 u16
+ *
+ * Inteiros em little-endian; o CRC-16/CCITT cobre de tipo ao fim do payload. flags: bit 0 =
+ * erro de I2C ou timeout (sem dados), bit 1 = leitura aceita pelo firmware. O seq avança
+ * também nos quadros descartados por fila cheia, então o receptor vê a falta. O texto do
+ * printf continua saindo entre os quadros; o receptor o descarta ao procurar a sincronia.
+ */
+void captura_alternar();
+
+bool captura_ativa();
+
+/**
+ * @brief Enfileira uma medição; chamada na IRQ. medicao = NULL registra uma falha de leitura.
+ */
+void captura_registrar(const vl53l0x_medicao_t *medicao, uint32_t t_us, bool aceita);
+
+/**
+ * @brief Escreve na USB os quadros enfileirados. Chamar a cada amostra no laço principal.
+ */
+void captura_processar();
+
+/**
+ * @brief Escreve um quadro qualquer (sincronia, tipo, tamanho, payload, CRC) na USB, de uma vez.
+ *        Tipos: 1 = amostra da captura, 2 = mensagem do registro (registro.c).
+ */
+void captura_quadro(uint8_t tipo, const uint8_t *payload, uint8_t tamanho);
+
+#endif // CAPTURA_H
@@ -13,6 +13,41 @@
 
 // --- CONSTANTES DE CONFIGURAÇÃO ---
 #define DISTANCIA_LIMIAR_CM   15
+#define MONITOR_AMOSTRAS_JANELA 50     // Leituras somadas em cada média publicada
+#define MONITOR_PUBLICAR_MEDICOES 1    // 0 = publica só eventos e alertas; o histórico e a planilha do Node-RED usam estas médias
+
+// --- INTERTRAVAMENTO DO RELÉ (intertravamento.c): IRQ de timer, leitura a leitura ---
+#define INTERTRAVAMENTO_PERIODO_MS      5    // consulta ao sensor; a medição em si leva ~33 ms
+#define INTERTRAVAMENTO_LIGA_MM         (DISTANCIA_LIMIAR_CM * 10)       // abaixo disto conta para ligar
+#define INTERTRAVAMENTO_DESLIGA_MM      (DISTANCIA_LIMIAR_CM * 10 + 20)  // acima disto conta para desligar
+#define INTERTRAVAMENTO_CONFIRMACOES    3    // leituras seguidas além do limiar para trocar o relé
+#define INTERTRAVAMENTO_FILA_AMOSTRAS   64   // leituras à espera do laço principal (potência de 2)
+#define INTERTRAVAMENTO_FILA_REGISTROS  16   // acionamentos à espera de publicação (potência de 2)
+#define INTERTRAVAMENTO_ESPERA_MS       100  // espera máxima do laço por uma leitura
+#define INTERTRAVAMENTO_SEM_LEITURA_MS  500  // sem leitura aprovada por este tempo: estado seguro
+#define INTERTRAVAMENTO_ESTADO_SEGURO   true // relé no estado seguro (true = ligado, como no alerta)
+#define INTERTRAVAMENTO_FOLGA_FLASH_MM  100  // gravar a flash só com a leitura esta folga acima do desligamento
+
+// --- DETECÇÃO DE EVENTOS (deteccao.c), uma vez por janela (~3 s) ---
+#define DETECCAO_FILTRO_SHIFT        1    // nível filtrado: média móvel exponencial de 1/2 das médias
+#define DETECCAO_REFERENCIA_SHIFT    8    // nível normal: média móvel de 1/256 (~13 min)
+#define DETECCAO_CUSUM_K_MM          20   // folga: desvios menores que isto não acumulam
+#define DETECCAO_CUSUM_H_MM          100  // soma acumulada que caracteriza uma mudança
+#define DETECCAO_DEGRAU_MM           150  // variação entre duas janelas rápida demais para ser água
+#define DETECCAO_TRAVADO_JANELAS     20   // janelas seguidas com todas as leituras idênticas
+#define DETECCAO_SEM_RETORNO_JANELAS 10   // janelas seguidas sem nenhuma leitura válida
+#define DETECCAO_AQUECIMENTO_JANELAS 64   // janelas (~2 min) cuja média semeia a referência; sem CUSUM antes
+#define DETECCAO_HISTORICO           8    // médias anteriores enviadas junto com o evento
+
+// --- GRÁFICO DE NÍVEL NO OLED ---
+#define OLED_GRAFICO_MIN_MM      0     // Distância desenhada no topo do gráfico
+#define OLED_GRAFICO_MAX_MM      1000  // Distância desenhada na base do gráfico
+#define OLED_GRAFICO_SCROLL_HW   1     // 1 = rolagem de uma coluna pelo controlador; 0 = reenvia a área do gráfico
+#define OLED_GRAFICO_SCROLL_CMD  0x2D  // Rolagem de conteúdo de uma coluna (0x2D esquerda / 0x2C direita)
+
+// --- TAREFA DO DISPLAY (core 1) ---
+#define DISPLAY_FPS_MAX          4     // Quadros por segundo no máximo enviados ao OLED
+#define DISPLAY_FILA_AMOSTRAS    16    // Amostras do gráfico acumuladas entre dois quadros
 
 // --- CONFIGURAÇÕES ---
 #define RELER_PIN             8
@@ -28,12 +63,32 @@
 #define I2C1_PORT          i2c1
 #define I2C1_SDA_PIN       14
 #define I2C1_SCL_PIN       15
+#define I2C1_BAUDRATE      (400 * 1000)
 
 // Porta I2C 0 (Sensor de Distancia)
 #define I2C0_PORT             i2c0
 #define I2C0_SDA_PIN          0
 #define I2C0_SCL_PIN          1
 #define VL53L0X_ADDR          0x29
+#define I2C0_BAUDRATE         (100 * 1000)
+
+// Margem somada ao tempo de barramento de cada transação antes de desistir (timeout)
+#define I2C_TIMEOUT_MARGEM_US       2000
+// NACKs seguidos no mesmo dispositivo antes de recuperar o barramento (timeout recupera na hora)
+#define I2C_FALHAS_PARA_RECUPERAR   8
+// Espera máxima por uma medição do VL53L0X (orçamento padrão de 33 ms + folga)
+#define VL53L0X_TIMEOUT_MEDICAO_US  60000
+// Qualidade da leitura (vl53l0x_qualidade): status de medição diferente de "faixa válida", sem
+// alvo ou sinal abaixo do mínimo dão nota 0; as demais valem sinal / (sinal + ambiente), em %
+#define QUALIDADE_SINAL_MIN_MCPS    32   // 0,25 MCPS em ponto fixo 9.7, o limite padrão do próprio sensor
+#define QUALIDADE_MINIMA            30   // abaixo disto (ambiente acima de ~2x o retorno) a leitura é descartada
+
+// --- SENSORES EXTRAS EM BARRAMENTOS NO PIO (pio_i2c.c) ---
+// Cada VL53L0X extra tem o seu par de pinos (SCL = SDA + 1) e é lido ao mesmo tempo que o do
+// i2c0; a amostra passa a ser a média dos sensores com leitura válida. 0 = só o sensor do i2c0.
+#define SENSORES_PIO                0
+#define SENSORES_PIO_SDA_PINS       {2, 4, 6, 16}  // SCL em 3, 5, 7 e 17
+#define SENSORES_PIO_BAUDRATE       (400 * 1000)
 
 
 // --- CONFIGURAÇÃO DE REDE E MQTT 
@@ -41,12 +96,94 @@
 #define WIFI_PASSWORD         "SenhadoWiFi"
 #define MQTT_BROKER_IP        "123.123.###.###"
 #define MQTT_BROKER_PORT      1883
-#define MQTT_CLIENT_ID        "PicoWMonitorAlagamentos"
+#define MQTT_CLIENT_PREFIXO   "boia-" // client ID = prefixo + id único da placa (16 dígitos hex)
+#define MQTT_ID_FIXO          ""     // não vazio: usado no lugar do id da placa (ex.: "boia" = tópicos antigos)
+#define MQTT_KEEPALIVE_S      30     // o broker publica a última vontade após 1,5x isto sem notícias
+#define MQTT_RETENTATIVA_MS   5000   // intervalo mínimo entre tentativas de conexão ao broker
+
+// --- INICIALIZAÇÃO RÁPIDA (rede.c) ---
+#define REDE_CACHE_HABILITADA       1       // reaproveita BSSID, canal e concessão DHCP gravados em flash
+#define REDE_IP_ESTATICO            ""      // ex.: "192.168.0.50"; vazio = DHCP
+#define REDE_MASCARA_ESTATICA       "255.255.255.0"
+#define REDE_GATEWAY_ESTATICO       "192.168.0.1"
+#define REDE_TIMEOUT_VARREDURA_MS   8000
+#define REDE_TIMEOUT_ASSOCIACAO_MS  15000   // join + DHCP
+#define REDE_TIMEOUT_MQTT_MS        15000   // sem broker com a concessão da cache: volta ao DHCP
+#define REDE_ESPERA_RETENTATIVA_MS  2000
+
+// --- ECONOMIA DO RÁDIO (rede.c) ---
+// Desempenho com alerta, OTA ou MQTT conectando; fora disso, economia conforme o intervalo de publicação
+#define REDE_RADIO_MODO_FIXO        -1      // 0 desempenho, 1 economia, 2 economia máxima (bancada); -1 = política
+#define REDE_PM2_RETORNO_MS         200     // economia: rádio fica acordado até isto após o último pacote
+#define REDE_PM_DTIM_MAXIMA         3       // economia máxima: acorda a cada 3 DTIMs (~300 ms com DTIM 1 no AP)
+#define REDE_PM_ESCUTA_ASSOCIACAO   10      // intervalo de escuta anunciado ao AP, em beacons
+#define REDE_PM_LIMIAR_MAXIMA_MS    10000   // publicações mais espaçadas que isto usam economia máxima
+#define REDE_DESEMPENHO_SEM_MQTT_MS 30000   // sem broker, rádio sem economia só por este tempo
+#define FLASH_SEGURA_TIMEOUT_MS     100     // espera pelo core 1 antes de gravar a flash
 
 // --- TÓPICOS MQTT ---
-#define TOPICO_CONEXAO       "monitor/boia/conexao"
-#define TOPICO_MEDICOES       "monitor/boia/medicoes"
-#define TOPICO_ALERTA         "monitor/boia/alerta"
+// Cada nó publica e assina em TOPICO_RAIZ/<id>/<sufixo>; mqtt_config.c monta o tópico completo
+#define TOPICO_RAIZ           "monitor"
+#define TOPICO_MAX            64     // tópico completo, com o terminador
+#define TOPICO_STATUS         "status"   // nascimento e última vontade, retidos
+#define TOPICO_CONEXAO        "conexao"
+#define TOPICO_MEDICOES       "medicoes"
+#define TOPICO_ALERTA         "alerta"
+#define TOPICO_METRICAS       "metricas"
+#define TOPICO_EVENTOS        "eventos"
+#define TOPICO_RELE           "rele"
+#define TOPICO_ENERGIA        "energia"
+#define TOPICO_OTA_BLOCO      "ota/bloco"
+#define TOPICO_OTA_ESTADO     "ota/estado"
+
+// --- MÉTRICAS ---
+#define METRICAS_PERIODO_MS   60000  // publicação periódica em TOPICO_METRICAS
+#define METRICAS_JSON_MAX     1280   // cabe em MQTT_OUTPUT_RINGBUF_SIZE (lwipopts.h) com o tópico
+#define METRICAS_COMANDO_USB  'm'    // tecla no terminal USB que imprime as métricas
+
+// --- REGISTRO ADIADO (registro.c, mensagens em registro.def) ---
+#define REGISTRO_NIVEL_MINIMO   REGISTRO_INFO // abaixo disto a mensagem não é compilada
+#define REGISTRO_SAIDA_BINARIA  0      // 1: quadros com id e argumentos, formatados por tools/registro_decodificar.py
+#define REGISTRO_FILA_PALAVRAS  256    // por core; uma mensagem ocupa 2 + argumentos palavras
+#define REGISTRO_MAX_ARGS       6
+
+// --- CAPTURA BRUTA PELA USB (captura.c) ---
+#define CAPTURA_COMANDO_USB   'c'    // tecla que liga/desliga os quadros binários (tools/captura_receber.py)
+#define CAPTURA_FILA          256    // medições enfileiradas pela IRQ (~8 s a 30 Hz) até o laço escrever
+
+// --- PERFIL DE ENERGIA (energia.c) ---
+// Correntes no trilho de 3,3 V (µA) por estado de cada componente; são estimativas de datasheet
+// para começar e devem ser calibradas com medição na placa (ver README). O relatório sai junto
+// com as métricas, a cada METRICAS_PERIODO_MS.
+#define ENERGIA_CPU_ATIVA_UA              24000   // RP2040 a 125 MHz executando
+#define ENERGIA_CPU_DORMINDO_UA           12000   // sleep_ms(): WFE com clocks e PLLs ligados
+#define ENERGIA_RADIO_DESEMPENHO_UA       45000   // CYW43439 recebendo sem economia (varredura, join)
+#define ENERGIA_RADIO_ECONOMIA_UA         9000    // PM2, média entre acordado e dormindo
+#define ENERGIA_RADIO_ECONOMIA_MAXIMA_UA  2500    // PM1 acordando a cada 3 DTIMs
+#define ENERGIA_RADIO_TX_UA               250000  // transmitindo, somado ao modo do rádio
+#define ENERGIA_TX_US_POR_MSG             1500    // rádio transmitindo por publicação MQTT (dados + ACK TCP)
+#define ENERGIA_SENSOR_MEDINDO_UA         19000   // VL53L0X medindo
+#define ENERGIA_SENSOR_OCIOSO_UA          5       // VL53L0X em standby entre medições
+#define ENERGIA_DISPLAY_LIGADO_UA         8000    // SSD1306 com ~1/3 dos pixels acesos
+#define ENERGIA_DISPLAY_ATUALIZANDO_UA    9000    // + barramento I2C durante um quadro
+#define ENERGIA_EFICIENCIA_PCT            90      // regulador buck-boost VSYS → 3,3 V
+#define ENERGIA_VSYS_PADRAO_MV            5000    // usado se o ADC ler zero
+#define ENERGIA_JSON_MAX                  512
+
+// --- ATUALIZAÇÃO REMOTA (ota.c) ---
+// Mapa da flash (estágio de boot, slots de 960 KB, rascunho e progresso da troca, diário) em
+// ota_troca.h, que o estágio de boot (boot/) também usa; o último setor é a cache de boot.
+#define OTA_MAX_TENTATIVAS         3       // boots sem confirmação antes de voltar à imagem anterior
+#define OTA_WATCHDOG_MS            8000    // watchdog da imagem em teste (máx. do RP2040: ~8,3 s)
+#define OTA_PRAZO_CONFIRMACAO_MS   300000  // a imagem em teste precisa ficar saudável dentro deste prazo
+#define OTA_ESPERA_PUBLICACAO_MS   2000    // espera máxima pelo PUBACK do estado "aplicando" antes da troca
+
+// --- SERVIDOR HTTP LOCAL (servidor_http.c) ---
+#define HTTP_PORTA              80
+#define HTTP_CONEXOES           3      // simultâneas; o lwIP tem 5 PCBs TCP e o MQTT usa um
+#define HTTP_HISTORICO          48     // médias de janela guardadas para /historico (~2,5 min)
+#define HTTP_TIMEOUT_S          5      // fecha a conexão que não mandou a linha da requisição
+#define HTTP_RECARGA_PAGINA_S   10     // a página de estado se recarrega sozinha
 
 
 
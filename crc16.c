@@ -0,0 +1,12 @@
+// crc16.c - CRC-16 bit a bit, para quadros curtos (captura pela USB)
+
+#include "crc16.h"
+
+uint16_t crc16_atualizar(uint16_t crc, const void *dados, size_t tamanho) {
+    const uint8_t *p = dados;
+    while (tamanho--) {
+        crc ^= (uint16_t)(*p++ << 8);
+        for (int i = 0; i < 8; i++) crc = (uint16_t)((crc << 1) ^ (0x1021 & -(crc >> 15)));
+    }
+    return crc;
+}
@@ -0,0 +1,18 @@
+// crc16.h - CRC-16/CCITT-FALSE (polinômio 0x1021, início 0xFFFF), o binascii.crc_hqx do Python
+
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Continua um CRC-16 com mais dados. Comece com crc = 0xFFFF.
+ */
+uint16_t crc16_atualizar(uint16_t crc, const void *dados, size_t tamanho);
+
+static inline uint16_t crc16_calcular(const void *dados, size_t tamanho) {
+    return crc16_atualizar(0xFFFF, dados, tamanho);
+}
+
+#endif // CRC16_H
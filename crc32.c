@@ -0,0 +1,13 @@
+// crc32.c - CRC-32 bit a bit: sem tabela de 1 KB na RAM, rápido o bastante para setores de flash
+
+#include "crc32.h"
+
+uint32_t crc32_atualizar(uint32_t crc, const void *dados, size_t tamanho) {
+    const uint8_t *p = dados;
+    crc = ~crc;
+    while (tamanho--) {
+        crc ^= *p++;
+        for (int i = 0; i < 8; i++) crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
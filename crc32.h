@@ -0,0 +1,18 @@
+// crc32.h - CRC-32 (IEEE 802.3, o mesmo do zlib)
+
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Continua um CRC-32 com mais dados. Comece com crc = 0.
+ */
+uint32_t crc32_atualizar(uint32_t crc, const void *dados, size_t tamanho);
+
+static inline uint32_t crc32_calcular(const void *dados, size_t tamanho) {
+    return crc32_atualizar(0, dados, tamanho);
+}
+
+#endif // CRC32_H
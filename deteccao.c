@@ -0,0 +1,197 @@
+// deteccao.c - CUSUM sobre o nível filtrado, em ponto fixo Q8 (mm * 256), uma vez por janela
+//
+// A referência é uma média móvel lenta do nível; o desvio do nível filtrado em relação a ela
+// alimenta duas somas acumuladas (subida e descida da distância). Quando a soma da subida da
+// água passa de DETECCAO_CUSUM_H_MM, o maior degrau entre janelas desde que ela começou a
+// crescer separa água (gradual) de obstrução (degrau). Durante um evento a referência fica
+// congelada e o evento termina quando o nível volta para perto dela. A referência começa como a
+// média das primeiras DETECCAO_AQUECIMENTO_JANELAS janelas: semeada por uma janela só, ela
+// herdaria a crista ou o vale de uma onda e levaria minutos para sair de lá.
+
+#include "deteccao.h"
+#include "metricas.h"
+#include "registro.h"
+#include "texto.h"
+#include "mqtt_config.h"
+
+#define Q8(mm) ((int32_t)(mm) << 8)
+#define MM(q8) ((q8) >> 8)
+
+static const char *const nomes[] = {"subida", "obstrucao", "travado", "sem_retorno", "fim"};
+
+static struct {
+    bool iniciado;
+    int32_t nivel;        // nível filtrado (Q8)
+    int32_t referencia;   // nível normal (Q8)
+    uint16_t aquecidas;   // janelas já somadas na semente da referência
+    uint32_t soma_aquecimento;
+    int32_t soma_subida;  // CUSUM da água subindo (distância caindo)
+    int32_t maior_degrau; // maior queda entre duas janelas desde que soma_subida saiu do zero
+    uint32_t t_anterior_ms;
+    int32_t taxa_mm_min;
+
+    bool em_evento;
+    deteccao_tipo_t tipo;
+    uint32_t inicio_ms;
+    uint16_t extremo_mm;
+
+    uint16_t janelas_iguais;
+    uint16_t janelas_vazias;
+
+    uint16_t historico[DETECCAO_HISTORICO];
+    uint8_t num_historico;
+} d;
+
+void deteccao_iniciar() {
+    memset(&d, 0, sizeof(d));
+}
+
+static void historico_adicionar(uint16_t mm) {
+    if (d.num_historico == DETECCAO_HISTORICO) {
+        memmove(d.historico, d.historico + 1, sizeof(d.historico) - sizeof(d.historico[0]));
+        d.num_historico--;
+    }
+    d.historico[d.num_historico++] = mm;
+}
+
+static void preencher(deteccao_evento_t *e, deteccao_tipo_t tipo, uint32_t t_ms, uint16_t faixa_mm) {
+    e->tipo = tipo;
+    e->encerrado = d.tipo;
+    e->t_ms = t_ms;
+    e->duracao_ms = t_ms - d.inicio_ms;
+    e->nivel_mm = (uint16_t)MM(d.nivel);
+    e->referencia_mm = (uint16_t)MM(d.referencia);
+    e->extremo_mm = d.extremo_mm;
+    e->taxa_mm_min = d.taxa_mm_min;
+    e->faixa_mm = faixa_mm;
+    e->num_historico = d.num_historico;
+    memcpy(e->historico_mm, d.historico, sizeof(d.historico));
+}
+
+static bool comecar(deteccao_evento_t *e, deteccao_tipo_t tipo, uint32_t t_ms, uint16_t faixa_mm) {
+    d.em_evento = true;
+    d.tipo = tipo;
+    d.inicio_ms = t_ms;
+    d.extremo_mm = (uint16_t)MM(d.nivel);
+    metricas_incrementar(METRICA_EVENTOS);
+    preencher(e, tipo, t_ms, faixa_mm);
+    return true;
+}
+
+static bool terminar(deteccao_evento_t *e, uint32_t t_ms, uint16_t faixa_mm) {
+    d.em_evento = false;
+    d.soma_subida = 0;
+    d.maior_degrau = 0;
+    preencher(e, DETECCAO_FIM, t_ms, faixa_mm);
+    return true;
+}
+
+bool deteccao_processar(const monitor_janela_t *janela, uint32_t t_ms, deteccao_evento_t *evento) {
+    // Sensor sem retorno: não há nível para filtrar. Um evento em curso não tem mais como
+    // terminar pelo nível, então é encerrado aqui e o sem_retorno sai na janela seguinte.
+    if (janela->leituras_validas == 0) {
+        d.janelas_iguais = 0;
+        if (d.janelas_vazias < UINT16_MAX) d.janelas_vazias++;
+        if (d.janelas_vazias < DETECCAO_SEM_RETORNO_JANELAS) return false;
+        if (!d.em_evento) return comecar(evento, DETECCAO_SEM_RETORNO, t_ms, 0);
+        return d.tipo != DETECCAO_SEM_RETORNO ? terminar(evento, t_ms, 0) : false;
+    }
+    d.janelas_vazias = 0;
+
+    uint16_t media = (uint16_t)(janela->soma / janela->leituras_validas);
+    uint16_t faixa = janela->max_mm - janela->min_mm;
+    uint32_t dt_ms = t_ms - d.t_anterior_ms;
+    d.t_anterior_ms = t_ms;
+
+    if (!d.iniciado) {
+        d.iniciado = true;
+        d.nivel = d.referencia = Q8(media);
+        d.aquecidas = 1;
+        d.soma_aquecimento = media;
+        historico_adicionar(media);
+        return false;
+    }
+
+    int32_t anterior = d.nivel;
+    d.nivel += (Q8(media) - d.nivel) >> DETECCAO_FILTRO_SHIFT;
+    int32_t queda = anterior - d.nivel;
+    d.taxa_mm_min = dt_ms ? (int32_t)(-(int64_t)queda * 60000 / ((int64_t)dt_ms << 8)) : 0;
+    historico_adicionar(media);
+
+    // O VL53L0X sempre varia alguns milímetros entre leituras; 50 iguais é um valor congelado
+    d.janelas_iguais = faixa == 0 && janela->leituras_validas > 1 ? d.janelas_iguais + 1 : 0;
+
+    if (d.em_evento) {
+        uint16_t nivel_mm = (uint16_t)MM(d.nivel);
+        if (nivel_mm < d.extremo_mm) d.extremo_mm = nivel_mm;
+
+        bool fim;
+        switch (d.tipo) {
+        case DETECCAO_TRAVADO:
+            fim = d.janelas_iguais == 0;
+            break;
+        case DETECCAO_SEM_RETORNO:
+            fim = true; // voltou a haver leituras
+            break;
+        default:
+            fim = d.nivel >= d.referencia - Q8(DETECCAO_CUSUM_K_MM);
+            break;
+        }
+        return fim ? terminar(evento, t_ms, faixa) : false;
+    }
+
+    if (d.janelas_iguais == DETECCAO_TRAVADO_JANELAS) {
+        return comecar(evento, DETECCAO_TRAVADO, t_ms, faixa);
+    }
+
+    if (d.aquecidas < DETECCAO_AQUECIMENTO_JANELAS) {
+        d.soma_aquecimento += media;
+        d.aquecidas++;
+        d.referencia = (int32_t)(Q8(d.soma_aquecimento) / d.aquecidas);
+        return false;
+    }
+
+    // CUSUM unilateral: só desvios além da folga K acumulam
+    int32_t desvio = d.referencia - d.nivel;
+    d.soma_subida += desvio - Q8(DETECCAO_CUSUM_K_MM);
+    if (d.soma_subida <= 0) {
+        d.soma_subida = 0;
+        d.maior_degrau = 0;
+    } else if (queda > d.maior_degrau) {
+        d.maior_degrau = queda;
+    }
+
+    if (d.soma_subida > Q8(DETECCAO_CUSUM_H_MM)) {
+        // O filtro atenua o degrau: compara com o limiar atenuado na mesma proporção
+        int32_t limiar = Q8(DETECCAO_DEGRAU_MM) >> DETECCAO_FILTRO_SHIFT;
+        return comecar(evento, d.maior_degrau >= limiar ? DETECCAO_OBSTRUCAO : DETECCAO_SUBIDA, t_ms, faixa);
+    }
+
+    // Sem evento, a referência acompanha devagar as variações normais (maré, evaporação)
+    d.referencia += (d.nivel - d.referencia) >> DETECCAO_REFERENCIA_SHIFT;
+    return false;
+}
+
+void deteccao_publicar(const deteccao_evento_t *e) {
+    char msg[320];
+    size_t pos = 0;
+    texto_anexar(msg, sizeof(msg), &pos,
+                 "{\"tipo\":\"%s\",\"t_ms\":%lu,\"nivel_mm\":%u,\"referencia_mm\":%u,\"extremo_mm\":%u,"
+                 "\"taxa_mm_min\":%ld,\"faixa_mm\":%u",
+                 nomes[e->tipo], (unsigned long)e->t_ms, e->nivel_mm, e->referencia_mm, e->extremo_mm,
+                 (long)e->taxa_mm_min, e->faixa_mm);
+    if (e->tipo == DETECCAO_FIM) {
+        texto_anexar(msg, sizeof(msg), &pos, ",\"encerrado\":\"%s\",\"duracao_s\":%lu", nomes[e->encerrado],
+                     (unsigned long)(e->duracao_ms / 1000));
+    }
+    texto_anexar(msg, sizeof(msg), &pos, ",\"historico_mm\":[");
+    for (int i = 0; i < e->num_historico; i++) {
+        texto_anexar(msg, sizeof(msg), &pos, i ? ",%u" : "%u", e->historico_mm[i]);
+    }
+    texto_anexar(msg, sizeof(msg), &pos, "]}");
+
+    // No laço de aquisição: o texto sai depois, pelo registro adiado
+    if (e->tipo == DETECCAO_FIM) REGISTRAR(EVENTO_FIM, e->encerrado, e->t_ms, e->duracao_ms / 1000);
+    else REGISTRAR(EVENTO, e->tipo, e->t_ms, e->nivel_mm, e->referencia_mm, e->extremo_mm);
+    if (pos < sizeof(msg)) mqtt_publicar(TOPICO_EVENTOS, msg);
+}
@@ -0,0 +1,52 @@
+// deteccao.h - Detecção de mudanças no nível (CUSUM em ponto fixo) e classificação dos eventos
+
+#ifndef DETECCAO_H
+#define DETECCAO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "monitor.h"
+
+typedef enum {
+    DETECCAO_SUBIDA,      // o nível sobe (distância cai) de forma sustentada
+    DETECCAO_OBSTRUCAO,   // degrau rápido demais para ser água: objeto na frente do sensor
+    DETECCAO_TRAVADO,     // leituras idênticas por muito tempo: o sensor parou de medir de verdade
+    DETECCAO_SEM_RETORNO, // janelas sem nenhuma leitura válida
+    DETECCAO_FIM,         // o evento em curso terminou
+} deteccao_tipo_t;
+
+typedef struct {
+    deteccao_tipo_t tipo;
+    deteccao_tipo_t encerrado;  // em DETECCAO_FIM: qual evento terminou
+    uint32_t t_ms;
+    uint32_t duracao_ms;        // em DETECCAO_FIM
+    uint16_t nivel_mm;          // nível filtrado no momento
+    uint16_t referencia_mm;     // nível normal antes do evento
+    uint16_t extremo_mm;        // menor distância durante o evento
+    int32_t taxa_mm_min;        // derivada do nível filtrado (negativa = água subindo)
+    uint16_t faixa_mm;          // máx - mín da última janela
+    uint8_t num_historico;
+    uint16_t historico_mm[DETECCAO_HISTORICO]; // médias das janelas anteriores, da mais antiga
+} deteccao_evento_t;
+
+/**
+ * @brief Zera o detector (a referência é aprendida nas primeiras janelas).
+ */
+void deteccao_iniciar();
+
+/**
+ * @brief Processa uma janela fechada de leituras.
+ *
+ * @param t_ms   Instante do fechamento da janela.
+ * @param evento Recebe o evento, se houve um.
+ * @return true se um evento começou ou terminou nesta janela.
+ */
+bool deteccao_processar(const monitor_janela_t *janela, uint32_t t_ms, deteccao_evento_t *evento);
+
+/**
+ * @brief Publica o evento com seu contexto (JSON) em TOPICO_EVENTOS.
+ */
+void deteccao_publicar(const deteccao_evento_t *evento);
+
+#endif // DETECCAO_H
@@ -0,0 +1,133 @@
+// display.c - Tela desejada + tarefa de envio com taxa de quadros limitada (core 1)
+
+#include "config.h"
+#include "display.h"
+#include "energia.h"
+#include "metricas.h"
+#include "pico/multicore.h"
+#include "pico/sync.h"
+
+#define DISPLAY_LINHA_MAX 16  // 128 px / 8 px por caractere
+
+typedef enum {
+    TELA_TEXTO,
+    TELA_GRAFICO
+} display_tela_t;
+
+// Tela desejada, escrita pelo core 0 e consumida pela tarefa do display
+typedef struct {
+    display_tela_t tela;
+    char linha1[DISPLAY_LINHA_MAX + 1];
+    char linha2[DISPLAY_LINHA_MAX + 1];
+    bool tela_alterada;
+
+    oled_icone_t icone;
+    bool icone_alterado;
+
+    uint16_t amostras[DISPLAY_FILA_AMOSTRAS];
+    uint8_t amostra_ini;
+    uint8_t amostras_pendentes;
+} display_modelo_t;
+
+static display_modelo_t modelo;
+static critical_section_t modelo_lock;
+
+static void copiar_linha(char *destino, const char *origem) {
+    strncpy(destino, origem ? origem : "", DISPLAY_LINHA_MAX);
+    destino[DISPLAY_LINHA_MAX] = '\0';
+}
+
+void display_texto(const char* linha1, const char* linha2) {
+    critical_section_enter_blocking(&modelo_lock);
+    modelo.tela = TELA_TEXTO;
+    copiar_linha(modelo.linha1, linha1);
+    copiar_linha(modelo.linha2, linha2);
+    modelo.tela_alterada = true;
+    modelo.amostras_pendentes = 0;
+    critical_section_exit(&modelo_lock);
+}
+
+void display_grafico(const char* titulo) {
+    critical_section_enter_blocking(&modelo_lock);
+    modelo.tela = TELA_GRAFICO;
+    copiar_linha(modelo.linha1, titulo);
+    modelo.linha2[0] = '\0';
+    modelo.tela_alterada = true;
+    modelo.icone_alterado = true; // a tela nova apaga o ícone, redesenha depois
+    modelo.amostras_pendentes = 0;
+    critical_section_exit(&modelo_lock);
+}
+
+void display_grafico_amostra(uint16_t distancia_mm) {
+    critical_section_enter_blocking(&modelo_lock);
+    if (modelo.tela == TELA_GRAFICO) {
+        if (modelo.amostras_pendentes == DISPLAY_FILA_AMOSTRAS) {
+            modelo.amostra_ini = (modelo.amostra_ini + 1) % DISPLAY_FILA_AMOSTRAS;
+            modelo.amostras_pendentes--;
+        }
+        uint8_t fim = (modelo.amostra_ini + modelo.amostras_pendentes) % DISPLAY_FILA_AMOSTRAS;
+        modelo.amostras[fim] = distancia_mm;
+        modelo.amostras_pendentes++;
+    }
+    critical_section_exit(&modelo_lock);
+}
+
+void display_icone(oled_icone_t icone) {
+    critical_section_enter_blocking(&modelo_lock);
+    if (modelo.icone != icone) {
+        modelo.icone = icone;
+        modelo.icone_alterado = true;
+    }
+    critical_section_exit(&modelo_lock);
+}
+
+// Envia ao OLED tudo o que mudou desde o último quadro.
+// O modelo é copiado sob a trava e o I2C (lento) acontece fora dela.
+static void display_quadro() {
+    display_modelo_t copia;
+
+    critical_section_enter_blocking(&modelo_lock);
+    copia = modelo;
+    modelo.tela_alterada = false;
+    modelo.icone_alterado = false;
+    modelo.amostras_pendentes = 0;
+    critical_section_exit(&modelo_lock);
+
+    if (!copia.tela_alterada && !copia.icone_alterado && copia.amostras_pendentes == 0) return;
+    uint32_t inicio_us = time_us_32();
+    energia_entrar(ENERGIA_DISPLAY_ATUALIZANDO);
+
+    if (copia.tela_alterada) {
+        if (copia.tela == TELA_GRAFICO) {
+            hardware_oled_grafico_iniciar(copia.linha1);
+        } else {
+            hardware_oled_exibir(copia.linha1, copia.linha2);
+        }
+    }
+    for (uint8_t i = 0; i < copia.amostras_pendentes; i++) {
+        hardware_oled_grafico_adicionar(copia.amostras[(copia.amostra_ini + i) % DISPLAY_FILA_AMOSTRAS]);
+    }
+    if (copia.icone_alterado && copia.tela == TELA_GRAFICO) {
+        hardware_oled_icone(copia.icone);
+    }
+
+    energia_entrar(ENERGIA_DISPLAY_LIGADO);
+    metricas_registrar_us(METRICA_OLED_QUADRO_US, time_us_32() - inicio_us);
+    metricas_incrementar(METRICA_OLED_QUADROS);
+}
+
+static void display_tarefa() {
+    multicore_lockout_victim_init(); // o core 0 pode pausar este core para gravar a flash
+    absolute_time_t proximo = get_absolute_time();
+    while (true) {
+        proximo = delayed_by_ms(proximo, 1000 / DISPLAY_FPS_MAX);
+        sleep_until(proximo);
+        display_quadro();
+    }
+}
+
+void display_iniciar() {
+    critical_section_init(&modelo_lock);
+    modelo.icone = OLED_ICONE_NENHUM;
+    multicore_launch_core1(display_tarefa);
+}
@@ -0,0 +1,42 @@
+// display.h
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <stdint.h>
+#include "hardware_oled.h"
+
+/**
+ * @brief Inicia a tarefa do display no core 1.
+ *
+ * A partir daqui o OLED pertence à tarefa: as funções abaixo apenas atualizam a
+ * "tela desejada" em RAM e retornam imediatamente. A tarefa compara o modelo com o
+ * que já foi desenhado e envia ao display no máximo DISPLAY_FPS_MAX quadros por
+ * segundo; várias atualizações dentro do mesmo período viram um único envio.
+ * Deve ser chamada depois de hardware_init().
+ */
+void display_iniciar();
+
+/**
+ * @brief Solicita uma tela com duas linhas de texto (equivalente a hardware_oled_exibir()).
+ */
+void display_texto(const char* linha1, const char* linha2);
+
+/**
+ * @brief Solicita a tela do gráfico de nível com o título informado.
+ */
+void display_grafico(const char* titulo);
+
+/**
+ * @brief Enfileira uma amostra para o gráfico de nível.
+ *
+ * Se a fila encher antes do próximo quadro as amostras mais antigas são descartadas.
+ */
+void display_grafico_amostra(uint16_t distancia_mm);
+
+/**
+ * @brief Solicita o ícone de estado do canto superior direito.
+ */
+void display_icone(oled_icone_t icone);
+
+#endif // DISPLAY_H
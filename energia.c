@@ -0,0 +1,193 @@
+// energia.c - Tempo de cada componente em cada estado, convertido em carga na entrada VSYS
+
+#include "config.h"
+#include "energia.h"
+#include "mqtt_config.h"
+#include "texto.h"
+#include "pico/stdlib.h"
+#include "pico/sync.h"
+#include "pico/cyw43_arch.h"
+#include "hardware/adc.h"
+#include <stdio.h>
+
+#ifndef PICO_VSYS_PIN
+#define PICO_VSYS_PIN 29
+#endif
+#define VSYS_ENTRADA_ADC (PICO_VSYS_PIN - 26)
+#define VSYS_AMOSTRAS    8
+#ifndef CYW43_USES_VSYS_PIN
+#define CYW43_USES_VSYS_PIN 0
+#endif
+
+#define ENERGIA_COMPONENTE(comp, estado, nome, ua) ENERGIA_##comp,
+static const uint8_t componente_de[] = {ENERGIA_ESTADOS(ENERGIA_COMPONENTE)};
+#undef ENERGIA_COMPONENTE
+#define ENERGIA_NOME(comp, estado, nome, ua) nome,
+static const char *const nomes_estados[] = {ENERGIA_ESTADOS(ENERGIA_NOME)};
+#undef ENERGIA_NOME
+#define ENERGIA_CORRENTE(comp, estado, nome, ua) ua,
+static const uint32_t corrente_ua[] = {ENERGIA_ESTADOS(ENERGIA_CORRENTE)};
+#undef ENERGIA_CORRENTE
+static const char *const nomes_componentes[ENERGIA_NUM_COMPONENTES] = {"cpu", "radio", "sensor", "display"};
+
+typedef struct {
+    uint64_t t_us;
+    uint64_t tempo_us[ENERGIA_NUM_ESTADOS];
+    uint32_t entradas[ENERGIA_NUM_ESTADOS];
+    uint32_t transmissoes;
+} energia_totais_t;
+
+static critical_section_t trava; // o display troca de estado no core 1, o sensor numa IRQ do core 0
+static energia_totais_t totais;
+static energia_totais_t anterior; // totais no fim do período anterior
+static uint8_t atual[ENERGIA_NUM_COMPONENTES];
+static uint64_t desde_us[ENERGIA_NUM_COMPONENTES];
+static uint32_t vsys_mv = ENERGIA_VSYS_PADRAO_MV;
+
+// Resumo do último período, para a linha impressa
+static struct {
+    uint32_t periodo_s;
+    uint32_t media_ua;     // = µAh por hora
+    uint32_t leituras;
+    uint32_t nah_leitura;
+} resumo;
+
+void energia_iniciar() {
+    critical_section_init(&trava);
+    uint64_t agora = time_us_64();
+    for (int c = ENERGIA_NUM_COMPONENTES - 1; c >= 0; c--) desde_us[c] = agora;
+    // O primeiro estado de cada componente na tabela é o inicial
+    for (int s = ENERGIA_NUM_ESTADOS - 1; s >= 0; s--) atual[componente_de[s]] = (uint8_t)s;
+    totais.t_us = agora;
+    anterior = totais;
+
+    adc_init();
+}
+
+void energia_entrar(energia_estado_t estado) {
+    uint c = componente_de[estado];
+    critical_section_enter_blocking(&trava);
+    if (atual[c] != estado) {
+        uint64_t agora = time_us_64();
+        totais.tempo_us[atual[c]] += agora - desde_us[c];
+        desde_us[c] = agora;
+        atual[c] = (uint8_t)estado;
+        totais.entradas[estado]++;
+    }
+    critical_section_exit(&trava);
+}
+
+void energia_dormir_ms(uint32_t ms) {
+    energia_entrar(ENERGIA_CPU_DORMINDO);
+    sleep_ms(ms);
+    energia_entrar(ENERGIA_CPU_ATIVA);
+}
+
+void energia_transmitiu() {
+    critical_section_enter_blocking(&trava);
+    totais.transmissoes++;
+    critical_section_exit(&trava);
+}
+
+// Totais até agora, com o tempo do estado em curso de cada componente
+static energia_totais_t ler_totais() {
+    critical_section_enter_blocking(&trava);
+    energia_totais_t t = totais;
+    t.t_us = time_us_64();
+    for (uint c = 0; c < ENERGIA_NUM_COMPONENTES; c++) t.tempo_us[atual[c]] += t.t_us - desde_us[c];
+    critical_section_exit(&trava);
+    return t;
+}
+
+uint32_t energia_ler_vsys_mv() {
+    // No Pico W o GPIO29 também é o clock do SPI do CYW43: segura o driver enquanto o ADC usa
+    // o pino; a próxima transação do driver devolve o pino ao PIO. Com o rádio desligado não
+    // há driver para segurar.
+    bool radio = atual[ENERGIA_RADIO] != ENERGIA_RADIO_DESLIGADO;
+#if CYW43_USES_VSYS_PIN
+    if (radio) cyw43_thread_enter();
+#else
+    (void)radio;
+#endif
+    adc_gpio_init(PICO_VSYS_PIN);
+    adc_select_input(VSYS_ENTRADA_ADC);
+    adc_read(); // a primeira conversão após trocar de entrada sai baixa
+    uint32_t soma = 0;
+    for (int i = 0; i < VSYS_AMOSTRAS; i++) soma += adc_read();
+#if CYW43_USES_VSYS_PIN
+    if (radio) cyw43_thread_exit();
+#endif
+    // Divisor de 3 antes do ADC de 12 bits com referência de 3,3 V
+    return soma * 3 * 3300 / (VSYS_AMOSTRAS * 4096);
+}
+
+// Carga em nAh no trilho de 3,3 V, levada à entrada VSYS pela eficiência do regulador
+static uint64_t nah_vsys(uint64_t ua_us) {
+    return ua_us / 3600000 * 3300 * 100 / ((uint64_t)vsys_mv * ENERGIA_EFICIENCIA_PCT);
+}
+
+// "123.456" a partir de um inteiro em milésimos
+static const char *milesimos(char *buf, uint64_t valor) {
+    snprintf(buf, 24, "%llu.%03u", (unsigned long long)(valor / 1000), (unsigned)(valor % 1000));
+    return buf;
+}
+
+// {"t":ms,"periodo_s":..,"vsys_mv":..,"mah_por_hora":..,"mwh_por_hora":..,"leituras":..,
+//  "uah_por_leitura":..,"ma":{"cpu":..,"radio":..,"radio_tx":..,"sensor":..,"display":..},
+//  "tempo_pct":{"cpu_ativa":..,...}}
+size_t energia_json(char *buf, size_t tamanho) {
+    energia_totais_t agora = ler_totais();
+    uint64_t periodo_us = agora.t_us - anterior.t_us;
+    if (periodo_us == 0) periodo_us = 1;
+    vsys_mv = energia_ler_vsys_mv();
+    if (vsys_mv == 0) vsys_mv = ENERGIA_VSYS_PADRAO_MV; // ADC não ligado ao VSYS
+
+    uint64_t nah[ENERGIA_NUM_COMPONENTES + 1] = {0}; // o último é a transmissão
+    for (uint s = 0; s < ENERGIA_NUM_ESTADOS; s++) {
+        nah[componente_de[s]] += nah_vsys((agora.tempo_us[s] - anterior.tempo_us[s]) * corrente_ua[s]);
+    }
+    uint32_t transmissoes = agora.transmissoes - anterior.transmissoes;
+    nah[ENERGIA_NUM_COMPONENTES] = nah_vsys((uint64_t)transmissoes * ENERGIA_TX_US_POR_MSG * ENERGIA_RADIO_TX_UA);
+    uint64_t total_nah = 0;
+    for (uint c = 0; c <= ENERGIA_NUM_COMPONENTES; c++) total_nah += nah[c];
+
+    // Uma leitura termina a cada volta do sensor ao ocioso
+    uint32_t leituras = agora.entradas[ENERGIA_SENSOR_OCIOSO] - anterior.entradas[ENERGIA_SENSOR_OCIOSO];
+    resumo.periodo_s = (uint32_t)(periodo_us / 1000000);
+    resumo.media_ua = (uint32_t)(total_nah * 3600000 / periodo_us);
+    resumo.leituras = leituras;
+    resumo.nah_leitura = leituras ? (uint32_t)(total_nah / leituras) : 0;
+
+    char v[24];
+    size_t pos = 0;
+    texto_anexar(buf, tamanho, &pos, "{\"t\":%lu,\"periodo_s\":%lu,\"vsys_mv\":%lu,\"mah_por_hora\":%s",
+           (unsigned long)(agora.t_us / 1000), (unsigned long)resumo.periodo_s, (unsigned long)vsys_mv,
+           milesimos(v, resumo.media_ua));
+    texto_anexar(buf, tamanho, &pos, ",\"mwh_por_hora\":%s", milesimos(v, (uint64_t)resumo.media_ua * vsys_mv / 1000));
+    texto_anexar(buf, tamanho, &pos, ",\"leituras\":%lu,\"uah_por_leitura\":%s,\"ma\":{", (unsigned long)leituras,
+           milesimos(v, resumo.nah_leitura));
+    for (uint c = 0; c <= ENERGIA_NUM_COMPONENTES; c++) {
+        texto_anexar(buf, tamanho, &pos, "%s\"%s\":%s", c ? "," : "",
+               c < ENERGIA_NUM_COMPONENTES ? nomes_componentes[c] : "radio_tx",
+               milesimos(v, nah[c] * 3600000 / periodo_us));
+    }
+    texto_anexar(buf, tamanho, &pos, "},\"tempo_pct\":{");
+    for (uint s = 0; s < ENERGIA_NUM_ESTADOS; s++) {
+        uint64_t pmil = (agora.tempo_us[s] - anterior.tempo_us[s]) * 1000 / periodo_us;
+        texto_anexar(buf, tamanho, &pos, "%s\"%s\":%llu.%u", s ? "," : "", nomes_estados[s],
+               (unsigned long long)(pmil / 10), (unsigned)(pmil % 10));
+    }
+    texto_anexar(buf, tamanho, &pos, "}}");
+    anterior = agora;
+    return pos < tamanho ? pos : 0;
+}
+
+void energia_publicar() {
+    static char msg[ENERGIA_JSON_MAX];
+    if (!energia_json(msg, sizeof(msg))) return;
+    char media[24], leitura[24];
+    printf("[energia] %s mAh/h em %lu s, %s µAh por leitura (%lu leituras), VSYS %lu mV\n",
+           milesimos(media, resumo.media_ua), (unsigned long)resumo.periodo_s,
+           milesimos(leitura, resumo.nah_leitura), (unsigned long)resumo.leituras, (unsigned long)vsys_mv);
+    mqtt_publicar(TOPICO_ENERGIA, msg);
+}
@@ -0,0 +1,72 @@
+// energia.h - Estimativa de consumo: tempo de cada componente em cada estado × corrente configurada
+
+#ifndef ENERGIA_H
+#define ENERGIA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// X(componente, estado, nome, corrente em µA no trilho de 3,3 V). O primeiro estado de cada
+// componente é o inicial; os estados de um componente ficam juntos.
+#define ENERGIA_ESTADOS(X) \
+    X(CPU,     ATIVA,           "cpu_ativa",              ENERGIA_CPU_ATIVA_UA) \
+    X(CPU,     DORMINDO,        "cpu_dormindo",           ENERGIA_CPU_DORMINDO_UA) \
+    X(RADIO,   DESLIGADO,       "radio_desligado",        0) \
+    X(RADIO,   DESEMPENHO,      "radio_desempenho",       ENERGIA_RADIO_DESEMPENHO_UA) \
+    X(RADIO,   ECONOMIA,        "radio_economia",         ENERGIA_RADIO_ECONOMIA_UA) \
+    X(RADIO,   ECONOMIA_MAXIMA, "radio_economia_maxima",  ENERGIA_RADIO_ECONOMIA_MAXIMA_UA) \
+    X(SENSOR,  OCIOSO,          "sensor_ocioso",          ENERGIA_SENSOR_OCIOSO_UA) \
+    X(SENSOR,  MEDINDO,         "sensor_medindo",         ENERGIA_SENSOR_MEDINDO_UA) \
+    X(DISPLAY, LIGADO,          "display_ligado",         ENERGIA_DISPLAY_LIGADO_UA) \
+    X(DISPLAY, ATUALIZANDO,     "display_atualizando",    ENERGIA_DISPLAY_ATUALIZANDO_UA)
+
+typedef enum { ENERGIA_CPU, ENERGIA_RADIO, ENERGIA_SENSOR, ENERGIA_DISPLAY, ENERGIA_NUM_COMPONENTES } energia_componente_t;
+
+#define ENERGIA_ENUM(comp, estado, nome, ua) ENERGIA_##comp##_##estado,
+typedef enum { ENERGIA_ESTADOS(ENERGIA_ENUM) ENERGIA_NUM_ESTADOS } energia_estado_t;
+#undef ENERGIA_ENUM
+
+/**
+ * @brief Zera os acumuladores e põe cada componente no seu estado inicial. Chamar antes de
+ *        ligar o core 1 e o timer do intertravamento.
+ */
+void energia_iniciar();
+
+/**
+ * @brief Troca o estado do componente a que o estado pertence.
+ *
+ * Cada componente deve ser trocado sempre do mesmo contexto (CPU e rádio pelo laço principal,
+ * sensor pela IRQ do intertravamento, display pelo core 1); contextos diferentes podem chamar
+ * ao mesmo tempo.
+ */
+void energia_entrar(energia_estado_t estado);
+
+/**
+ * @brief sleep_ms() contado como CPU dormindo.
+ */
+void energia_dormir_ms(uint32_t ms);
+
+/**
+ * @brief Conta uma publicação enviada: o pico de transmissão soma ENERGIA_TX_US_POR_MSG.
+ */
+void energia_transmitiu();
+
+/**
+ * @brief Lê VSYS pelo ADC (GPIO29 / ADC3, divisor por 3), em mV.
+ */
+uint32_t energia_ler_vsys_mv();
+
+/**
+ * @brief Monta o relatório do período desde a chamada anterior e começa um período novo.
+ *
+ * @return Tamanho do JSON, ou 0 se não coube no buffer.
+ */
+size_t energia_json(char *buf, size_t tamanho);
+
+/**
+ * @brief Monta o relatório, imprime o resumo e publica em TOPICO_ENERGIA.
+ */
+void energia_publicar();
+
+#endif // ENERGIA_H
@@ -0,0 +1,133 @@
+// hardware_oled.cpp - Display, LEDs e relé sobre o driver em template (lib/drivers/ssd1306.hpp)
+
+#include "config.h"
+#include "hardware_oled.h"
+#include "dispositivo_i2c.hpp"
+#include "ssd1306.hpp"
+#include "oled_icones.h"
+
+using botosmart::DispositivoI2C;
+using botosmart::Ssd1306;
+
+using OledI2c = DispositivoI2C<I2C1_PORT, 0x3C, I2C1_SDA_PIN, I2C1_SCL_PIN, I2C1_BAUDRATE>;
+using Oled = Ssd1306<OledI2c, 128, 64>;
+
+// Área do gráfico de nível: páginas 2..7 (48 px), abaixo da linha de título
+constexpr uint8_t GRAFICO_PAGINA_INI = 2;
+constexpr uint8_t GRAFICO_PAGINA_FIM = Oled::paginas - 1;
+constexpr int16_t GRAFICO_Y0 = GRAFICO_PAGINA_INI * 8;
+constexpr int16_t GRAFICO_ALTURA = (GRAFICO_PAGINA_FIM - GRAFICO_PAGINA_INI + 1) * 8;
+constexpr uint8_t GRAFICO_COLUNA_NOVA = Oled::largura - 1;
+
+// Estado do gráfico de nível (histórico rolando da direita para a esquerda)
+static struct {
+    bool ativo;
+    int16_t ultimo_y;
+} grafico;
+
+const i2c_bus_contadores_t *hardware_oled_contadores_i2c() {
+    return &OledI2c::contadores();
+}
+
+void hardware_init() {
+    gpio_init(LED_VERMELHO_PIN); gpio_set_dir(LED_VERMELHO_PIN, GPIO_OUT);
+    gpio_init(LED_VERDE_PIN); gpio_set_dir(LED_VERDE_PIN, GPIO_OUT);
+    gpio_init(RELER_PIN); gpio_set_dir(RELER_PIN, GPIO_OUT);
+
+    Oled::iniciar(); // I2C1 para Display; o I2C0 do sensor é iniciado em monitor_iniciar()
+    sleep_ms(20);
+    hardware_oled_logo();
+}
+
+void hardware_oled_exibir(const char* linha1, const char* linha2) {
+    grafico.ativo = false;
+    Oled::limpar();
+    Oled::texto(0, 8, linha1);
+    Oled::texto(0, 24, linha2);
+    Oled::enviar();
+}
+
+void hardware_oled_limpar() {
+    grafico.ativo = false;
+    Oled::limpar();
+    Oled::enviar();
+}
+
+void hardware_oled_logo() {
+    grafico.ativo = false;
+    Oled::limpar();
+    Oled::desenhar(&icone_boto, (Oled::largura - icone_boto.largura) / 2, 8);
+    Oled::texto((Oled::largura - 9 * 8) / 2, 40, "BotoSmart");
+    Oled::enviar();
+}
+
+void hardware_oled_icone(oled_icone_t icone) {
+    const int16_t x = Oled::largura - 16;
+
+    // O ícone ocupa o canto superior direito (páginas 0 e 1); só essa área vai ao display
+    if (icone == OLED_ICONE_NENHUM) {
+        for (uint8_t p = 0; p < 2; p++) memset(Oled::pagina(p) + x, 0, 16);
+        Oled::enviar_area(x, Oled::largura - 1, 0, 1);
+        return;
+    }
+    const ssd1306_sprite_t *sprite = icone == OLED_ICONE_ALERTA ? &icone_alerta : &icone_ok;
+    render_area sujo;
+    if (Oled::desenhar(sprite, x, 0, SSD1306_BLIT_COPIA, &sujo)) {
+        Oled::enviar_area(sujo.start_column, sujo.end_column, sujo.start_page, sujo.end_page);
+    }
+}
+
+// Converte distância em linha do gráfico: água mais perto do sensor = traço mais alto
+static int16_t grafico_y(uint16_t distancia_mm) {
+    // Em int32_t: com OLED_GRAFICO_MIN_MM = 0 a comparação em uint16_t seria sempre falsa
+    int32_t d = distancia_mm;
+    if (d < OLED_GRAFICO_MIN_MM) d = OLED_GRAFICO_MIN_MM;
+    if (d > OLED_GRAFICO_MAX_MM) d = OLED_GRAFICO_MAX_MM;
+    int32_t faixa = OLED_GRAFICO_MAX_MM - OLED_GRAFICO_MIN_MM;
+    return GRAFICO_Y0 + (d - OLED_GRAFICO_MIN_MM) * (GRAFICO_ALTURA - 1) / faixa;
+}
+
+void hardware_oled_grafico_iniciar(const char* titulo) {
+    Oled::comando(botosmart::ssd1306::CMD_SCROLL_DESLIGA);
+    Oled::limpar();
+    Oled::texto(0, 0, titulo);
+    Oled::enviar();
+    grafico.ativo = true;
+    grafico.ultimo_y = -1;
+}
+
+void hardware_oled_grafico_adicionar(uint16_t distancia_mm) {
+    if (!grafico.ativo) return;
+
+    // Desloca o histórico uma coluna para a esquerda no buffer local
+    for (uint8_t p = GRAFICO_PAGINA_INI; p <= GRAFICO_PAGINA_FIM; p++) {
+        uint8_t *linha = Oled::pagina(p);
+        memmove(linha, linha + 1, Oled::largura - 1);
+        linha[Oled::largura - 1] = 0;
+    }
+
+    // Desenha somente a coluna nova, ligando-a à amostra anterior
+    int16_t y = grafico_y(distancia_mm);
+    Oled::linha_vertical(GRAFICO_COLUNA_NOVA, grafico.ultimo_y < 0 ? y : grafico.ultimo_y, y);
+    grafico.ultimo_y = y;
+
+    // Linha pontilhada do limiar de alerta
+    static uint8_t pontilhado = 0;
+    if ((pontilhado++ & 0x03) == 0) {
+        Oled::pixel(GRAFICO_COLUNA_NOVA, grafico_y(DISTANCIA_LIMIAR_CM * 10), true);
+    }
+
+#if OLED_GRAFICO_SCROLL_HW
+    // O controlador desloca a própria GDDRAM em uma coluna; basta enviar a coluna nova
+    constexpr uint8_t scroll[] = {
+        OLED_GRAFICO_SCROLL_CMD, 0x00, GRAFICO_PAGINA_INI, 0x01,
+        GRAFICO_PAGINA_FIM, 0x00, Oled::largura - 1,
+    };
+    for (uint8_t c : scroll) Oled::comando(c);
+    Oled::enviar_area(GRAFICO_COLUNA_NOVA, GRAFICO_COLUNA_NOVA, GRAFICO_PAGINA_INI, GRAFICO_PAGINA_FIM);
+#else
+    Oled::enviar_area(0, Oled::largura - 1, GRAFICO_PAGINA_INI, GRAFICO_PAGINA_FIM);
+#endif
+}
+
+void hardware_led_set(bool on) { gpio_put(LED_VERMELHO_PIN, on); }
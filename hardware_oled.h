@@ -4,13 +4,31 @@
 #define HARDWARE_OLED_H
 
 #include <stdbool.h> // Necessário para usar os tipos 'true' e 'false'
+#include <stdint.h>
+#include "i2c_bus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Ícones de estado exibidos no canto superior direito
+typedef enum {
+    OLED_ICONE_NENHUM,
+    OLED_ICONE_OK,
+    OLED_ICONE_ALERTA
+} oled_icone_t;
 
 /**
- * @brief Inicializa todo o hardware necessário (as duas portas I2C, GPIOs, Sensores, Display).
+ * @brief Inicializa o hardware local: porta I2C do display, GPIOs e Display.
  * Deve ser chamada uma vez no início do programa.
  */
 void hardware_init();
 
+/**
+ * @brief Contadores de NACKs, timeouts e recuperações do barramento do display.
+ */
+const i2c_bus_contadores_t *hardware_oled_contadores_i2c();
+
 /**
  * @brief Exibe duas linhas de texto no display OLED na porta I2C1.
  *
@@ -24,4 +42,39 @@ void hardware_oled_exibir(const char* linha1, const char* linha2);
  */
 void hardware_oled_limpar();
 
+/**
+ * @brief Exibe o logotipo do BotoSmart em tela cheia (usado na inicialização).
+ */
+void hardware_oled_logo();
+
+/**
+ * @brief Desenha um ícone de estado no canto superior direito.
+ *
+ * Apenas a área de 16x16 do ícone é enviada ao display.
+ *
+ * @param icone Ícone a exibir (OLED_ICONE_NENHUM apaga o canto).
+ */
+void hardware_oled_icone(oled_icone_t icone);
+
+/**
+ * @brief Limpa a tela e prepara o gráfico de nível com um título na primeira linha.
+ *
+ * @param titulo Texto exibido acima do gráfico.
+ */
+void hardware_oled_grafico_iniciar(const char* titulo);
+
+/**
+ * @brief Acrescenta uma amostra ao gráfico de nível.
+ *
+ * O histórico é deslocado uma coluna para a esquerda pela rolagem do próprio SSD1306
+ * e só a coluna nova trafega no I2C (poucos bytes em vez do quadro inteiro).
+ *
+ * @param distancia_mm Distância medida pelo sensor, em milímetros.
+ */
+void hardware_oled_grafico_adicionar(uint16_t distancia_mm);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // HARDWARE_OLED_H
\ No newline at end of file
@@ -0,0 +1,21 @@
+// hardware/adc.h (host) - ADC simulado em host/sim_gpio.c; só a entrada do VSYS tem sinal
+
+#ifndef HOST_HARDWARE_ADC_H
+#define HOST_HARDWARE_ADC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void adc_init(void);
+void adc_gpio_init(unsigned int gpio);
+void adc_select_input(unsigned int input);
+uint16_t adc_read(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
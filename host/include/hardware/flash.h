@@ -0,0 +1,27 @@
+// hardware/flash.h (host) - Flash simulada em RAM, persistida em arquivo (host/sim_flash.c)
+
+#ifndef HOST_HARDWARE_FLASH_H
+#define HOST_HARDWARE_FLASH_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLASH_PAGE_SIZE       (1u << 8)
+#define FLASH_SECTOR_SIZE     (1u << 12)
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+
+// Na placa a flash é lida pelo XIP a partir de XIP_BASE; aqui, pelo vetor que a simula
+extern uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)sim_flash)
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,36 @@
+// hardware/gpio.h (host) - Os GPIOs são gravados pelo registrador de host/sim_gpio.c
+
+#ifndef HOST_HARDWARE_GPIO_H
+#define HOST_HARDWARE_GPIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GPIO_OUT 1
+#define GPIO_IN  0
+
+enum gpio_function {
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_I2C = 3,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_PIO1 = 7,
+    GPIO_FUNC_NULL = 0x1f,
+};
+
+void gpio_init(unsigned int gpio);
+void gpio_set_dir(unsigned int gpio, bool out);
+void gpio_set_function(unsigned int gpio, enum gpio_function fn);
+void gpio_pull_up(unsigned int gpio);
+void gpio_disable_pulls(unsigned int gpio);
+void gpio_put(unsigned int gpio, bool value);
+bool gpio_get(unsigned int gpio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,46 @@
+// hardware/i2c.h (host) - Barramentos I2C falsos (host/sim_i2c.c)
+
+#ifndef HOST_HARDWARE_I2C_H
+#define HOST_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct i2c_inst i2c_inst_t;
+
+// Como no SDK, endereços constantes (usáveis em inicializadores estáticos)
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+void i2c_deinit(i2c_inst_t *i2c);
+uint i2c_hw_index(i2c_inst_t *i2c);
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+int i2c_write_blocking_until(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                             absolute_time_t until);
+int i2c_read_blocking_until(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop,
+                            absolute_time_t until);
+
+// Como no SDK, as variantes com timeout são inline sobre as "_until"
+static inline int i2c_write_timeout_us(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                                       uint timeout_us) {
+    return i2c_write_blocking_until(i2c, addr, src, len, nostop, make_timeout_time_us(timeout_us));
+}
+
+static inline int i2c_read_timeout_us(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop,
+                                      uint timeout_us) {
+    return i2c_read_blocking_until(i2c, addr, dst, len, nostop, make_timeout_time_us(timeout_us));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
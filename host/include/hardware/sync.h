@@ -0,0 +1,19 @@
+// hardware/sync.h (host) - As "IRQs" da simulação só rodam quando o core 0 dorme: nada a desligar
+
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+// hardware/watchdog.h (host) - Watchdog sobre o relógio virtual (host/sim_watchdog.c)
+
+#ifndef HOST_HARDWARE_WATCHDOG_H
+#define HOST_HARDWARE_WATCHDOG_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug);
+void watchdog_disable(void);
+void watchdog_update(void);
+// Reinicia a "placa": a simulação termina com o código SIM_CODIGO_REINICIO
+void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
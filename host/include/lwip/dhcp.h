@@ -0,0 +1,19 @@
+// lwip/dhcp.h (host) - Cliente DHCP simulado (host/sim_rede.c)
+
+#ifndef HOST_LWIP_DHCP_H
+#define HOST_LWIP_DHCP_H
+
+#include "lwip/netif.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+err_t dhcp_start(struct netif *netif);
+void dhcp_stop(struct netif *netif);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
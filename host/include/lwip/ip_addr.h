@@ -0,0 +1,39 @@
+// lwip/ip_addr.h (host) - Tipos básicos e endereços IPv4 do lwIP (host/sim_rede.c)
+
+#ifndef HOST_LWIP_IP_ADDR_H
+#define HOST_LWIP_IP_ADDR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+typedef int8_t err_t;
+
+#define ERR_OK    0
+#define ERR_MEM  -1
+#define ERR_VAL  -6
+#define ERR_CONN -11
+#define ERR_ABRT -13
+#define ERR_RST  -14
+#define ERR_CLSD -15
+
+typedef struct { u32_t addr; } ip4_addr_t;
+typedef ip4_addr_t ip_addr_t;
+
+int ip4addr_aton(const char *cp, ip4_addr_t *addr);
+char *ip4addr_ntoa(const ip4_addr_t *addr);
+
+#define ip4_addr_get_u32(a) ((a)->addr)
+#define ip4_addr_set_u32(a, v) ((a)->addr = (v))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,28 @@
+// lwip/netif.h (host) - Só os endereços da interface, preenchidos pelo Wi-Fi simulado
+
+#ifndef HOST_LWIP_NETIF_H
+#define HOST_LWIP_NETIF_H
+
+#include "lwip/ip_addr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct netif {
+    ip4_addr_t ip_addr;
+    ip4_addr_t netmask;
+    ip4_addr_t gw;
+};
+
+void netif_set_addr(struct netif *netif, const ip4_addr_t *ipaddr, const ip4_addr_t *netmask, const ip4_addr_t *gw);
+
+#define netif_ip4_addr(n) ((const ip4_addr_t *)&(n)->ip_addr)
+#define netif_ip4_netmask(n) ((const ip4_addr_t *)&(n)->netmask)
+#define netif_ip4_gw(n) ((const ip4_addr_t *)&(n)->gw)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+// lwip/pbuf.h (host) - Buffer de pacote do lwIP, sempre em um só pedaço (host/sim_tcp.c)
+
+#ifndef HOST_LWIP_PBUF_H
+#define HOST_LWIP_PBUF_H
+
+#include "lwip/ip_addr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct pbuf {
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len;
+    u16_t len;
+};
+
+u8_t pbuf_free(struct pbuf *p);
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,65 @@
+// lwip/tcp.h (host) - API raw TCP do lwIP sobre sockets do host (host/sim_tcp.c)
+
+#ifndef HOST_LWIP_TCP_H
+#define HOST_LWIP_TCP_H
+
+#include "lwip/ip_addr.h"
+#include "lwip/pbuf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TCP_MSS     1460
+#define TCP_SND_BUF (8 * TCP_MSS)
+
+#define TCP_PRIO_MIN    1
+#define TCP_PRIO_NORMAL 64
+#define TCP_PRIO_MAX    127
+
+#define TCP_WRITE_FLAG_COPY 0x01
+#define TCP_WRITE_FLAG_MORE 0x02
+
+#define IPADDR_TYPE_V4  0U
+#define IPADDR_TYPE_ANY 46U
+
+extern const ip_addr_t ip_addr_any;
+#define IP_ANY_TYPE (&ip_addr_any)
+
+struct tcp_pcb;
+
+typedef err_t (*tcp_accept_fn)(void *arg, struct tcp_pcb *newpcb, err_t err);
+typedef err_t (*tcp_recv_fn)(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
+typedef err_t (*tcp_sent_fn)(void *arg, struct tcp_pcb *tpcb, u16_t len);
+typedef err_t (*tcp_poll_fn)(void *arg, struct tcp_pcb *tpcb);
+typedef void (*tcp_err_fn)(void *arg, err_t err);
+
+struct tcp_pcb *tcp_new(void);
+struct tcp_pcb *tcp_new_ip_type(u8_t type);
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port);
+struct tcp_pcb *tcp_listen_with_backlog(struct tcp_pcb *pcb, u8_t backlog);
+#define tcp_listen(pcb) tcp_listen_with_backlog(pcb, 0xff)
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg);
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept);
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv);
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent);
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err);
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval);
+void tcp_setprio(struct tcp_pcb *pcb, u8_t prio);
+#define tcp_nagle_disable(pcb) ((void)(pcb)) // a simulação não agrupa escritas
+
+void tcp_recved(struct tcp_pcb *pcb, u16_t len);
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags);
+err_t tcp_output(struct tcp_pcb *pcb);
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb);
+#define tcp_mss(pcb) ((void)(pcb), (u16_t)TCP_MSS)
+
+err_t tcp_close(struct tcp_pcb *pcb);
+void tcp_abort(struct tcp_pcb *pcb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
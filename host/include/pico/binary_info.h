@@ -0,0 +1,11 @@
+// pico/binary_info.h (host) - Sem picotool no host: as declarações de binary_info somem
+
+#ifndef HOST_PICO_BINARY_INFO_H
+#define HOST_PICO_BINARY_INFO_H
+
+#define bi_decl(_decl)
+#define bi_decl_if_func_used(_decl)
+#define bi_program_description(_desc)
+#define bi_2pins_with_func(_p0, _p1, _func)
+
+#endif
@@ -0,0 +1,87 @@
+// pico/cyw43_arch.h (host) - Wi-Fi simulado (host/sim_rede.c)
+
+#ifndef HOST_PICO_CYW43_ARCH_H
+#define HOST_PICO_CYW43_ARCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lwip/netif.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CYW43_AUTH_OPEN          0
+#define CYW43_AUTH_WPA2_AES_PSK  0x00400004
+
+#define CYW43_ITF_STA 0
+#define CYW43_ITF_AP  1
+
+#define CYW43_CHANNEL_NONE 0xffffffff
+
+#define CYW43_LINK_DOWN     0
+#define CYW43_LINK_JOIN     1
+#define CYW43_LINK_NOIP     2
+#define CYW43_LINK_UP       3
+#define CYW43_LINK_FAIL    -1
+#define CYW43_LINK_NONET   -2
+#define CYW43_LINK_BADAUTH -3
+
+#define CYW43_NO_POWERSAVE_MODE  0
+#define CYW43_PM1_POWERSAVE_MODE 1
+#define CYW43_PM2_POWERSAVE_MODE 2
+
+#define cyw43_pm_value(pm_mode, pm2_sleep_ret_ms, li_beacon_period, li_dtim_period, li_assoc) \
+    ((li_assoc) << 20 | (li_dtim_period) << 16 | (li_beacon_period) << 12 | ((pm2_sleep_ret_ms) / 10) << 4 | (pm_mode))
+
+typedef struct {
+    struct netif netif[2];
+} cyw43_t;
+
+extern cyw43_t cyw43_state;
+
+typedef struct {
+    uint32_t version;
+    uint16_t action;
+    uint16_t _;
+    uint32_t ssid_len;
+    uint8_t ssid[32];
+} cyw43_wifi_scan_options_t;
+
+typedef struct {
+    uint32_t _0[5];
+    uint8_t bssid[6];
+    uint16_t _1[2];
+    uint8_t ssid_len;
+    uint8_t ssid[32];
+    uint32_t _2[5];
+    uint16_t channel;
+    uint16_t _3;
+    uint8_t auth_mode;
+    int16_t rssi;
+} cyw43_ev_scan_result_t;
+
+int cyw43_arch_init(void);
+void cyw43_arch_deinit(void);
+void cyw43_arch_enable_sta_mode(void);
+int cyw43_arch_wifi_connect_timeout_ms(const char *ssid, const char *pw, uint32_t auth, uint32_t timeout);
+void cyw43_arch_poll(void);
+
+void cyw43_arch_lwip_begin(void);
+void cyw43_arch_lwip_end(void);
+
+int cyw43_wifi_scan(cyw43_t *self, cyw43_wifi_scan_options_t *opts, void *env,
+                    int (*result_cb)(void *, const cyw43_ev_scan_result_t *));
+bool cyw43_wifi_scan_active(cyw43_t *self);
+int cyw43_wifi_join(cyw43_t *self, size_t ssid_len, const uint8_t *ssid, size_t key_len, const uint8_t *key,
+                    uint32_t auth_type, const uint8_t *bssid, uint32_t channel);
+int cyw43_wifi_leave(cyw43_t *self, int itf);
+int cyw43_wifi_get_bssid(cyw43_t *self, uint8_t bssid[6]);
+int cyw43_tcpip_link_status(cyw43_t *self, int itf);
+int cyw43_wifi_pm(cyw43_t *self, uint32_t pm);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
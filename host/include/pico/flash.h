@@ -0,0 +1,22 @@
+// pico/flash.h (host) - Sem XIP para proteger: a função roda direto
+
+#ifndef HOST_PICO_FLASH_H
+#define HOST_PICO_FLASH_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,28 @@
+// pico/multicore.h (host) - O core 1 é uma thread sincronizada ao relógio virtual
+
+#ifndef HOST_PICO_MULTICORE_H
+#define HOST_PICO_MULTICORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void multicore_launch_core1(void (*entrada)(void));
+// Nada a travar: a flash simulada não depende do XIP
+static inline void multicore_lockout_victim_init(void) {}
+
+#ifdef __cplusplus
+extern thread_local uint sim_core_atual;
+#else
+extern _Thread_local uint sim_core_atual;
+#endif
+
+static inline uint get_core_num(void) {
+    return sim_core_atual;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,82 @@
+// pico/stdlib.h (host) - Subconjunto do Pico SDK usado pelo firmware, sobre o relógio virtual
+
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <assert.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PICO_ON_DEVICE 0
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define _u(x) x##u
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+// Na placa coloca a função na RAM; aqui não há XIP
+#define __not_in_flash_func(f) f
+#define __compiler_memory_barrier() __asm__ volatile("" ::: "memory")
+
+#define PICO_OK              0
+#define PICO_ERROR_GENERIC  -1
+#define PICO_ERROR_TIMEOUT  -2
+
+#include "hardware/gpio.h"
+
+void stdio_init_all(void);
+// Lê um caractere da entrada padrão sem bloquear o relógio virtual; PICO_ERROR_TIMEOUT se não há
+int getchar_timeout_us(uint32_t timeout_us);
+// Escreve len bytes como estão na saída padrão (a captura binária passa por aqui)
+int stdio_put_string(const char *s, int len, bool newline, bool cr_translation);
+
+// Tempo: tudo é derivado do relógio virtual da simulação (host/sim_relogio.c)
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void sleep_until(absolute_time_t t);
+// Na placa gira sem dormir (serve dentro de IRQ); aqui o efeito no relógio virtual é o mesmo
+static inline void busy_wait_us_32(uint32_t us) { sleep_us(us); }
+
+// Timer repetitivo: na simulação o callback roda como evento agendado no core 0, no lugar da
+// IRQ do alarm pool. delay_us < 0 conta o período do início de uma chamada à próxima.
+typedef struct repeating_timer repeating_timer_t;
+typedef bool (*repeating_timer_callback_t)(repeating_timer_t *rt);
+struct repeating_timer {
+    int64_t delay_us;
+    repeating_timer_callback_t callback;
+    void *user_data;
+    bool ativo;
+};
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data,
+                            repeating_timer_t *out);
+static inline bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data,
+                                          repeating_timer_t *out) {
+    return add_repeating_timer_us(delay_ms * 1000ll, callback, user_data, out);
+}
+bool cancel_repeating_timer(repeating_timer_t *timer);
+
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return time_us_64() + us; }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return time_us_64() + ms * 1000ull; }
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + ms * 1000ull; }
+static inline int64_t absolute_time_diff_us(absolute_time_t de, absolute_time_t ate) { return (int64_t)(ate - de); }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline bool time_reached(absolute_time_t t) { return time_us_64() >= t; }
+
+#include "pico/multicore.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,24 @@
+// pico/sync.h (host)
+
+#ifndef HOST_PICO_SYNC_H
+#define HOST_PICO_SYNC_H
+
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    pthread_mutex_t mutex;
+} critical_section_t;
+
+static inline void critical_section_init(critical_section_t *cs) { pthread_mutex_init(&cs->mutex, NULL); }
+static inline void critical_section_enter_blocking(critical_section_t *cs) { pthread_mutex_lock(&cs->mutex); }
+static inline void critical_section_exit(critical_section_t *cs) { pthread_mutex_unlock(&cs->mutex); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,25 @@
+// pico/unique_id.h (host) - Id da "placa" vem de BOTOSMART_SIM_ID_PLACA (hex), para simular uma frota
+
+#ifndef HOST_PICO_UNIQUE_ID_H
+#define HOST_PICO_UNIQUE_ID_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PICO_UNIQUE_BOARD_ID_SIZE_BYTES 8
+
+typedef struct {
+    uint8_t id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES];
+} pico_unique_board_id_t;
+
+void pico_get_unique_board_id(pico_unique_board_id_t *id_out);
+void pico_get_unique_board_id_string(char *id_out, uint len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+// sim.h - Interface interna entre os shims de HAL da simulação de host
+
+#ifndef SIM_H
+#define SIM_H
+
+#include "pico/stdlib.h"
+
+// --- Relógio virtual (sim_relogio.c) ---
+// O core 0 (thread principal) faz o tempo andar em sleep_*(); o core 1 só espera por ele.
+// Eventos agendados rodam no core 0, no instante virtual em que vencem, como callbacks
+// de interrupção ou do contexto de fundo do lwIP rodariam na placa.
+typedef void (*sim_evento_fn)(void *arg);
+
+void sim_agendar_us(uint64_t quando_us, sim_evento_fn fn, void *arg);
+// Tempo gasto pelo core 0 em uma operação bloqueante (ex.: bytes no I2C); ignorado no core 1
+void sim_consumir_us(uint64_t us);
+// Chamado antes de o core 1 começar a rodar (sim_multicore.c)
+void sim_core1_iniciado(void);
+
+// --- Plataforma (sim_plataforma.c) ---
+// Lê uma variável de ambiente numérica, com valor padrão
+long sim_env_long(const char *nome, long padrao);
+// Registra uma função que imprime um relatório ao fim da simulação
+void sim_relatorio_registrar(void (*fn)(void));
+
+// --- Barramentos I2C (sim_i2c.c) ---
+typedef struct {
+    const char *nome;
+    // Retornam bytes transferidos ou PICO_ERROR_* (dispositivo pode "travar" o barramento)
+    int (*escrever)(void *ctx, const uint8_t *buf, size_t len, bool nostop);
+    int (*ler)(void *ctx, uint8_t *buf, size_t len, bool nostop);
+    void *ctx;
+} sim_i2c_dispositivo_t;
+
+// i2c0 e i2c1, seguidos dos barramentos no PIO (sim_pio_i2c.c) na ordem em que são iniciados
+#define SIM_I2C_PIO_PRIMEIRO 2
+#define SIM_I2C_BARRAMENTOS  (SIM_I2C_PIO_PRIMEIRO + 8)
+
+void sim_i2c_conectar(uint barramento, uint8_t endereco, const sim_i2c_dispositivo_t *dispositivo);
+// Transação sem passar tempo no relógio virtual (quem chama conta o tempo de barramento)
+int sim_i2c_transferir(uint barramento, uint8_t endereco, uint8_t *buf, size_t len, bool nostop, bool leitura);
+// Conta uma recuperação do barramento (os de hardware contam em i2c_deinit())
+void sim_i2c_reiniciar(uint barramento);
+
+typedef struct {
+    uint64_t transacoes;
+    uint64_t bytes;      // inclui o byte de endereço de cada transação
+    uint64_t nacks;
+    uint64_t timeouts;
+    uint64_t reinicios;  // i2c_deinit(), ou seja, recuperações do barramento pelo firmware
+} sim_i2c_contadores_t;
+
+sim_i2c_contadores_t sim_i2c_contadores(uint barramento);
+
+// --- GPIO (sim_gpio.c) ---
+typedef void (*sim_gpio_observador_fn)(uint gpio, bool valor, uint64_t t_us);
+void sim_gpio_observar(sim_gpio_observador_fn fn);
+
+// --- Avaliação contra o traço (sim_avaliacao.c) ---
+void sim_avaliacao_iniciar(void);
+
+// --- Watchdog (sim_watchdog.c) ---
+// Código de saída de um reinício (watchdog ou watchdog_reboot)
+#define SIM_CODIGO_REINICIO 3
+
+// --- Rede (sim_rede.c) ---
+typedef struct {
+    uint64_t publicacoes;
+    uint64_t bytes;
+} sim_mqtt_contadores_t;
+
+sim_mqtt_contadores_t sim_mqtt_contadores(void);
+// Entrega ao nó uma mensagem vinda de fora do broker em processo (ponte)
+void sim_mqtt_entregar(const char *topico, const uint8_t *dados, size_t len);
+
+// --- Ponte para um broker MQTT real (sim_mqtt_ponte.c) ---
+// Ativa com BOTOSMART_SIM_MQTT_BROKER=host[:porta]; o relógio virtual passa a acompanhar o real
+bool sim_ponte_ativa(void);
+// Com will_topico não nulo, o broker real publica a última vontade (retida) se a ponte cair
+void sim_ponte_conectar(const char *client_id, const char *will_topico, const char *will_msg, bool will_retido);
+void sim_ponte_assinar(const char *filtro, uint8_t qos);
+void sim_ponte_publicar(const char *topico, const void *dados, size_t len, uint8_t qos, bool retido);
+
+// --- TCP do lwIP sobre sockets do host (sim_tcp.c) ---
+// Ativo com BOTOSMART_SIM_HTTP_PORTA=n (porta 80 do nó em 127.0.0.1:n); o relógio virtual
+// passa a acompanhar o real
+bool sim_tcp_ativo(void);
+
+#endif
@@ -0,0 +1,117 @@
+// sim_avaliacao.c - Latência de detecção e falsos alarmes do relé contra a verdade do traço
+//
+// No fim do traço a simulação sai com código 1 se passar de algum dos limites:
+//   BOTOSMART_SIM_MAX_PERDIDOS     eventos sem acionamento (padrão 0)
+//   BOTOSMART_SIM_MAX_FALSOS       acionamentos fora de evento (padrão sem limite)
+//   BOTOSMART_SIM_MAX_LATENCIA_MS  maior latência evento → relé (padrão sem limite)
+// Dois casos de relé ligado fora de evento não são falso alarme e saem à parte: num trecho sem
+// alvo é o estado seguro do intertravamento; ligado antes de um evento e mantido até ele começar
+// é detecção antecipada (a verdade do traço vem do nível médio, e o ruído cruza o limiar antes).
+
+#include "sim.h"
+#include "sim_vl53l0x.h"
+#include "config.h"
+#include <stdlib.h>
+
+#define AVALIACAO_PERIODO_US 100000 // resolução da verdade de referência (100 ms)
+
+static struct {
+    bool evento;
+    bool detectado;
+    uint64_t inicio_evento_us;
+
+    uint32_t eventos;
+    uint32_t detectados;
+    uint32_t perdidos;
+    uint64_t soma_latencia_us;
+    uint64_t max_latencia_us;
+
+    uint32_t falsos_alarmes;
+    bool suspeito;               // ligado fora de evento, com alvo: falso se desligar antes de um evento
+    uint32_t antecipados;        // ligado antes de um evento e mantido até ele começar
+    uint32_t seguros;            // relé ligado por falta de leitura, fora de evento
+    uint64_t rele_ligado_us;     // início do acionamento atual
+    uint64_t tempo_falso_us;     // relé ligado fora de evento
+} av;
+
+static void registrar_deteccao(uint64_t t_us) {
+    uint64_t latencia = t_us > av.inicio_evento_us ? t_us - av.inicio_evento_us : 0;
+    av.detectado = true;
+    av.detectados++;
+    av.soma_latencia_us += latencia;
+    if (latencia > av.max_latencia_us) av.max_latencia_us = latencia;
+}
+
+static void observar_rele(uint gpio, bool valor, uint64_t t_us) {
+    if (gpio != RELER_PIN) return;
+    if (valor) {
+        av.rele_ligado_us = t_us;
+        if (av.evento && !av.detectado) registrar_deteccao(t_us);
+        else if (!av.evento && sim_vl53l0x_sem_alvo(t_us)) av.seguros++;
+        else if (!av.evento) av.suspeito = true;
+    } else if (!av.evento) {
+        av.tempo_falso_us += t_us - av.rele_ligado_us;
+        if (av.suspeito) av.falsos_alarmes++;
+        av.suspeito = false;
+    }
+}
+
+// Limite negativo: não verificado
+static bool dentro(const char *nome, long padrao, uint64_t valor) {
+    long limite = sim_env_long(nome, padrao);
+    if (limite < 0 || valor <= (uint64_t)limite) return true;
+    printf("[avaliação] reprovada: %llu acima de %s=%ld\n", (unsigned long long)valor, nome, limite);
+    return false;
+}
+
+static bool aprovada(void) {
+    bool ok = dentro("BOTOSMART_SIM_MAX_PERDIDOS", 0, av.perdidos);
+    ok &= dentro("BOTOSMART_SIM_MAX_FALSOS", -1, av.falsos_alarmes + av.suspeito);
+    ok &= dentro("BOTOSMART_SIM_MAX_LATENCIA_MS", -1, av.max_latencia_us / 1000);
+    return ok;
+}
+
+static void amostrar(void *arg) {
+    (void)arg;
+    uint64_t agora = time_us_64();
+    bool evento = sim_vl53l0x_evento_ativo(agora);
+
+    if (evento && !av.evento) {
+        av.eventos++;
+        av.inicio_evento_us = agora;
+        av.detectado = false;
+        if (gpio_get(RELER_PIN)) registrar_deteccao(agora); // já estava acionado
+        if (av.suspeito) av.antecipados++;
+        av.suspeito = false;
+    } else if (!evento && av.evento) {
+        if (!av.detectado) av.perdidos++;
+        if (gpio_get(RELER_PIN)) av.rele_ligado_us = agora; // o que vier agora conta como falso
+    }
+    av.evento = evento;
+
+    if (sim_vl53l0x_traco_terminou(agora)) {
+        exit(aprovada() ? 0 : 1);
+    }
+    sim_agendar_us(agora + AVALIACAO_PERIODO_US, amostrar, NULL);
+}
+
+static void relatorio_avaliacao(void) {
+    uint64_t agora = time_us_64();
+    uint64_t falso = av.tempo_falso_us;
+    if (gpio_get(RELER_PIN) && !av.evento) falso += agora - av.rele_ligado_us;
+
+    printf("[avaliação] eventos: %u, detectados: %u, perdidos: %u", av.eventos, av.detectados, av.perdidos);
+    if (av.detectados) {
+        printf(", latência média %.1f s, máx %.1f s", av.soma_latencia_us / 1e6 / av.detectados,
+               av.max_latencia_us / 1e6);
+    }
+    printf("\n[avaliação] falsos alarmes: %u, antecipados: %u, estado seguro sem leitura: %u"
+           " (relé ligado %.1f s fora de evento)\n",
+           av.falsos_alarmes + av.suspeito, av.antecipados, av.seguros, falso / 1e6);
+}
+
+void sim_avaliacao_iniciar(void) {
+    sim_gpio_observar(observar_rele);
+    sim_agendar_us(0, amostrar, NULL);
+    sim_relatorio_registrar(relatorio_avaliacao);
+}
@@ -0,0 +1,20 @@
+// sim_boot.c - O estágio de boot (boot/boot_ota.c) na simulação: antes do main do firmware,
+// conclui a troca de slots que a OTA pediu no boot anterior (ou que uma queda interrompeu)
+
+#include "sim.h"
+#include "ota_troca.h"
+#include "hardware/watchdog.h"
+
+static void alimentar(void) {
+    watchdog_update();
+}
+
+// Depois de sim_flash.c carregar a flash (prioridade 101)
+__attribute__((constructor(102)))
+static void estagio_de_boot(void) {
+    if (!ota_troca_pendente()) return;
+    uint64_t inicio_us = time_us_64();
+    watchdog_enable(OTA_TROCA_WATCHDOG_MS, true);
+    ota_troca_executar(alimentar);
+    printf("[sim] estágio de boot: troca de slots concluída em %.3f s\n", (time_us_64() - inicio_us) / 1e6);
+}
@@ -0,0 +1,49 @@
+// sim_dispositivos.c - Dispositivos ligados aos barramentos falsos no início da simulação
+
+#include "sim.h"
+#include "sim_vl53l0x.h"
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+
+// --- SSD1306: aceita tudo e separa bytes de comando e de dados ---
+
+typedef struct {
+    uint64_t bytes_comando;
+    uint64_t bytes_dados;
+} ssd1306_sim_t;
+
+static ssd1306_sim_t ssd1306_sim;
+
+static int ssd1306_sim_escrever(void *ctx, const uint8_t *buf, size_t len, bool nostop) {
+    ssd1306_sim_t *s = ctx;
+    (void)nostop;
+    if (len == 0) return 0;
+    if (buf[0] == 0x40) s->bytes_dados += len - 1;
+    else s->bytes_comando += len - 1;
+    return (int)len;
+}
+
+static int ssd1306_sim_ler(void *ctx, uint8_t *buf, size_t len, bool nostop) {
+    (void)ctx; (void)nostop;
+    memset(buf, 0, len);
+    return (int)len;
+}
+
+static void relatorio_ssd1306(void) {
+    printf("[ssd1306] %llu bytes de comando, %llu bytes de dados\n",
+           (unsigned long long)ssd1306_sim.bytes_comando, (unsigned long long)ssd1306_sim.bytes_dados);
+}
+
+__attribute__((constructor))
+static void conectar_dispositivos(void) {
+    sim_vl53l0x_conectar(0, VL53L0X_ADDR);
+    for (int i = 0; i < SENSORES_PIO; i++) sim_vl53l0x_conectar(SIM_I2C_PIO_PRIMEIRO + i, VL53L0X_ADDR);
+    if (getenv("BOTOSMART_SIM_TRACO")) {
+        sim_avaliacao_iniciar();
+    }
+
+    sim_i2c_dispositivo_t oled = {"ssd1306", ssd1306_sim_escrever, ssd1306_sim_ler, &ssd1306_sim};
+    sim_i2c_conectar(1, 0x3C, &oled);
+    sim_relatorio_registrar(relatorio_ssd1306);
+}
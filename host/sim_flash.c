@@ -0,0 +1,52 @@
+// sim_flash.c - Flash de 2 MB em RAM; com BOTOSMART_SIM_FLASH ela persiste entre execuções
+
+#include "sim.h"
+#include "hardware/flash.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Tempos típicos do W25Q16 da Pico W
+#define SIM_FLASH_APAGAR_SETOR_US 45000
+#define SIM_FLASH_GRAVAR_PAGINA_US 800
+
+uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+static FILE *arquivo;
+
+__attribute__((constructor(101))) static void carregar(void) { // antes do estágio de boot (sim_boot.c)
+    memset(sim_flash, 0xFF, sizeof(sim_flash));
+    const char *caminho = getenv("BOTOSMART_SIM_FLASH");
+    if (!caminho || !*caminho) return;
+
+    arquivo = fopen(caminho, "r+b");
+    if (arquivo) {
+        size_t lidos = fread(sim_flash, 1, sizeof(sim_flash), arquivo);
+        (void)lidos; // arquivo menor: o resto continua apagado
+    } else {
+        arquivo = fopen(caminho, "w+b");
+        if (arquivo) fwrite(sim_flash, 1, sizeof(sim_flash), arquivo);
+    }
+}
+
+static void persistir(uint32_t offs, size_t count) {
+    if (!arquivo) return;
+    fseek(arquivo, offs, SEEK_SET);
+    fwrite(sim_flash + offs, 1, count, arquivo);
+    fflush(arquivo);
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    assert(flash_offs % FLASH_SECTOR_SIZE == 0 && count % FLASH_SECTOR_SIZE == 0);
+    assert(flash_offs + count <= sizeof(sim_flash));
+    memset(sim_flash + flash_offs, 0xFF, count);
+    sim_consumir_us((count / FLASH_SECTOR_SIZE) * SIM_FLASH_APAGAR_SETOR_US);
+    persistir(flash_offs, count);
+}
+
+// Como no chip, gravar só leva bits de 1 para 0
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    assert(flash_offs % FLASH_PAGE_SIZE == 0 && count % FLASH_PAGE_SIZE == 0);
+    assert(flash_offs + count <= sizeof(sim_flash));
+    for (size_t i = 0; i < count; i++) sim_flash[flash_offs + i] &= data[i];
+    sim_consumir_us((count / FLASH_PAGE_SIZE) * SIM_FLASH_GRAVAR_PAGINA_US);
+    persistir(flash_offs, count);
+}
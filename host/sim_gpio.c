@@ -0,0 +1,118 @@
+// sim_gpio.c - Registrador de GPIO: transições, tempo em nível alto e log CSV opcional
+
+#include "sim.h"
+#include <stdlib.h>
+
+#define SIM_NUM_GPIOS 30
+#define SIM_MAX_OBSERVADORES 4
+
+typedef struct {
+    bool usado;
+    bool saida;
+    bool valor;
+    uint64_t transicoes;
+    uint64_t alto_desde_us;
+    uint64_t tempo_alto_us;
+} pino_t;
+
+static pino_t pinos[SIM_NUM_GPIOS];
+static FILE *log_csv;
+static bool iniciado;
+static sim_gpio_observador_fn observadores[SIM_MAX_OBSERVADORES];
+static int num_observadores;
+
+static void relatorio_gpio(void) {
+    uint64_t agora = time_us_64();
+    for (uint g = 0; g < SIM_NUM_GPIOS; g++) {
+        pino_t *p = &pinos[g];
+        if (!p->usado || !p->saida) continue;
+        uint64_t alto = p->tempo_alto_us + (p->valor ? agora - p->alto_desde_us : 0);
+        printf("[gpio%u] %llu transições, %.1f%% do tempo em nível alto\n", g,
+               (unsigned long long)p->transicoes, agora ? 100.0 * alto / agora : 0.0);
+    }
+    if (log_csv) fclose(log_csv);
+}
+
+static void iniciar() {
+    if (iniciado) return;
+    iniciado = true;
+    const char *caminho = getenv("BOTOSMART_SIM_GPIO_CSV");
+    if (caminho && *caminho) {
+        log_csv = fopen(caminho, "w");
+        if (log_csv) fprintf(log_csv, "t_us,gpio,valor\n");
+    }
+    sim_relatorio_registrar(relatorio_gpio);
+}
+
+void sim_gpio_observar(sim_gpio_observador_fn fn) {
+    if (num_observadores < SIM_MAX_OBSERVADORES) observadores[num_observadores++] = fn;
+}
+
+void gpio_init(unsigned int gpio) {
+    iniciar();
+    pinos[gpio].usado = true;
+    pinos[gpio].saida = false;
+    pinos[gpio].valor = false;
+}
+
+void gpio_set_dir(unsigned int gpio, bool out) {
+    pinos[gpio].saida = out;
+}
+
+void gpio_set_function(unsigned int gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_pull_up(unsigned int gpio) {
+    (void)gpio;
+}
+
+void gpio_disable_pulls(unsigned int gpio) {
+    (void)gpio;
+}
+
+void gpio_put(unsigned int gpio, bool value) {
+    pino_t *p = &pinos[gpio];
+    if (p->valor == value) return;
+
+    uint64_t agora = time_us_64();
+    if (value) {
+        p->alto_desde_us = agora;
+    } else {
+        p->tempo_alto_us += agora - p->alto_desde_us;
+    }
+    p->valor = value;
+    p->transicoes++;
+
+    if (log_csv) fprintf(log_csv, "%llu,%u,%d\n", (unsigned long long)agora, gpio, value);
+    for (int i = 0; i < num_observadores; i++) observadores[i](gpio, value, agora);
+}
+
+bool gpio_get(unsigned int gpio) {
+    return pinos[gpio].valor;
+}
+
+// --- ADC ---
+
+static unsigned entrada_adc;
+
+void adc_init(void) {
+}
+
+void adc_gpio_init(unsigned int gpio) {
+    pinos[gpio].usado = true;
+    pinos[gpio].saida = false;
+}
+
+void adc_select_input(unsigned int input) {
+    entrada_adc = input;
+}
+
+// Entrada 3: VSYS / 3 (BOTOSMART_SIM_VSYS_MV), com 12 bits sobre 3,3 V
+uint16_t adc_read(void) {
+    if (entrada_adc != 3) return 0;
+    long mv = sim_env_long("BOTOSMART_SIM_VSYS_MV", 5000);
+    long bruto = mv * 4096 / (3 * 3300);
+    return (uint16_t)(bruto > 4095 ? 4095 : bruto);
+}
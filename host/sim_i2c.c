@@ -0,0 +1,179 @@
+// sim_i2c.c - Barramentos I2C falsos com dispositivos simulados e contagem de tráfego
+
+#include "sim.h"
+#include "hardware/i2c.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_I2C_MAX_DISPOSITIVOS 8
+
+struct i2c_inst {
+    uint indice;
+    uint baudrate;
+};
+
+typedef struct {
+    uint8_t endereco;
+    sim_i2c_dispositivo_t dispositivo;
+} conexao_t;
+
+typedef struct {
+    conexao_t conexoes[SIM_I2C_MAX_DISPOSITIVOS];
+    int num_conexoes;
+    sim_i2c_contadores_t contadores;
+    // Falhas injetadas: SDA preso em nível baixo até a recuperação, ou dispositivos ausentes
+    uint64_t trava_us;
+    bool trava_disparada;
+    bool travado;
+    uint64_t ausente_ini_us;
+    uint64_t ausente_fim_us;
+} barramento_t;
+
+i2c_inst_t i2c0_inst = {0, 100000};
+i2c_inst_t i2c1_inst = {1, 100000};
+
+static barramento_t barramentos[SIM_I2C_BARRAMENTOS];
+static bool iniciado;
+
+// Os barramentos no PIO só aparecem se foram usados
+static void relatorio_i2c(void) {
+    for (int b = 0; b < SIM_I2C_BARRAMENTOS; b++) {
+        sim_i2c_contadores_t *c = &barramentos[b].contadores;
+        if (b >= SIM_I2C_PIO_PRIMEIRO && !c->transacoes) continue;
+        printf("[%s%d] %llu transações, %llu bytes, %llu NACKs, %llu timeouts, %llu reinícios\n",
+               b < SIM_I2C_PIO_PRIMEIRO ? "i2c" : "pio_i2c", b < SIM_I2C_PIO_PRIMEIRO ? b : b - SIM_I2C_PIO_PRIMEIRO,
+               (unsigned long long)c->transacoes, (unsigned long long)c->bytes,
+               (unsigned long long)c->nacks, (unsigned long long)c->timeouts,
+               (unsigned long long)c->reinicios);
+    }
+}
+
+// As falhas injetadas valem para o barramento do sensor (i2c0)
+static void iniciar(void) {
+    if (iniciado) return;
+    iniciado = true;
+    sim_relatorio_registrar(relatorio_i2c);
+
+    for (int i = 0; i < SIM_I2C_BARRAMENTOS; i++) barramentos[i].trava_us = UINT64_MAX;
+    barramento_t *b = &barramentos[0];
+    long trava_s = sim_env_long("BOTOSMART_SIM_I2C0_TRAVA_S", -1);
+    if (trava_s >= 0) b->trava_us = (uint64_t)trava_s * 1000000u;
+
+    long ausente_s = sim_env_long("BOTOSMART_SIM_I2C0_AUSENTE_S", -1);
+    if (ausente_s >= 0) {
+        b->ausente_ini_us = (uint64_t)ausente_s * 1000000u;
+        b->ausente_fim_us = b->ausente_ini_us + (uint64_t)sim_env_long("BOTOSMART_SIM_I2C0_AUSENTE_DURACAO_S", 10) * 1000000u;
+    }
+}
+
+void sim_i2c_conectar(uint barramento, uint8_t endereco, const sim_i2c_dispositivo_t *dispositivo) {
+    barramento_t *b = &barramentos[barramento];
+    iniciar();
+    if (b->num_conexoes < SIM_I2C_MAX_DISPOSITIVOS) {
+        b->conexoes[b->num_conexoes++] = (conexao_t){endereco, *dispositivo};
+    }
+}
+
+sim_i2c_contadores_t sim_i2c_contadores(uint barramento) {
+    return barramentos[barramento].contadores;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+// Os pulsos de clock da recuperação soltam o SDA; o reinício da porta marca esse ponto
+void i2c_deinit(i2c_inst_t *i2c) {
+    barramento_t *b = &barramentos[i2c->indice];
+    b->contadores.reinicios++;
+    b->travado = false;
+}
+
+uint i2c_hw_index(i2c_inst_t *i2c) {
+    return i2c->indice;
+}
+
+static const sim_i2c_dispositivo_t *procurar(barramento_t *b, uint8_t endereco) {
+    for (int i = 0; i < b->num_conexoes; i++) {
+        if (b->conexoes[i].endereco == endereco) return &b->conexoes[i].dispositivo;
+    }
+    return NULL;
+}
+
+// Tempo de barramento: 9 bits por byte (8 + ACK), mais o byte de endereço
+static void ocupar_barramento(i2c_inst_t *i2c, size_t len) {
+    sim_consumir_us(((uint64_t)(len + 1) * 9 * 1000000u) / i2c->baudrate);
+}
+
+// Troca os dados com o dispositivo e conta o tráfego; o tempo de barramento fica com quem chama
+static int trocar(barramento_t *b, uint8_t addr, uint8_t *buf, size_t len, bool nostop, bool leitura,
+                  uint64_t agora) {
+    b->contadores.bytes += len + 1;
+    const sim_i2c_dispositivo_t *d = procurar(b, addr);
+    if (agora >= b->ausente_ini_us && agora < b->ausente_fim_us) d = NULL;
+
+    if (!d) {
+        b->contadores.nacks++;
+        return PICO_ERROR_GENERIC;
+    }
+    int r = leitura ? d->ler(d->ctx, buf, len, nostop) : d->escrever(d->ctx, buf, len, nostop);
+    if (r == PICO_ERROR_GENERIC) b->contadores.nacks++;
+    if (r == PICO_ERROR_TIMEOUT) b->contadores.timeouts++;
+    return r;
+}
+
+// limite == 0: chamada bloqueante sem timeout
+static int transferir(i2c_inst_t *i2c, uint8_t addr, uint8_t *buf, size_t len, bool nostop, bool leitura,
+                      absolute_time_t limite) {
+    barramento_t *b = &barramentos[i2c->indice];
+    uint64_t agora = time_us_64();
+    iniciar();
+
+    b->contadores.transacoes++;
+    if (!b->trava_disparada && agora >= b->trava_us) {
+        b->trava_disparada = true;
+        b->travado = true;
+    }
+    if (b->travado) {
+        if (!limite) {
+            printf("[i2c%u] barramento travado em uma chamada sem timeout: o firmware pararia aqui\n", i2c->indice);
+            exit(1);
+        }
+        if (limite > agora) sim_consumir_us(limite - agora);
+        b->contadores.timeouts++;
+        return PICO_ERROR_TIMEOUT;
+    }
+
+    ocupar_barramento(i2c, len);
+    return trocar(b, addr, buf, len, nostop, leitura, agora);
+}
+
+int sim_i2c_transferir(uint barramento, uint8_t endereco, uint8_t *buf, size_t len, bool nostop, bool leitura) {
+    barramento_t *b = &barramentos[barramento];
+    iniciar();
+    b->contadores.transacoes++;
+    return trocar(b, endereco, buf, len, nostop, leitura, time_us_64());
+}
+
+void sim_i2c_reiniciar(uint barramento) {
+    barramentos[barramento].contadores.reinicios++;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    return transferir(i2c, addr, (uint8_t *)src, len, nostop, false, 0);
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    return transferir(i2c, addr, dst, len, nostop, true, 0);
+}
+
+int i2c_write_blocking_until(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop,
+                             absolute_time_t until) {
+    return transferir(i2c, addr, (uint8_t *)src, len, nostop, false, until);
+}
+
+int i2c_read_blocking_until(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop,
+                            absolute_time_t until) {
+    return transferir(i2c, addr, dst, len, nostop, true, until);
+}
@@ -0,0 +1,195 @@
+// sim_mqtt_ponte.c - Ponte do broker em processo para um broker MQTT real (MQTT 3.1.1 mínimo)
+//
+// Com BOTOSMART_SIM_MQTT_BROKER=host[:porta] as publicações e assinaturas do nó também vão
+// para o broker real, e o que chega de lá é entregue ao nó: ferramentas como
+// tools/ota_publicar.py falam com a simulação como falariam com a placa.
+
+#include "sim.h"
+#include <errno.h>
+#include <netdb.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define PONTE_POLL_MS        5
+#define PONTE_KEEPALIVE_S    60
+#define PONTE_RX_MAX         (16 * 1024)
+
+static int ativa = -1;
+static int sock = -1;
+static uint8_t rx[PONTE_RX_MAX];
+static size_t rx_len;
+static uint16_t proximo_id = 1;
+static uint64_t ultimo_envio_us;
+
+bool sim_ponte_ativa(void) {
+    if (ativa < 0) {
+        const char *broker = getenv("BOTOSMART_SIM_MQTT_BROKER");
+        ativa = broker && *broker;
+    }
+    return ativa;
+}
+
+static void falhar(const char *o_que) {
+    fprintf(stderr, "[sim] ponte MQTT: %s\n", o_que);
+    exit(1);
+}
+
+static void enviar(const uint8_t *buf, size_t len) {
+    while (len) {
+        ssize_t n = send(sock, buf, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) falhar("conexão perdida");
+        buf += n;
+        len -= (size_t)n;
+    }
+    ultimo_envio_us = time_us_64();
+}
+
+// Cabeçalho fixo + comprimento restante (até 4 bytes) + corpo
+static void enviar_pacote(uint8_t tipo, const uint8_t *corpo, size_t len) {
+    uint8_t cab[5];
+    size_t n = 0;
+    cab[n++] = tipo;
+    size_t resto = len;
+    do {
+        uint8_t b = resto % 128;
+        resto /= 128;
+        cab[n++] = b | (resto ? 0x80 : 0);
+    } while (resto);
+    enviar(cab, n);
+    if (len) enviar(corpo, len);
+}
+
+static size_t por_string(uint8_t *p, const char *s, size_t len) {
+    p[0] = (uint8_t)(len >> 8);
+    p[1] = (uint8_t)len;
+    memcpy(p + 2, s, len);
+    return len + 2;
+}
+
+static void processar_pacote(uint8_t tipo, const uint8_t *p, size_t len) {
+    if ((tipo >> 4) != 3 || len < 2) return; // só PUBLISH interessa; os ACKs do broker são ignorados
+    uint8_t qos = (tipo >> 1) & 3;
+    size_t topico_len = (size_t)(p[0] << 8 | p[1]);
+    size_t pos = 2 + topico_len + (qos ? 2 : 0);
+    if (pos > len) return;
+
+    char topico[128];
+    if (topico_len >= sizeof(topico)) return;
+    memcpy(topico, p + 2, topico_len);
+    topico[topico_len] = '\0';
+
+    if (qos) {
+        const uint8_t puback[2] = {p[2 + topico_len], p[3 + topico_len]};
+        enviar_pacote(0x40, puback, sizeof(puback));
+    }
+    sim_mqtt_entregar(topico, p + pos, len - pos);
+}
+
+static void consumir(void) {
+    while (rx_len >= 2) {
+        size_t resto = 0, mult = 1, i = 1;
+        for (;; i++) {
+            if (i >= rx_len) return;
+            if (i > 4) falhar("comprimento inválido");
+            resto += (rx[i] & 0x7F) * mult;
+            mult *= 128;
+            if (!(rx[i] & 0x80)) break;
+        }
+        size_t total = i + 1 + resto;
+        if (total > sizeof(rx)) falhar("mensagem maior que o buffer");
+        if (rx_len < total) return;
+        processar_pacote(rx[0], rx + i + 1, resto);
+        memmove(rx, rx + total, rx_len - total);
+        rx_len -= total;
+    }
+}
+
+static void sondar(void *arg) {
+    (void)arg;
+    while (true) {
+        ssize_t n = recv(sock, rx + rx_len, sizeof(rx) - rx_len, MSG_DONTWAIT);
+        if (n > 0) {
+            rx_len += (size_t)n;
+            consumir();
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) falhar("conexão perdida");
+        break;
+    }
+    if (time_us_64() - ultimo_envio_us > PONTE_KEEPALIVE_S * 500000ull) enviar_pacote(0xC0, NULL, 0); // PINGREQ
+    sim_agendar_us(time_us_64() + PONTE_POLL_MS * 1000ull, sondar, NULL);
+}
+
+void sim_ponte_conectar(const char *client_id, const char *will_topico, const char *will_msg, bool will_retido) {
+    if (sock >= 0) return;
+
+    char host[128];
+    snprintf(host, sizeof(host), "%s", getenv("BOTOSMART_SIM_MQTT_BROKER"));
+    const char *porta = "1883";
+    char *dois_pontos = strrchr(host, ':');
+    if (dois_pontos) {
+        *dois_pontos = '\0';
+        porta = dois_pontos + 1;
+    }
+
+    struct addrinfo dica = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM}, *res;
+    if (getaddrinfo(host, porta, &dica, &res) != 0) falhar("endereço do broker inválido");
+    for (struct addrinfo *a = res; a && sock < 0; a = a->ai_next) {
+        sock = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (sock >= 0 && connect(sock, a->ai_addr, a->ai_addrlen) != 0) {
+            close(sock);
+            sock = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if (sock < 0) falhar("broker inacessível");
+
+    // CONNECT: protocolo "MQTT" nível 4, sessão limpa, última vontade com QoS 1
+    uint8_t corpo[384];
+    size_t n = por_string(corpo, "MQTT", 4);
+    corpo[n++] = 4;
+    corpo[n++] = will_topico ? (uint8_t)(0x02 | 0x04 | 0x08 | (will_retido ? 0x20 : 0)) : 0x02;
+    corpo[n++] = 0;
+    corpo[n++] = PONTE_KEEPALIVE_S;
+    n += por_string(corpo + n, client_id, strnlen(client_id, 100));
+    if (will_topico) {
+        n += por_string(corpo + n, will_topico, strnlen(will_topico, 128));
+        n += por_string(corpo + n, will_msg, strnlen(will_msg, 128));
+    }
+    enviar_pacote(0x10, corpo, n);
+
+    uint8_t connack[4];
+    if (recv(sock, connack, sizeof(connack), MSG_WAITALL) != sizeof(connack) || connack[0] != 0x20 ||
+        connack[3] != 0) {
+        falhar("conexão recusada");
+    }
+    printf("[sim] ponte MQTT conectada a %s:%s\n", host, porta);
+    sim_agendar_us(time_us_64() + PONTE_POLL_MS * 1000ull, sondar, NULL);
+}
+
+void sim_ponte_assinar(const char *filtro, uint8_t qos) {
+    uint8_t corpo[160];
+    size_t len = strnlen(filtro, 128);
+    corpo[0] = (uint8_t)(proximo_id >> 8);
+    corpo[1] = (uint8_t)proximo_id++;
+    size_t n = 2 + por_string(corpo + 2, filtro, len);
+    corpo[n++] = qos > 1 ? 1 : qos;
+    enviar_pacote(0x82, corpo, n);
+}
+
+void sim_ponte_publicar(const char *topico, const void *dados, size_t len, uint8_t qos, bool retido) {
+    qos = qos ? 1 : 0;
+    size_t topico_len = strnlen(topico, 128);
+    uint8_t *corpo = malloc(topico_len + 4 + len);
+    size_t n = por_string(corpo, topico, topico_len);
+    if (qos) {
+        corpo[n++] = (uint8_t)(proximo_id >> 8);
+        corpo[n++] = (uint8_t)proximo_id++;
+    }
+    memcpy(corpo + n, dados, len);
+    enviar_pacote(0x30 | (uint8_t)(qos << 1) | (retido ? 1 : 0), corpo, n + len);
+    free(corpo);
+}
@@ -0,0 +1,25 @@
+// sim_multicore.c - Core 1 como thread POSIX
+
+#include "sim.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+static void (*entrada_core1)(void);
+
+static void *thread_core1(void *arg) {
+    (void)arg;
+    sim_core_atual = 1;
+    entrada_core1();
+    return NULL;
+}
+
+void multicore_launch_core1(void (*entrada)(void)) {
+    pthread_t thread;
+    entrada_core1 = entrada;
+    sim_core1_iniciado();
+    if (pthread_create(&thread, NULL, thread_core1, NULL) != 0) {
+        fprintf(stderr, "[sim] falha ao criar o core 1\n");
+        abort();
+    }
+    pthread_detach(thread);
+}
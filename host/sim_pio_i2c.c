@@ -0,0 +1,87 @@
+// sim_pio_i2c.c - Mestre I2C no PIO (pio_i2c.h) sobre os barramentos falsos de sim_i2c.c
+//
+// Cada pio_i2c_t iniciado ganha um barramento simulado a partir de SIM_I2C_PIO_PRIMEIRO, na
+// ordem de iniciação (sim_dispositivos.c liga os sensores extras na mesma ordem). Os dados
+// trocam no disparo, mas pio_i2c_concluir() só retorna quando o tempo de barramento da
+// transação já passou no relógio virtual: transações disparadas juntas em barramentos
+// diferentes se sobrepõem, como com o DMA na placa.
+
+#include "sim.h"
+#include "pio_i2c.h"
+#include <string.h>
+
+#define SIM_PIO_SMS 4
+
+static uint num_barramentos;
+static struct {
+    uint64_t fim_us;
+    int resultado;
+} transacoes[SIM_I2C_BARRAMENTOS - SIM_I2C_PIO_PRIMEIRO];
+
+static uint indice(const pio_i2c_t *bus) {
+    return bus->pio * SIM_PIO_SMS + bus->sm;
+}
+
+bool pio_i2c_iniciar(pio_i2c_t *bus, uint sda_pin, uint scl_pin, uint baudrate) {
+    if (scl_pin != sda_pin + 1) return false;
+    if (!bus->reservado) {
+        if (num_barramentos == count_of(transacoes)) return false;
+        bus->pio = (uint8_t)(num_barramentos / SIM_PIO_SMS);
+        bus->sm = (uint8_t)(num_barramentos % SIM_PIO_SMS);
+        bus->reservado = true;
+        num_barramentos++;
+    }
+    bus->sda_pin = sda_pin;
+    bus->baudrate = baudrate;
+    bus->sem_stop = false;
+    bus->em_andamento = false;
+    return true;
+}
+
+void pio_i2c_parar(pio_i2c_t *bus) {
+    if (!bus->reservado) return;
+    sim_i2c_reiniciar(SIM_I2C_PIO_PRIMEIRO + indice(bus));
+    bus->sem_stop = false;
+    bus->em_andamento = false;
+}
+
+bool pio_i2c_disparar(pio_i2c_t *bus, uint8_t endereco, const uint8_t *tx, size_t tx_len, uint8_t *rx,
+                      size_t rx_len, bool nostop) {
+    if (!bus->reservado || bus->em_andamento || !(tx_len + rx_len) || tx_len + rx_len > PIO_I2C_DADOS_MAX) {
+        return false;
+    }
+    uint barramento = SIM_I2C_PIO_PRIMEIRO + indice(bus);
+    int r = (int)tx_len;
+    if (tx_len) {
+        uint8_t copia[PIO_I2C_DADOS_MAX];
+        memcpy(copia, tx, tx_len);
+        r = sim_i2c_transferir(barramento, endereco, copia, tx_len, rx_len || nostop, false);
+    }
+    if (r >= 0 && rx_len) r = sim_i2c_transferir(barramento, endereco, bus->rx, rx_len, nostop, true);
+
+    // 9 bits por byte (8 + ACK), com os bytes de endereço
+    size_t bytes = (tx_len ? 1 + tx_len : 0) + (rx_len ? 1 + rx_len : 0);
+    transacoes[indice(bus)].fim_us = time_us_64() + ((uint64_t)bytes * 9 * 1000000u) / bus->baudrate;
+    transacoes[indice(bus)].resultado = r;
+    bus->destino = rx_len ? rx : NULL;
+    bus->recebidos = (uint8_t)rx_len;
+    bus->sem_stop = nostop && r >= 0;
+    bus->em_andamento = true;
+    return true;
+}
+
+int pio_i2c_concluir(pio_i2c_t *bus, absolute_time_t limite) {
+    if (!bus->em_andamento) return PICO_ERROR_GENERIC;
+    bus->em_andamento = false;
+    uint64_t agora = time_us_64(), fim = transacoes[indice(bus)].fim_us;
+    if (fim > limite) {
+        if (limite > agora) sim_consumir_us(limite - agora);
+        bus->sem_stop = false;
+        return PICO_ERROR_TIMEOUT;
+    }
+    if (fim > agora) sim_consumir_us(fim - agora);
+
+    int r = transacoes[indice(bus)].resultado;
+    if (r >= 0 && bus->destino) memcpy(bus->destino, bus->rx, bus->recebidos);
+    return r;
+}
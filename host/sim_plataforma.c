@@ -0,0 +1,73 @@
+// sim_plataforma.c - Utilitários comuns aos shims e relatório de fim de simulação
+
+#include "sim.h"
+#include "pico/unique_id.h"
+#include <poll.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define SIM_MAX_RELATORIOS 16
+
+static void (*relatorios[SIM_MAX_RELATORIOS])(void);
+static int num_relatorios;
+
+long sim_env_long(const char *nome, long padrao) {
+    const char *valor = getenv(nome);
+    return (valor && *valor) ? strtol(valor, NULL, 0) : padrao;
+}
+
+static void imprimir_relatorios(void) {
+    printf("\n=== Simulação encerrada em t=%.3f s ===\n", time_us_64() / 1e6);
+    for (int i = 0; i < num_relatorios; i++) {
+        relatorios[i]();
+    }
+    fflush(stdout);
+}
+
+void sim_relatorio_registrar(void (*fn)(void)) {
+    if (num_relatorios == 0) {
+        atexit(imprimir_relatorios);
+    }
+    if (num_relatorios < SIM_MAX_RELATORIOS) {
+        relatorios[num_relatorios++] = fn;
+    }
+}
+
+// Id único da placa: cada processo da simulação pode fazer o papel de um nó diferente da frota
+void pico_get_unique_board_id(pico_unique_board_id_t *id_out) {
+    const char *valor = getenv("BOTOSMART_SIM_ID_PLACA");
+    uint64_t id = (valor && *valor) ? strtoull(valor, NULL, 16) : 0xE6614103E7452D2Full;
+    for (int i = 0; i < PICO_UNIQUE_BOARD_ID_SIZE_BYTES; i++) {
+        id_out->id[i] = (uint8_t)(id >> (8 * (PICO_UNIQUE_BOARD_ID_SIZE_BYTES - 1 - i)));
+    }
+}
+
+void pico_get_unique_board_id_string(char *id_out, uint len) {
+    pico_unique_board_id_t id;
+    pico_get_unique_board_id(&id);
+    size_t n = 0;
+    for (int i = 0; i < PICO_UNIQUE_BOARD_ID_SIZE_BYTES && n + 2 < len; i++) {
+        n += (size_t)snprintf(id_out + n, len - n, "%02X", id.id[i]);
+    }
+    if (len) id_out[n < len ? n : len - 1] = '\0';
+}
+
+void stdio_init_all(void) {
+    // Saída de linha em linha, como o CDC USB entregaria ao terminal
+    setvbuf(stdout, NULL, _IOLBF, 0);
+}
+
+int stdio_put_string(const char *s, int len, bool newline, bool cr_translation) {
+    (void)cr_translation;
+    fwrite(s, 1, (size_t)len, stdout);
+    if (newline) putchar('\n');
+    return len;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    (void)timeout_us; // o tempo virtual não anda esperando o teclado
+    struct pollfd p = {.fd = STDIN_FILENO, .events = POLLIN};
+    unsigned char c;
+    if (poll(&p, 1, 0) > 0 && (p.revents & POLLIN) && read(STDIN_FILENO, &c, 1) == 1) return c;
+    return PICO_ERROR_TIMEOUT;
+}
@@ -0,0 +1,481 @@
+// sim_rede.c - Wi-Fi (cyw43) simulado e cliente MQTT do lwIP ligado a um broker em processo
+
+#include "sim.h"
+#include "config.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/apps/mqtt.h"
+#include "lwip/dhcp.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_MAX_ASSINATURAS 16
+#define SIM_MAX_TOPICOS 32
+#define SIM_TOPICO_MAX 96
+
+// Latências da rede simulada (tempo virtual)
+#define SIM_WIFI_VARREDURA_MS        2400  // varredura passiva dos 13 canais de 2,4 GHz
+#define SIM_WIFI_ASSOCIACAO_MS       1500  // join sem canal: inclui a varredura interna do firmware do chip
+#define SIM_WIFI_ASSOCIACAO_CANAL_MS 300   // join com BSSID e canal conhecidos
+#define SIM_DHCP_MS                  1000  // DISCOVER/OFFER/REQUEST/ACK
+#define SIM_MQTT_CONEXAO_MS          50
+#define SIM_MQTT_TIMEOUT_MS          10000 // conexão TCP que nunca completa
+#define SIM_MQTT_ENTREGA_MS          20
+
+// O único ponto de acesso e a concessão que o servidor DHCP simulado entrega
+static const uint8_t ap_bssid[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+#define SIM_AP_RSSI       -55
+#define SIM_DHCP_IP       0xC0A80064u  // 192.168.0.100
+#define SIM_DHCP_MASCARA  0xFFFFFF00u
+#define SIM_DHCP_GATEWAY  0xC0A80001u
+
+struct mqtt_client_s {
+    bool conectado;
+    mqtt_connection_cb_t conexao_cb;
+    void *conexao_arg;
+    mqtt_incoming_publish_cb_t pub_cb;
+    mqtt_incoming_data_cb_t data_cb;
+    void *inpub_arg;
+    char assinaturas[SIM_MAX_ASSINATURAS][SIM_TOPICO_MAX];
+    int num_assinaturas;
+};
+
+typedef struct {
+    char topico[SIM_TOPICO_MAX];
+    uint64_t mensagens;
+    uint64_t bytes;
+} estatistica_topico_t;
+
+typedef struct {
+    mqtt_client_t *cliente;
+    char topico[SIM_TOPICO_MAX];
+    u16_t len;
+    u8_t dados[];
+} entrega_t;
+
+static mqtt_client_t cliente_unico;
+static estatistica_topico_t topicos[SIM_MAX_TOPICOS];
+static int num_topicos;
+static sim_mqtt_contadores_t contadores;
+static FILE *log_csv;
+static long falhas_wifi_restantes = -1;
+
+cyw43_t cyw43_state;
+
+static struct {
+    bool dhcp;         // cliente DHCP ativo na interface STA
+    bool varrendo;
+    int link;          // CYW43_LINK_* do join em andamento ou concluído
+    uintptr_t geracao; // invalida eventos agendados antes de um leave
+    int (*varredura_cb)(void *, const cyw43_ev_scan_result_t *);
+    void *varredura_env;
+} wifi;
+
+// Tempo em cada modo de economia (0 sem economia, 1 PM1, 2 PM2), para comparar políticas
+static struct {
+    uint32_t modo;
+    uint64_t desde_us;
+    uint64_t tempo_us[3];
+    unsigned trocas;
+} radio = {.modo = CYW43_PM2_POWERSAVE_MODE}; // o driver associa com o modo padrão (PM2)
+
+static void radio_trocar(uint32_t modo) {
+    uint64_t agora = time_us_64();
+    radio.tempo_us[radio.modo] += agora - radio.desde_us;
+    radio.desde_us = agora;
+    if (modo != radio.modo) radio.trocas++;
+    radio.modo = modo;
+}
+
+static void relatorio_radio(void) {
+    static const char *const nomes[3] = {"sem economia", "PM1", "PM2"};
+    radio_trocar(radio.modo);
+    uint64_t total = radio.tempo_us[0] + radio.tempo_us[1] + radio.tempo_us[2];
+    printf("[rádio] %u trocas de modo;", radio.trocas);
+    for (int i = 0; i < 3; i++) {
+        printf(" %s %.1f s (%.0f%%)%s", nomes[i], radio.tempo_us[i] / 1e6,
+               total ? 100.0 * radio.tempo_us[i] / total : 0.0, i < 2 ? "," : "\n");
+    }
+}
+
+static void relatorio_mqtt(void) {
+    printf("[mqtt] %llu publicações, %llu bytes de payload\n",
+           (unsigned long long)contadores.publicacoes, (unsigned long long)contadores.bytes);
+    for (int i = 0; i < num_topicos; i++) {
+        printf("[mqtt]   %-40s %8llu msgs %10llu bytes\n", topicos[i].topico,
+               (unsigned long long)topicos[i].mensagens, (unsigned long long)topicos[i].bytes);
+    }
+    if (log_csv) fclose(log_csv);
+}
+
+sim_mqtt_contadores_t sim_mqtt_contadores(void) {
+    return contadores;
+}
+
+// --- cyw43 ---
+
+static struct netif *sta(void) {
+    return &cyw43_state.netif[CYW43_ITF_STA];
+}
+
+static bool consumir_falha_wifi(void) {
+    if (falhas_wifi_restantes < 0) {
+        falhas_wifi_restantes = sim_env_long("BOTOSMART_SIM_WIFI_FALHAS", 0);
+    }
+    if (falhas_wifi_restantes > 0) {
+        falhas_wifi_restantes--;
+        return true;
+    }
+    return false;
+}
+
+static void conceder_ip(void) {
+    ip4_addr_t ip = {SIM_DHCP_IP}, mascara = {SIM_DHCP_MASCARA}, gw = {SIM_DHCP_GATEWAY};
+    netif_set_addr(sta(), &ip, &mascara, &gw);
+}
+
+// Eventos de Wi-Fi levam a geração em que foram agendados; um leave os descarta
+static void evento_dhcp(void *arg) {
+    if ((uintptr_t)arg != wifi.geracao || !wifi.dhcp || wifi.link != CYW43_LINK_JOIN) return;
+    conceder_ip();
+}
+
+static void evento_join(void *arg) {
+    if ((uintptr_t)arg != wifi.geracao) return;
+    if (consumir_falha_wifi()) {
+        wifi.link = CYW43_LINK_FAIL;
+        return;
+    }
+    wifi.link = CYW43_LINK_JOIN; // associado; "UP" quando a interface tiver endereço
+    if (wifi.dhcp) sim_agendar_us(time_us_64() + SIM_DHCP_MS * 1000ull, evento_dhcp, (void *)wifi.geracao);
+}
+
+static void evento_nonet(void *arg) {
+    if ((uintptr_t)arg != wifi.geracao) return;
+    wifi.link = CYW43_LINK_NONET;
+}
+
+static void evento_varredura(void *arg) {
+    (void)arg;
+    wifi.varrendo = false;
+    cyw43_ev_scan_result_t r = {0};
+    memcpy(r.bssid, ap_bssid, sizeof(r.bssid));
+    r.ssid_len = (uint8_t)strlen(WIFI_SSID);
+    memcpy(r.ssid, WIFI_SSID, r.ssid_len);
+    r.channel = (uint16_t)sim_env_long("BOTOSMART_SIM_AP_CANAL", 6);
+    r.auth_mode = 7;
+    r.rssi = SIM_AP_RSSI;
+    if (wifi.varredura_cb) wifi.varredura_cb(wifi.varredura_env, &r);
+}
+
+// No SDK, antes de cyw43_arch_init() o contexto assíncrono é NULL: quem o usa cedo demais
+// trava a placa, então aqui a simulação para
+static bool arch_iniciada;
+
+int cyw43_arch_init(void) {
+    static long falhas_restantes = -1;
+    if (falhas_restantes < 0) falhas_restantes = sim_env_long("BOTOSMART_SIM_CYW43_FALHAS", 0);
+    if (falhas_restantes > 0) {
+        falhas_restantes--;
+        return -1;
+    }
+    arch_iniciada = true;
+    radio.desde_us = time_us_64();
+    sim_relatorio_registrar(relatorio_radio);
+    return 0;
+}
+
+void cyw43_arch_deinit(void) {
+    arch_iniciada = false;
+}
+
+// Como no cyw43_lwip.c do SDK, subir a interface STA já liga o cliente DHCP
+void cyw43_arch_enable_sta_mode(void) {
+    dhcp_start(sta());
+}
+
+int cyw43_arch_wifi_connect_timeout_ms(const char *ssid, const char *pw, uint32_t auth, uint32_t timeout) {
+    (void)ssid; (void)pw; (void)auth;
+    if (consumir_falha_wifi()) {
+        sleep_ms(timeout);
+        return PICO_ERROR_TIMEOUT;
+    }
+    sleep_ms(SIM_WIFI_ASSOCIACAO_MS);
+    wifi.link = CYW43_LINK_JOIN;
+    if (wifi.dhcp) conceder_ip();
+    return 0;
+}
+
+int cyw43_wifi_scan(cyw43_t *self, cyw43_wifi_scan_options_t *opts, void *env,
+                    int (*result_cb)(void *, const cyw43_ev_scan_result_t *)) {
+    (void)self; (void)opts;
+    if (wifi.varrendo) return -1;
+    wifi.varrendo = true;
+    wifi.varredura_cb = result_cb;
+    wifi.varredura_env = env;
+    sim_agendar_us(time_us_64() + SIM_WIFI_VARREDURA_MS * 1000ull, evento_varredura, NULL);
+    return 0;
+}
+
+bool cyw43_wifi_scan_active(cyw43_t *self) {
+    (void)self;
+    return wifi.varrendo;
+}
+
+// Com canal informado o chip vai direto ao AP; se ele não está naquele canal, o join falha
+int cyw43_wifi_join(cyw43_t *self, size_t ssid_len, const uint8_t *ssid, size_t key_len, const uint8_t *key,
+                    uint32_t auth_type, const uint8_t *bssid, uint32_t channel) {
+    (void)self; (void)ssid_len; (void)ssid; (void)key_len; (void)key; (void)auth_type;
+    wifi.geracao++;
+    wifi.link = CYW43_LINK_DOWN;
+    radio_trocar(CYW43_PM2_POWERSAVE_MODE);
+    uint64_t agora = time_us_64();
+
+    bool com_canal = channel != CYW43_CHANNEL_NONE;
+    if ((bssid && memcmp(bssid, ap_bssid, sizeof(ap_bssid)) != 0) ||
+        (com_canal && channel != (uint32_t)sim_env_long("BOTOSMART_SIM_AP_CANAL", 6))) {
+        sim_agendar_us(agora + SIM_WIFI_ASSOCIACAO_CANAL_MS * 1000ull, evento_nonet, (void *)wifi.geracao);
+        return 0;
+    }
+    uint64_t duracao_ms = com_canal ? SIM_WIFI_ASSOCIACAO_CANAL_MS : SIM_WIFI_ASSOCIACAO_MS;
+    sim_agendar_us(agora + duracao_ms * 1000ull, evento_join, (void *)wifi.geracao);
+    return 0;
+}
+
+int cyw43_wifi_leave(cyw43_t *self, int itf) {
+    (void)self; (void)itf;
+    wifi.geracao++;
+    wifi.link = CYW43_LINK_DOWN;
+    return 0;
+}
+
+int cyw43_wifi_get_bssid(cyw43_t *self, uint8_t bssid[6]) {
+    (void)self;
+    memcpy(bssid, ap_bssid, sizeof(ap_bssid));
+    return 0;
+}
+
+int cyw43_tcpip_link_status(cyw43_t *self, int itf) {
+    (void)self; (void)itf;
+    if (wifi.link == CYW43_LINK_JOIN && ip4_addr_get_u32(netif_ip4_addr(sta())) != 0) return CYW43_LINK_UP;
+    if (wifi.link == CYW43_LINK_JOIN) return CYW43_LINK_NOIP;
+    return wifi.link;
+}
+
+int cyw43_wifi_pm(cyw43_t *self, uint32_t pm) {
+    (void)self;
+    if ((pm & 0xf) > CYW43_PM2_POWERSAVE_MODE) return -1;
+    radio_trocar(pm & 0xf);
+    return 0;
+}
+
+void cyw43_arch_poll(void) {
+    assert(arch_iniciada);
+}
+
+// Sem concorrência na simulação: a trava só confere que o contexto já existe
+void cyw43_arch_lwip_begin(void) {
+    assert(arch_iniciada);
+}
+
+void cyw43_arch_lwip_end(void) {
+    assert(arch_iniciada);
+}
+
+// --- lwIP ---
+
+void netif_set_addr(struct netif *netif, const ip4_addr_t *ipaddr, const ip4_addr_t *netmask, const ip4_addr_t *gw) {
+    netif->ip_addr = *ipaddr;
+    netif->netmask = *netmask;
+    netif->gw = *gw;
+}
+
+err_t dhcp_start(struct netif *netif) {
+    ip4_addr_t zero = {0};
+    netif_set_addr(netif, &zero, &zero, &zero);
+    wifi.dhcp = true;
+    if (wifi.link == CYW43_LINK_JOIN) {
+        sim_agendar_us(time_us_64() + SIM_DHCP_MS * 1000ull, evento_dhcp, (void *)wifi.geracao);
+    }
+    return ERR_OK;
+}
+
+void dhcp_stop(struct netif *netif) {
+    ip4_addr_t zero = {0};
+    netif_set_addr(netif, &zero, &zero, &zero);
+    wifi.dhcp = false;
+}
+
+char *ip4addr_ntoa(const ip4_addr_t *addr) {
+    static char texto[16];
+    u32_t a = addr->addr;
+    snprintf(texto, sizeof(texto), "%u.%u.%u.%u", a >> 24, (a >> 16) & 0xFF, (a >> 8) & 0xFF, a & 0xFF);
+    return texto;
+}
+
+int ip4addr_aton(const char *cp, ip_addr_t *addr) {
+    unsigned a, b, c, d;
+    char resto;
+    if (sscanf(cp, "%u.%u.%u.%u%c", &a, &b, &c, &d, &resto) != 4 || a > 255 || b > 255 || c > 255 || d > 255) {
+        addr->addr = 0;
+        return 0;
+    }
+    addr->addr = (a << 24) | (b << 16) | (c << 8) | d;
+    return 1;
+}
+
+mqtt_client_t *mqtt_client_new(void) {
+    const char *caminho = getenv("BOTOSMART_SIM_MQTT_CSV");
+    if (caminho && *caminho && !log_csv) {
+        log_csv = fopen(caminho, "w");
+        if (log_csv) fprintf(log_csv, "t_us,topico,payload\n");
+    }
+    sim_relatorio_registrar(relatorio_mqtt);
+    memset(&cliente_unico, 0, sizeof(cliente_unico));
+    return &cliente_unico;
+}
+
+static void concluir_conexao(void *arg) {
+    mqtt_client_t *cliente = arg;
+    cliente->conectado = true;
+    if (cliente->conexao_cb) cliente->conexao_cb(cliente, cliente->conexao_arg, MQTT_CONNECT_ACCEPTED);
+}
+
+static void expirar_conexao(void *arg) {
+    mqtt_client_t *cliente = arg;
+    if (cliente->conexao_cb) cliente->conexao_cb(cliente, cliente->conexao_arg, MQTT_CONNECT_TIMEOUT);
+}
+
+// A rede simulada só roteia o endereço que o DHCP concede: um endereço fixo ou uma
+// concessão antiga diferente deixa a conexão TCP sem resposta
+static bool rota_ok(void) {
+    if (wifi.link != CYW43_LINK_JOIN) return false;
+    return ip4_addr_get_u32(netif_ip4_addr(sta())) == SIM_DHCP_IP;
+}
+
+err_t mqtt_client_connect(mqtt_client_t *client, const ip_addr_t *ipaddr, u16_t port, mqtt_connection_cb_t cb,
+                          void *arg, const struct mqtt_connect_client_info_t *client_info) {
+    (void)ipaddr; (void)port;
+    client->conexao_cb = cb;
+    client->conexao_arg = arg;
+    if (!rota_ok()) {
+        sim_agendar_us(time_us_64() + SIM_MQTT_TIMEOUT_MS * 1000ull, expirar_conexao, client);
+        return ERR_OK;
+    }
+    if (sim_ponte_ativa()) {
+        sim_ponte_conectar(client_info->client_id, client_info->will_topic, client_info->will_msg,
+                           client_info->will_retain);
+    }
+    sim_agendar_us(time_us_64() + SIM_MQTT_CONEXAO_MS * 1000ull, concluir_conexao, client);
+    return ERR_OK;
+}
+
+void mqtt_disconnect(mqtt_client_t *client) {
+    client->conectado = false;
+}
+
+u8_t mqtt_client_is_connected(mqtt_client_t *client) {
+    return client->conectado;
+}
+
+void mqtt_set_inpub_callback(mqtt_client_t *client, mqtt_incoming_publish_cb_t pub_cb,
+                             mqtt_incoming_data_cb_t data_cb, void *arg) {
+    client->pub_cb = pub_cb;
+    client->data_cb = data_cb;
+    client->inpub_arg = arg;
+}
+
+err_t mqtt_sub_unsub(mqtt_client_t *client, const char *topic, u8_t qos, mqtt_request_cb_t cb, void *arg, u8_t sub) {
+    if (!client->conectado) return ERR_CONN;
+    if (sub && sim_ponte_ativa()) sim_ponte_assinar(topic, qos);
+    if (sub && client->num_assinaturas < SIM_MAX_ASSINATURAS) {
+        strncpy(client->assinaturas[client->num_assinaturas], topic, SIM_TOPICO_MAX - 1);
+        client->num_assinaturas++;
+    }
+    if (cb) cb(arg, ERR_OK);
+    return ERR_OK;
+}
+
+// Filtro MQTT com curingas '+' (um nível) e '#' (resto do tópico)
+static bool topico_casa(const char *filtro, const char *topico) {
+    while (*filtro) {
+        if (*filtro == '#') return true;
+        if (*filtro == '+') {
+            while (*topico && *topico != '/') topico++;
+            filtro++;
+            continue;
+        }
+        if (*filtro != *topico) return false;
+        filtro++;
+        topico++;
+    }
+    return *topico == '\0';
+}
+
+static void entregar(void *arg) {
+    entrega_t *e = arg;
+    mqtt_client_t *c = e->cliente;
+    if (c->conectado && c->pub_cb && c->data_cb) {
+        c->pub_cb(c->inpub_arg, e->topico, e->len);
+        c->data_cb(c->inpub_arg, e->dados, e->len, MQTT_DATA_FLAG_LAST);
+    }
+    free(e);
+}
+
+void sim_mqtt_entregar(const char *topico, const uint8_t *dados, size_t len) {
+    entrega_t *e = malloc(sizeof(entrega_t) + len);
+    e->cliente = &cliente_unico;
+    strncpy(e->topico, topico, SIM_TOPICO_MAX - 1);
+    e->topico[SIM_TOPICO_MAX - 1] = '\0';
+    e->len = (u16_t)len;
+    memcpy(e->dados, dados, len);
+    entregar(e);
+}
+
+static void contabilizar(const char *topico, u16_t len) {
+    contadores.publicacoes++;
+    contadores.bytes += len;
+    for (int i = 0; i < num_topicos; i++) {
+        if (strcmp(topicos[i].topico, topico) == 0) {
+            topicos[i].mensagens++;
+            topicos[i].bytes += len;
+            return;
+        }
+    }
+    if (num_topicos < SIM_MAX_TOPICOS) {
+        estatistica_topico_t *t = &topicos[num_topicos++];
+        strncpy(t->topico, topico, SIM_TOPICO_MAX - 1);
+        t->mensagens = 1;
+        t->bytes = len;
+    }
+}
+
+err_t mqtt_publish(mqtt_client_t *client, const char *topic, const void *payload, u16_t payload_length, u8_t qos,
+                   u8_t retain, mqtt_request_cb_t cb, void *arg) {
+    if (!client->conectado) return ERR_CONN;
+
+    contabilizar(topic, payload_length);
+    if (log_csv) {
+        fprintf(log_csv, "%llu,%s,%.*s\n", (unsigned long long)time_us_64(), topic, payload_length,
+                (const char *)payload);
+    }
+
+    // O broker devolve a mensagem aos assinantes (o próprio nó, se assinou o tópico);
+    // com a ponte, quem devolve é o broker real
+    if (sim_ponte_ativa()) sim_ponte_publicar(topic, payload, payload_length, qos, retain);
+    for (int i = 0; i < client->num_assinaturas && !sim_ponte_ativa(); i++) {
+        if (topico_casa(client->assinaturas[i], topic)) {
+            entrega_t *e = malloc(sizeof(entrega_t) + payload_length);
+            e->cliente = client;
+            strncpy(e->topico, topic, SIM_TOPICO_MAX - 1);
+            e->topico[SIM_TOPICO_MAX - 1] = '\0';
+            e->len = payload_length;
+            memcpy(e->dados, payload, payload_length);
+            sim_agendar_us(time_us_64() + SIM_MQTT_ENTREGA_MS * 1000ull, entregar, e);
+            break;
+        }
+    }
+
+    if (cb) cb(arg, ERR_OK);
+    return ERR_OK;
+}
@@ -0,0 +1,181 @@
+// sim_relogio.c - Relógio virtual: horas de operação simulada em segundos de CPU
+
+#include "sim.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define SIM_MAX_EVENTOS 64
+
+typedef struct {
+    uint64_t quando_us;
+    sim_evento_fn fn;
+    void *arg;
+} evento_t;
+
+_Thread_local uint sim_core_atual = 0;
+
+static pthread_mutex_t relogio_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t relogio_cond = PTHREAD_COND_INITIALIZER;
+static uint64_t agora_us;
+static uint64_t limite_us;
+
+// Fila ordenada por instante de vencimento
+static evento_t eventos[SIM_MAX_EVENTOS];
+static int num_eventos;
+
+// Core 1 anda em passo com o core 0: o tempo só avança enquanto ele está dormindo,
+// e nunca passa do instante em que ele pediu para acordar
+static enum { CORE1_AUSENTE, CORE1_RODANDO, CORE1_DORMINDO } core1_estado;
+static uint64_t core1_acordar_us;
+
+// BOTOSMART_SIM_TEMPO_REAL=1 acompanha o relógio de parede (para observar ao vivo);
+// com a ponte para um broker real ou clientes TCP de fora isso é obrigatório, senão o outro
+// lado não acompanha
+static void acompanhar_tempo_real(uint64_t de, uint64_t ate) {
+    static long tempo_real = -1;
+    if (tempo_real < 0) tempo_real = sim_env_long("BOTOSMART_SIM_TEMPO_REAL", 0) || sim_ponte_ativa() || sim_tcp_ativo();
+    if (!tempo_real || ate <= de) return;
+    uint64_t us = ate - de;
+    struct timespec ts = {(time_t)(us / 1000000), (long)(us % 1000000) * 1000};
+    nanosleep(&ts, NULL);
+}
+
+static uint64_t limite() {
+    if (limite_us == 0) {
+        limite_us = (uint64_t)sim_env_long("BOTOSMART_SIM_SEGUNDOS", 3600) * 1000000ull;
+    }
+    return limite_us;
+}
+
+uint64_t time_us_64(void) {
+    pthread_mutex_lock(&relogio_mutex);
+    uint64_t t = agora_us;
+    pthread_mutex_unlock(&relogio_mutex);
+    return t;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+void sim_agendar_us(uint64_t quando_us, sim_evento_fn fn, void *arg) {
+    pthread_mutex_lock(&relogio_mutex);
+    if (num_eventos == SIM_MAX_EVENTOS) {
+        pthread_mutex_unlock(&relogio_mutex);
+        fprintf(stderr, "[sim] fila de eventos cheia\n");
+        abort();
+    }
+    int i = num_eventos++;
+    while (i > 0 && eventos[i - 1].quando_us > quando_us) {
+        eventos[i] = eventos[i - 1];
+        i--;
+    }
+    eventos[i] = (evento_t){quando_us, fn, arg};
+    pthread_mutex_unlock(&relogio_mutex);
+}
+
+static void disparar_timer(void *arg) {
+    repeating_timer_t *t = arg;
+    if (!t->ativo) return;
+    uint64_t inicio = time_us_64();
+    if (!t->callback(t)) {
+        t->ativo = false;
+        return;
+    }
+    uint64_t proximo = t->delay_us < 0 ? inicio + (uint64_t)-t->delay_us : time_us_64() + (uint64_t)t->delay_us;
+    sim_agendar_us(proximo, disparar_timer, t);
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data,
+                            repeating_timer_t *out) {
+    *out = (repeating_timer_t){delay_us, callback, user_data, true};
+    uint64_t periodo = (uint64_t)(delay_us < 0 ? -delay_us : delay_us);
+    sim_agendar_us(time_us_64() + periodo, disparar_timer, out);
+    return true;
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    bool estava = timer->ativo;
+    timer->ativo = false;
+    return estava;
+}
+
+void sim_core1_iniciado(void) {
+    pthread_mutex_lock(&relogio_mutex);
+    core1_estado = CORE1_RODANDO;
+    pthread_mutex_unlock(&relogio_mutex);
+}
+
+// Avança o tempo até 'alvo', disparando os eventos vencidos e acordando o core 1 pelo caminho
+static void avancar_ate(uint64_t alvo) {
+    while (true) {
+        pthread_mutex_lock(&relogio_mutex);
+        while (core1_estado == CORE1_RODANDO) {
+            pthread_cond_wait(&relogio_cond, &relogio_mutex);
+        }
+        uint64_t antes = agora_us;
+        if (core1_estado == CORE1_DORMINDO && core1_acordar_us <= alvo &&
+            (num_eventos == 0 || core1_acordar_us < eventos[0].quando_us)) {
+            if (core1_acordar_us > agora_us) agora_us = core1_acordar_us;
+            core1_estado = CORE1_RODANDO;
+            pthread_cond_broadcast(&relogio_cond);
+            pthread_mutex_unlock(&relogio_mutex);
+            acompanhar_tempo_real(antes, core1_acordar_us);
+            continue;
+        }
+        if (num_eventos == 0 || eventos[0].quando_us > alvo) {
+            if (alvo > agora_us) agora_us = alvo;
+            pthread_mutex_unlock(&relogio_mutex);
+            acompanhar_tempo_real(antes, alvo);
+            break;
+        }
+        evento_t ev = eventos[0];
+        num_eventos--;
+        for (int i = 0; i < num_eventos; i++) eventos[i] = eventos[i + 1];
+        if (ev.quando_us > agora_us) agora_us = ev.quando_us;
+        pthread_mutex_unlock(&relogio_mutex);
+        acompanhar_tempo_real(antes, ev.quando_us);
+        ev.fn(ev.arg);
+    }
+
+    if (alvo >= limite()) {
+        exit(0);
+    }
+}
+
+// No core 1 o tempo não é avançado: a thread dorme até o core 0 acordá-la
+static void esperar_ate(uint64_t alvo) {
+    pthread_mutex_lock(&relogio_mutex);
+    if (agora_us < alvo) {
+        core1_acordar_us = alvo;
+        core1_estado = CORE1_DORMINDO;
+        pthread_cond_broadcast(&relogio_cond);
+        while (core1_estado == CORE1_DORMINDO) {
+            pthread_cond_wait(&relogio_cond, &relogio_mutex);
+        }
+    }
+    pthread_mutex_unlock(&relogio_mutex);
+}
+
+void sleep_until(absolute_time_t t) {
+    if (sim_core_atual == 0) {
+        avancar_ate(t);
+    } else {
+        esperar_ate(t);
+    }
+}
+
+void sleep_us(uint64_t us) {
+    sleep_until(time_us_64() + us);
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us(ms * 1000ull);
+}
+
+void sim_consumir_us(uint64_t us) {
+    if (sim_core_atual == 0) {
+        avancar_ate(time_us_64() + us);
+    }
+}
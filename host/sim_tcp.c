@@ -0,0 +1,324 @@
+// sim_tcp.c - API raw TCP do lwIP sobre sockets do host
+//
+// Com BOTOSMART_SIM_HTTP_PORTA=n, quem escuta na porta 80 do nó (servidor_http.c) passa a
+// escutar em 127.0.0.1:n, e curl ou um navegador falam com a simulação como falariam com a
+// placa. Os callbacks rodam no core 0, num evento agendado a cada 5 ms, como rodariam no
+// contexto de fundo do lwIP. Sem a variável, as escutas existem mas nunca aceitam conexões.
+
+#include "sim.h"
+#include "lwip/tcp.h"
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define TCP_POLL_MS        5
+#define TCP_PCBS           5   // MEMP_NUM_TCP_PCB padrão do lwIP
+#define TCP_PCBS_ESCUTA    8   // MEMP_NUM_TCP_PCB_LISTEN
+#define TCP_DRENANDO       16
+#define TCP_DRENAR_MS      1000
+#define TCP_PORTA_HTTP     80
+
+typedef enum { PCB_LIVRE, PCB_NOVO, PCB_ESCUTA, PCB_CONECTADO } pcb_estado_t;
+
+struct tcp_pcb {
+    pcb_estado_t estado;
+    int sock;
+    u16_t porta;
+    void *arg;
+    tcp_accept_fn accept;
+    tcp_recv_fn recv;
+    tcp_sent_fn sent;
+    tcp_err_fn err;
+    tcp_poll_fn poll;
+    u8_t intervalo;
+    uint64_t proximo_poll_us;
+    uint32_t segmentos;
+    uint8_t tx[TCP_SND_BUF];
+    size_t tx_len;
+};
+
+const ip_addr_t ip_addr_any = {0};
+
+static int ativo = -1;
+static struct tcp_pcb pcbs[TCP_PCBS];
+static struct tcp_pcb escutas[TCP_PCBS_ESCUTA];
+
+// Depois do FIN, o socket fica descartando o que o cliente ainda mandar até ele fechar;
+// fechar direto com dados pendentes faria o host responder com RST e cortar a resposta
+static struct {
+    int sock;
+    uint64_t limite_us;
+} drenando[TCP_DRENANDO];
+static int num_drenando;
+
+static struct {
+    uint64_t conexoes;
+    uint64_t recusadas;
+    uint64_t segmentos;
+    uint64_t bytes;
+    uint64_t varios_segmentos; // conexões que precisaram de mais de um segmento de dados
+} contadores;
+
+bool sim_tcp_ativo(void) {
+    if (ativo < 0) ativo = sim_env_long("BOTOSMART_SIM_HTTP_PORTA", 0) > 0;
+    return ativo;
+}
+
+static void falhar(const char *o_que) {
+    fprintf(stderr, "[sim] tcp: %s\n", o_que);
+    exit(1);
+}
+
+static void relatorio(void) {
+    printf("[tcp] conexões %llu, recusadas %llu, segmentos %llu (%llu bytes), conexões com mais de um segmento %llu\n",
+           (unsigned long long)contadores.conexoes, (unsigned long long)contadores.recusadas,
+           (unsigned long long)contadores.segmentos, (unsigned long long)contadores.bytes,
+           (unsigned long long)contadores.varios_segmentos);
+}
+
+static struct tcp_pcb *alocar(struct tcp_pcb *pool, int n) {
+    for (int i = 0; i < n; i++) {
+        if (pool[i].estado == PCB_LIVRE) {
+            memset(&pool[i], 0, sizeof(pool[i]));
+            pool[i].estado = PCB_NOVO;
+            pool[i].sock = -1;
+            return &pool[i];
+        }
+    }
+    return NULL;
+}
+
+static void liberar(struct tcp_pcb *pcb) {
+    if (pcb->segmentos > 1) contadores.varios_segmentos++;
+    pcb->estado = PCB_LIVRE;
+    pcb->sock = -1;
+}
+
+static void drenar(int sock) {
+    shutdown(sock, SHUT_WR);
+    if (num_drenando == TCP_DRENANDO) {
+        close(sock);
+        return;
+    }
+    drenando[num_drenando].sock = sock;
+    drenando[num_drenando].limite_us = time_us_64() + TCP_DRENAR_MS * 1000ull;
+    num_drenando++;
+}
+
+struct tcp_pcb *tcp_new(void) {
+    return alocar(pcbs, TCP_PCBS);
+}
+
+struct tcp_pcb *tcp_new_ip_type(u8_t type) {
+    (void)type;
+    return tcp_new();
+}
+
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port) {
+    (void)ipaddr;
+    if (pcb->estado != PCB_NOVO) return ERR_VAL;
+    pcb->porta = port;
+    return ERR_OK;
+}
+
+static void sondar(void *arg);
+
+struct tcp_pcb *tcp_listen_with_backlog(struct tcp_pcb *pcb, u8_t backlog) {
+    struct tcp_pcb *escuta = alocar(escutas, TCP_PCBS_ESCUTA);
+    if (!escuta) return NULL;
+    escuta->estado = PCB_ESCUTA;
+    escuta->porta = pcb->porta;
+    escuta->arg = pcb->arg;
+    liberar(pcb);
+
+    if (!sim_tcp_ativo() || escuta->porta != TCP_PORTA_HTTP) return escuta;
+    long porta = sim_env_long("BOTOSMART_SIM_HTTP_PORTA", 0);
+    escuta->sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    int um = 1;
+    setsockopt(escuta->sock, SOL_SOCKET, SO_REUSEADDR, &um, sizeof(um));
+    struct sockaddr_in end = {.sin_family = AF_INET, .sin_port = htons((uint16_t)porta),
+                              .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    if (escuta->sock < 0 || bind(escuta->sock, (struct sockaddr *)&end, sizeof(end)) != 0 ||
+        listen(escuta->sock, backlog) != 0) {
+        falhar("não foi possível escutar na porta do host");
+    }
+    printf("[sim] porta %u do nó em 127.0.0.1:%ld\n", escuta->porta, porta);
+
+    static bool iniciado;
+    if (!iniciado) {
+        iniciado = true;
+        sim_relatorio_registrar(relatorio);
+        sim_agendar_us(time_us_64() + TCP_POLL_MS * 1000ull, sondar, NULL);
+    }
+    return escuta;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg) { pcb->arg = arg; }
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept) { pcb->accept = accept; }
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv) { pcb->recv = recv; }
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent) { pcb->sent = sent; }
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err) { pcb->err = err; }
+void tcp_setprio(struct tcp_pcb *pcb, u8_t prio) { (void)pcb, (void)prio; }
+
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval) {
+    pcb->poll = poll;
+    pcb->intervalo = interval;
+    pcb->proximo_poll_us = time_us_64() + interval * 500000ull; // temporizador lento do lwIP
+}
+
+void tcp_recved(struct tcp_pcb *pcb, u16_t len) { (void)pcb, (void)len; }
+
+u16_t tcp_sndbuf(const struct tcp_pcb *pcb) {
+    return (u16_t)(TCP_SND_BUF - pcb->tx_len);
+}
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags) {
+    (void)apiflags; // sempre copia
+    if (pcb->estado != PCB_CONECTADO) return ERR_CONN;
+    if (len > tcp_sndbuf(pcb)) return ERR_MEM;
+    memcpy(pcb->tx + pcb->tx_len, dataptr, len);
+    pcb->tx_len += len;
+    return ERR_OK;
+}
+
+// Cada chamada manda o que está na fila, em segmentos de até TCP_MSS
+err_t tcp_output(struct tcp_pcb *pcb) {
+    if (pcb->estado != PCB_CONECTADO || !pcb->tx_len) return ERR_OK;
+    size_t enviados = 0;
+    while (enviados < pcb->tx_len) {
+        ssize_t n = send(pcb->sock, pcb->tx + enviados, pcb->tx_len - enviados, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break; // o cliente sumiu: o recv da próxima sondagem vê o erro
+        enviados += (size_t)n;
+    }
+    uint32_t segmentos = (uint32_t)((pcb->tx_len + TCP_MSS - 1) / TCP_MSS);
+    pcb->segmentos += segmentos;
+    contadores.segmentos += segmentos;
+    contadores.bytes += pcb->tx_len;
+    pcb->tx_len = 0;
+    return ERR_OK;
+}
+
+err_t tcp_close(struct tcp_pcb *pcb) {
+    if (pcb->estado == PCB_CONECTADO) {
+        tcp_output(pcb); // o FIN segue os dados ainda na fila
+        drenar(pcb->sock);
+    } else if (pcb->sock >= 0) {
+        close(pcb->sock);
+    }
+    liberar(pcb);
+    return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb) {
+    tcp_err_fn err = pcb->err;
+    void *arg = pcb->arg;
+    if (pcb->sock >= 0) {
+        struct linger rst = {.l_onoff = 1, .l_linger = 0};
+        setsockopt(pcb->sock, SOL_SOCKET, SO_LINGER, &rst, sizeof(rst));
+        close(pcb->sock);
+    }
+    liberar(pcb);
+    if (err) err(arg, ERR_ABRT);
+}
+
+u8_t pbuf_free(struct pbuf *p) {
+    free(p);
+    return 1;
+}
+
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset) {
+    if (offset >= p->tot_len) return 0;
+    if (len > p->tot_len - offset) len = (u16_t)(p->tot_len - offset);
+    memcpy(dataptr, (const uint8_t *)p->payload + offset, len);
+    return len;
+}
+
+static void aceitar(struct tcp_pcb *escuta) {
+    while (true) {
+        int sock = accept(escuta->sock, NULL, NULL); // bloqueante: recv usa MSG_DONTWAIT
+        if (sock < 0) return;
+        struct tcp_pcb *pcb = tcp_new();
+        if (!pcb || !escuta->accept) {
+            if (pcb) liberar(pcb);
+            contadores.recusadas++;
+            close(sock);
+            continue;
+        }
+        contadores.conexoes++;
+        pcb->estado = PCB_CONECTADO;
+        pcb->sock = sock;
+        pcb->porta = escuta->porta;
+        pcb->arg = escuta->arg;
+        if (escuta->accept(escuta->arg, pcb, ERR_OK) != ERR_OK) {
+            if (pcb->estado == PCB_CONECTADO) tcp_abort(pcb);
+            continue;
+        }
+        tcp_output(pcb);
+    }
+}
+
+// O que chega de um cliente; sem callback de recepção, o lwIP descarta e fecha no FIN
+static void receber(struct tcp_pcb *pcb) {
+    while (pcb->estado == PCB_CONECTADO) {
+        uint8_t buf[TCP_MSS];
+        ssize_t n = recv(pcb->sock, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            tcp_err_fn err = pcb->err;
+            void *arg = pcb->arg;
+            close(pcb->sock);
+            liberar(pcb);
+            if (err) err(arg, ERR_RST);
+            return;
+        }
+        struct pbuf *p = NULL;
+        if (n > 0) {
+            p = malloc(sizeof(*p) + (size_t)n);
+            *p = (struct pbuf){.payload = p + 1, .tot_len = (u16_t)n, .len = (u16_t)n};
+            memcpy(p->payload, buf, (size_t)n);
+        }
+        if (pcb->recv) {
+            pcb->recv(pcb->arg, pcb, p, ERR_OK);
+        } else {
+            if (p) pbuf_free(p);
+            else tcp_close(pcb);
+        }
+        if (pcb->estado == PCB_CONECTADO) tcp_output(pcb);
+        if (!n) return;
+    }
+}
+
+static void sondar(void *arg) {
+    (void)arg;
+    uint64_t agora = time_us_64();
+    for (int i = 0; i < TCP_PCBS_ESCUTA; i++) {
+        if (escutas[i].estado == PCB_ESCUTA && escutas[i].sock >= 0) aceitar(&escutas[i]);
+    }
+    for (int i = 0; i < TCP_PCBS; i++) {
+        struct tcp_pcb *pcb = &pcbs[i];
+        if (pcb->estado != PCB_CONECTADO) continue;
+        receber(pcb);
+        if (pcb->estado == PCB_CONECTADO && pcb->poll && pcb->intervalo && agora >= pcb->proximo_poll_us) {
+            pcb->proximo_poll_us = agora + pcb->intervalo * 500000ull;
+            pcb->poll(pcb->arg, pcb);
+            if (pcb->estado == PCB_CONECTADO) tcp_output(pcb);
+        }
+    }
+    for (int i = 0; i < num_drenando;) {
+        char lixo[256];
+        ssize_t n = recv(drenando[i].sock, lixo, sizeof(lixo), MSG_DONTWAIT);
+        bool esperar = n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR));
+        if (esperar && agora < drenando[i].limite_us) {
+            i++;
+            continue;
+        }
+        close(drenando[i].sock);
+        drenando[i] = drenando[--num_drenando];
+    }
+    sim_agendar_us(agora + TCP_POLL_MS * 1000ull, sondar, NULL);
+}
@@ -0,0 +1,291 @@
+// sim_vl53l0x.c - VL53L0X simulado em nível de registrador
+//
+// Responde aos acessos que o driver faz (0x00 SYSRANGE_START, 0x0B SYSTEM_INTERRUPT_CLEAR,
+// 0x13 RESULT_INTERRUPT_STATUS, bloco de resultado 0x14..0x1F, 0x88, identificação 0xC0..0xC2)
+// com ponteiro de registrador auto-incrementado, como o chip real. O resultado só fica
+// pronto depois do tempo de medição; a distância vem de um traço CSV interpolado, com ruído
+// gaussiano e códigos de status do próprio traço ("sem alvo", falha de sinal etc.). Falha de
+// sinal devolve 8190 mm; as outras falhas devolvem uma distância plausível que não é do alvo.
+
+#include "sim_vl53l0x.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REG_SYSRANGE_START          0x00
+#define REG_SYSTEM_INTERRUPT_CLEAR  0x0B
+#define REG_RESULT_INTERRUPT_STATUS 0x13
+#define REG_RESULT_RANGE_STATUS     0x14
+
+#define STATUS_FAIXA_VALIDA 11
+#define STATUS_FALHA_SINAL  4
+#define STATUS_FALHA_FASE   6
+#define DISTANCIA_SEM_ALVO  8190
+#define SIM_VL53L0X_MAX     8
+
+typedef struct {
+    double t_s;
+    double distancia_mm;
+    uint8_t status;
+    bool evento;
+} ponto_traco_t;
+
+typedef struct {
+    uint8_t regs[256];
+    uint8_t ponteiro;
+
+    bool medindo;
+    bool continuo;
+    uint64_t fim_medicao_us;
+    uint64_t medicoes;
+
+    ponto_traco_t *traco;
+    size_t num_pontos;
+    double velocidade;
+    uint16_t distancia_fixa_mm;
+    double ruido_mm;
+    long falhas_ppm;
+    long espurias_ppm;
+    double ambiente_mcps;
+    uint32_t medicao_us;
+    unsigned int semente;
+} vl53l0x_sim_t;
+
+// Todos os sensores seguem o mesmo traço, cada um com o seu ruído; o primeiro é a referência
+static vl53l0x_sim_t sensores[SIM_VL53L0X_MAX];
+static int num_sensores;
+
+// --- Traço ---
+
+static bool carregar_traco(vl53l0x_sim_t *s, const char *caminho) {
+    FILE *f = fopen(caminho, "r");
+    if (!f) {
+        fprintf(stderr, "[sim] não foi possível abrir o traço %s\n", caminho);
+        return false;
+    }
+    size_t capacidade = 1024;
+    s->traco = malloc(capacidade * sizeof(ponto_traco_t));
+    char linha[128];
+    while (fgets(linha, sizeof(linha), f)) {
+        ponto_traco_t p = {0, 0, STATUS_FAIXA_VALIDA, false};
+        int status = STATUS_FAIXA_VALIDA, evento = 0;
+        if (sscanf(linha, "%lf,%lf,%d,%d", &p.t_s, &p.distancia_mm, &status, &evento) < 2) {
+            continue; // cabeçalho ou linha inválida
+        }
+        p.status = (uint8_t)status;
+        p.evento = evento != 0;
+        if (s->num_pontos == capacidade) {
+            capacidade *= 2;
+            s->traco = realloc(s->traco, capacidade * sizeof(ponto_traco_t));
+        }
+        s->traco[s->num_pontos++] = p;
+    }
+    fclose(f);
+    return s->num_pontos > 0;
+}
+
+// Índice do último ponto com t <= t_s
+static size_t ponto_em(const vl53l0x_sim_t *s, double t_s) {
+    size_t ini = 0, fim = s->num_pontos;
+    while (fim - ini > 1) {
+        size_t meio = (ini + fim) / 2;
+        if (s->traco[meio].t_s <= t_s) ini = meio;
+        else fim = meio;
+    }
+    return ini;
+}
+
+static double tempo_traco(uint64_t t_us) {
+    return (t_us / 1e6) * sensores[0].velocidade;
+}
+
+bool sim_vl53l0x_evento_ativo(uint64_t t_us) {
+    const vl53l0x_sim_t *s = &sensores[0];
+    if (s->num_pontos == 0) return false;
+    return s->traco[ponto_em(s, tempo_traco(t_us))].evento;
+}
+
+bool sim_vl53l0x_sem_alvo(uint64_t t_us) {
+    const vl53l0x_sim_t *s = &sensores[0];
+    if (s->num_pontos == 0) return false;
+    return s->traco[ponto_em(s, tempo_traco(t_us))].status != STATUS_FAIXA_VALIDA;
+}
+
+bool sim_vl53l0x_traco_terminou(uint64_t t_us) {
+    const vl53l0x_sim_t *s = &sensores[0];
+    return s->num_pontos > 0 && tempo_traco(t_us) > s->traco[s->num_pontos - 1].t_s;
+}
+
+// --- Modelo de medição ---
+
+static double gaussiana(unsigned int *semente) {
+    double u1 = (rand_r(semente) + 1.0) / (RAND_MAX + 2.0);
+    double u2 = (rand_r(semente) + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// Taxas em MCPS no formato 9.7 usado pelo chip
+static uint16_t mcps_9_7(double mcps) {
+    if (mcps < 0) mcps = 0;
+    if (mcps > 511) mcps = 511;
+    return (uint16_t)(mcps * 128.0 + 0.5);
+}
+
+static void escrever16(uint8_t *regs, uint8_t reg, uint16_t valor) {
+    regs[reg] = valor >> 8;
+    regs[reg + 1] = valor & 0xFF;
+}
+
+static void concluir_medicao(vl53l0x_sim_t *s, uint64_t t_us) {
+    double distancia = s->distancia_fixa_mm;
+    uint8_t status = STATUS_FAIXA_VALIDA;
+
+    if (s->num_pontos) {
+        double t = tempo_traco(t_us);
+        size_t i = ponto_em(s, t);
+        const ponto_traco_t *a = &s->traco[i];
+        distancia = a->distancia_mm;
+        status = a->status;
+        // Só interpola entre pontos válidos: um ponto sem alvo não deve virar rampa
+        if (i + 1 < s->num_pontos && t > a->t_s && s->traco[i + 1].status == a->status) {
+            const ponto_traco_t *b = &s->traco[i + 1];
+            distancia += (b->distancia_mm - a->distancia_mm) * (t - a->t_s) / (b->t_s - a->t_s);
+        }
+    }
+
+    if (s->falhas_ppm && (unsigned long)rand_r(&s->semente) % 1000000 < (unsigned long)s->falhas_ppm) {
+        status = STATUS_FALHA_SINAL;
+    }
+    if (s->espurias_ppm && status == STATUS_FAIXA_VALIDA &&
+        (unsigned long)rand_r(&s->semente) % 1000000 < (unsigned long)s->espurias_ppm) {
+        status = STATUS_FALHA_FASE;
+    }
+
+    uint16_t medida;
+    double sinal_mcps, ambiente_mcps = s->ambiente_mcps + 0.05 * gaussiana(&s->semente);
+    if (status == STATUS_FAIXA_VALIDA) {
+        distancia += s->ruido_mm * gaussiana(&s->semente);
+        if (distancia < 0) distancia = 0;
+        medida = (uint16_t)(distancia + 0.5);
+        // Retorno cai com o quadrado da distância (alvo de água, refletância baixa)
+        double d = distancia < 30 ? 30 : distancia;
+        sinal_mcps = 2.0e5 / (d * d);
+    } else if (status == STATUS_FALHA_SINAL) {
+        medida = DISTANCIA_SEM_ALVO;
+        sinal_mcps = 0.05;
+    } else {
+        medida = (uint16_t)(50 + rand_r(&s->semente) % 1200);
+        sinal_mcps = 0.15;
+    }
+
+    s->regs[REG_RESULT_RANGE_STATUS] = (uint8_t)(status << 3) | 0x01;
+    escrever16(s->regs, 0x16, 0x0800);               // SPADs efetivos (8.8)
+    escrever16(s->regs, 0x1A, mcps_9_7(sinal_mcps));  // taxa de sinal
+    escrever16(s->regs, 0x1C, mcps_9_7(ambiente_mcps));
+    escrever16(s->regs, 0x1E, medida);
+    s->regs[REG_RESULT_INTERRUPT_STATUS] = 0x04;     // nova amostra pronta
+    s->medicoes++;
+}
+
+static void iniciar_medicao(vl53l0x_sim_t *s, uint64_t agora) {
+    s->medindo = true;
+    s->fim_medicao_us = agora + s->medicao_us;
+    s->regs[REG_RESULT_RANGE_STATUS] &= ~0x01;
+}
+
+// Atualiza o banco de registradores até o instante atual (a medição é avaliada sob demanda)
+static void atualizar(vl53l0x_sim_t *s) {
+    uint64_t agora = time_us_64();
+    while (s->medindo && agora >= s->fim_medicao_us) {
+        uint64_t fim = s->fim_medicao_us;
+        concluir_medicao(s, fim);
+        s->medindo = false;
+        if (s->continuo) {
+            s->medindo = true;
+            s->fim_medicao_us = fim + s->medicao_us;
+        }
+    }
+}
+
+static void escrever_registrador(vl53l0x_sim_t *s, uint8_t reg, uint8_t valor) {
+    s->regs[reg] = valor;
+    switch (reg) {
+        case REG_SYSRANGE_START:
+            if (valor & 0x01) {
+                s->continuo = (valor & 0x02) != 0;
+                iniciar_medicao(s, time_us_64());
+                s->regs[REG_SYSRANGE_START] = valor & ~0x01; // bit de início é auto-limpante
+            } else if (valor == 0x00) {
+                s->continuo = false;
+            }
+            break;
+        case REG_SYSTEM_INTERRUPT_CLEAR:
+            if (valor & 0x01) s->regs[REG_RESULT_INTERRUPT_STATUS] = 0;
+            s->regs[reg] = 0;
+            break;
+    }
+}
+
+static int vl53l0x_sim_escrever(void *ctx, const uint8_t *buf, size_t len, bool nostop) {
+    vl53l0x_sim_t *s = ctx;
+    (void)nostop;
+    if (len == 0) return 0;
+    atualizar(s);
+    s->ponteiro = buf[0];
+    for (size_t i = 1; i < len; i++) {
+        escrever_registrador(s, s->ponteiro++, buf[i]);
+    }
+    return (int)len;
+}
+
+static int vl53l0x_sim_ler(void *ctx, uint8_t *buf, size_t len, bool nostop) {
+    vl53l0x_sim_t *s = ctx;
+    (void)nostop;
+    atualizar(s);
+    for (size_t i = 0; i < len; i++) buf[i] = s->regs[s->ponteiro++];
+    return (int)len;
+}
+
+static void relatorio_vl53l0x(void) {
+    if (num_sensores == 1) {
+        printf("[vl53l0x] %llu medições simuladas\n", (unsigned long long)sensores[0].medicoes);
+        return;
+    }
+    for (int i = 0; i < num_sensores; i++) {
+        printf("[vl53l0x %d] %llu medições simuladas\n", i, (unsigned long long)sensores[i].medicoes);
+    }
+}
+
+void sim_vl53l0x_conectar(uint barramento, uint8_t endereco) {
+    if (num_sensores == SIM_VL53L0X_MAX) return;
+    vl53l0x_sim_t *s = &sensores[num_sensores++];
+    memset(s, 0, sizeof(*s));
+
+    s->regs[0xC0] = 0xEE; // IDENTIFICATION_MODEL_ID
+    s->regs[0xC1] = 0xAA;
+    s->regs[0xC2] = 0x10; // IDENTIFICATION_REVISION_ID
+    s->regs[0x8A] = endereco;
+
+    s->distancia_fixa_mm = (uint16_t)sim_env_long("BOTOSMART_SIM_DISTANCIA_MM", 500);
+    s->medicao_us = (uint32_t)sim_env_long("BOTOSMART_SIM_VL53_MEDICAO_US", 33000);
+    s->ruido_mm = (double)sim_env_long("BOTOSMART_SIM_VL53_RUIDO_MM", 4);
+    s->falhas_ppm = sim_env_long("BOTOSMART_SIM_VL53_FALHAS_PPM", 0);
+    s->espurias_ppm = sim_env_long("BOTOSMART_SIM_VL53_ESPURIAS_PPM", 0);
+    s->ambiente_mcps = sim_env_long("BOTOSMART_SIM_VL53_AMBIENTE_KCPS", 250) / 1000.0;
+    s->velocidade = (double)sim_env_long("BOTOSMART_SIM_VELOCIDADE", 1);
+    s->semente = (unsigned int)num_sensores;
+
+    const char *traco = getenv("BOTOSMART_SIM_TRACO");
+    if (s != &sensores[0]) {
+        s->traco = sensores[0].traco;
+        s->num_pontos = sensores[0].num_pontos;
+    } else if (traco && *traco) {
+        if (!carregar_traco(s, traco)) exit(1);
+        printf("[sim] traço %s: %zu pontos, %.0f s a %.0fx\n", traco, s->num_pontos,
+               s->traco[s->num_pontos - 1].t_s, s->velocidade);
+    }
+
+    sim_i2c_dispositivo_t d = {"vl53l0x", vl53l0x_sim_escrever, vl53l0x_sim_ler, s};
+    sim_i2c_conectar(barramento, endereco, &d);
+    if (s == &sensores[0]) sim_relatorio_registrar(relatorio_vl53l0x);
+}
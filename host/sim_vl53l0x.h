@@ -0,0 +1,26 @@
+// sim_vl53l0x.h - VL53L0X simulado em nível de registrador, alimentado por traços CSV
+
+#ifndef SIM_VL53L0X_H
+#define SIM_VL53L0X_H
+
+#include "sim.h"
+
+// Liga o sensor simulado ao barramento. Variáveis de ambiente:
+//   BOTOSMART_SIM_TRACO          CSV "t_s,distancia_mm,status,evento" (sem ele, distância fixa)
+//   BOTOSMART_SIM_DISTANCIA_MM   distância fixa quando não há traço (padrão 500)
+//   BOTOSMART_SIM_VELOCIDADE     segundos de traço por segundo simulado (padrão 1)
+//   BOTOSMART_SIM_VL53_MEDICAO_US tempo de medição (timing budget, padrão 33000)
+//   BOTOSMART_SIM_VL53_RUIDO_MM  desvio padrão do ruído gaussiano (padrão 4)
+//   BOTOSMART_SIM_VL53_FALHAS_PPM leituras "sem alvo" espúrias por milhão (padrão 0)
+void sim_vl53l0x_conectar(uint barramento, uint8_t endereco);
+
+// Verdade de referência do traço no instante virtual 't_us' (coluna "evento")
+bool sim_vl53l0x_evento_ativo(uint64_t t_us);
+
+// true se o traço, no instante virtual 't_us', está num trecho com status de falha (sem alvo)
+bool sim_vl53l0x_sem_alvo(uint64_t t_us);
+
+// true quando há traço carregado e ele já terminou
+bool sim_vl53l0x_traco_terminou(uint64_t t_us);
+
+#endif
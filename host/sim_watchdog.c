@@ -0,0 +1,51 @@
+// sim_watchdog.c - Watchdog e reinício: a simulação termina e quem a chamou roda de novo
+// (com a mesma BOTOSMART_SIM_FLASH, o novo "boot" vê o que foi gravado)
+
+#include "sim.h"
+#include "hardware/watchdog.h"
+#include <stdlib.h>
+
+static bool ligado;
+static uint32_t periodo_ms;
+static uint64_t vence_us;
+static bool verificacao_agendada;
+
+void watchdog_reboot(uint32_t pc, uint32_t sp, uint32_t delay_ms) {
+    (void)pc;
+    (void)sp;
+    sleep_ms(delay_ms);
+    printf("[sim] reinício em t=%.3f s\n", time_us_64() / 1e6);
+    fflush(stdout);
+    exit(SIM_CODIGO_REINICIO);
+}
+
+static void verificar(void *arg) {
+    (void)arg;
+    verificacao_agendada = false;
+    if (!ligado) return;
+    if (time_us_64() >= vence_us) {
+        printf("[sim] watchdog venceu\n");
+        watchdog_reboot(0, 0, 0);
+    }
+    verificacao_agendada = true;
+    sim_agendar_us(vence_us, verificar, NULL);
+}
+
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug) {
+    (void)pause_on_debug;
+    ligado = true;
+    periodo_ms = delay_ms;
+    watchdog_update();
+    if (!verificacao_agendada) {
+        verificacao_agendada = true;
+        sim_agendar_us(vence_us, verificar, NULL);
+    }
+}
+
+void watchdog_disable(void) {
+    ligado = false;
+}
+
+void watchdog_update(void) {
+    vence_us = time_us_64() + periodo_ms * 1000ull;
+}
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Gera os traços de nível d'água usados pelo VL53L0X simulado (host/sim_vl53l0x.c).
+
+Formato: t_s,distancia_mm,status,evento
+  status  status interno de faixa do VL53L0X (11 = válido, 4 = falha de sinal/sem alvo)
+  evento  1 enquanto há alagamento de verdade (referência para latência e falsos alarmes)
+
+O limiar do firmware é DISTANCIA_LIMIAR_CM = 15 (150 mm): água mais perto que isso é alagamento.
+"""
+import math
+import os
+import random
+
+LIMIAR_MM = 150
+PASSO_S = 5
+
+
+def escrever(nome, pontos):
+    caminho = os.path.join(os.path.dirname(os.path.abspath(__file__)), nome)
+    with open(caminho, "w") as f:
+        f.write("t_s,distancia_mm,status,evento\n")
+        for t, d, status, evento in pontos:
+            f.write(f"{t},{d:.0f},{status},{evento}\n")
+
+
+def cheia():
+    """Rio sobe devagar, passa do limiar por ~40 min e baixa; duas cheias em 6 h."""
+    rnd = random.Random(1)
+    pontos = []
+    for t in range(0, 6 * 3600 + 1, PASSO_S):
+        d = 600
+        for pico_s in (2 * 3600, 4.5 * 3600):
+            d -= 520 * math.exp(-((t - pico_s) / 1500.0) ** 2)
+        evento = int(d < LIMIAR_MM)  # referência pelo nível médio, sem as ondas
+        d += rnd.gauss(0, 3)  # ondas lentas; o ruído do sensor é somado pelo simulador
+        pontos.append((t, d, 11, evento))
+    escrever("cheia.csv", pontos)
+
+
+def ondulacao():
+    """Nível alto e agitado perto do limiar, mas sem alagamento: mede falsos alarmes."""
+    rnd = random.Random(2)
+    pontos = []
+    for t in range(0, 4 * 3600 + 1, PASSO_S):
+        d = 200 + 25 * math.sin(2 * math.pi * t / 40.0) + rnd.gauss(0, 8)
+        status = 11
+        if rnd.random() < 0.01:  # espuma/respingo: leitura sem alvo
+            status, d = 4, 8190
+        pontos.append((t, d, status, 0))
+    escrever("ondulacao.csv", pontos)
+
+
+def obstrucao():
+    """Detrito/teia na frente do sensor: degrau para 40 mm por 10 min, sem alagamento."""
+    rnd = random.Random(3)
+    pontos = []
+    for t in range(0, 3 * 3600 + 1, PASSO_S):
+        d = 550 + rnd.gauss(0, 3)
+        if 3600 <= t < 3600 + 600:
+            d = 40 + rnd.gauss(0, 1)
+        if 7200 <= t < 7200 + 300:  # sensor sem retorno (lente suja/sem alvo)
+            pontos.append((t, 8190, 4, 0))
+            continue
+        pontos.append((t, d, 11, 0))
+    escrever("obstrucao.csv", pontos)
+
+
+if __name__ == "__main__":
+    cheia()
+    ondulacao()
+    obstrucao()
@@ -0,0 +1,159 @@
+// i2c_bus.c - Acesso ao I2C com latência limitada: timeouts, recuperação do barramento e contadores
+
+#include "config.h"
+#include "i2c_bus.h"
+#include "metricas.h"
+#include "registro.h"
+
+// Tempo de barramento de uma transação: 9 bits por byte (8 + ACK), mais o byte de endereço.
+// O timeout é o dobro disso mais uma margem fixa para clock stretching e latência de IRQ.
+static uint timeout_us(const i2c_dispositivo_t *dev, size_t len) {
+    uint64_t barramento_us = ((uint64_t)(len + 1) * 9 * 1000000u) / dev->baudrate;
+    return (uint)(2 * barramento_us + I2C_TIMEOUT_MARGEM_US);
+}
+
+void i2c_bus_iniciar(i2c_dispositivo_t *dev) {
+    if (dev->pio) {
+        // As transações falham (NACK) até haver máquina de estados e DMA: o erro aparece nos contadores.
+        // Também roda na recuperação, dentro da IRQ do sensor: nada de printf aqui
+        if (!pio_i2c_iniciar(dev->pio, dev->sda_pin, dev->scl_pin, dev->baudrate)) {
+            REGISTRAR(I2C_SEM_PIO, dev->sda_pin, dev->scl_pin);
+        }
+        return;
+    }
+    i2c_init(dev->porta, dev->baudrate);
+    gpio_set_function(dev->sda_pin, GPIO_FUNC_I2C); gpio_pull_up(dev->sda_pin);
+    gpio_set_function(dev->scl_pin, GPIO_FUNC_I2C); gpio_pull_up(dev->scl_pin);
+}
+
+// Contabiliza o resultado e decide se o barramento precisa ser recuperado.
+// NACK isolado é normal (sensor ocupado, desconectado); timeout indica SDA/SCL presos.
+static int concluir(i2c_dispositivo_t *dev, int r, uint32_t inicio_us) {
+    metricas_registrar_us(METRICA_I2C_US, time_us_32() - inicio_us);
+    metricas_incrementar(METRICA_I2C_TRANSACOES);
+    dev->contadores.transacoes++;
+    if (r >= 0) {
+        dev->falhas_seguidas = 0;
+        return r;
+    }
+
+    if (r == PICO_ERROR_TIMEOUT) {
+        dev->contadores.timeouts++;
+        metricas_incrementar(METRICA_I2C_TIMEOUTS);
+    } else {
+        dev->contadores.nacks++;
+        metricas_incrementar(METRICA_I2C_NACKS);
+    }
+
+    if (r == PICO_ERROR_TIMEOUT || ++dev->falhas_seguidas >= I2C_FALHAS_PARA_RECUPERAR) {
+        i2c_bus_recuperar(dev);
+    }
+    return r;
+}
+
+// Transação no PIO, esperando até o fim; tx e rx na mesma transação, com START repetido
+static int pio_transferir(i2c_dispositivo_t *dev, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len,
+                          bool nostop) {
+    uint32_t timeout = timeout_us(dev, tx_len + rx_len + (tx_len && rx_len));
+    if (!pio_i2c_disparar(dev->pio, dev->endereco, tx, tx_len, rx, rx_len, nostop)) return PICO_ERROR_GENERIC;
+    return pio_i2c_concluir(dev->pio, make_timeout_time_us(timeout));
+}
+
+int i2c_bus_escrever(i2c_dispositivo_t *dev, const uint8_t *buf, size_t len, bool nostop) {
+    uint32_t inicio_us = time_us_32();
+    int r = dev->pio ? pio_transferir(dev, buf, len, NULL, 0, nostop)
+                     : i2c_write_timeout_us(dev->porta, dev->endereco, buf, len, nostop, timeout_us(dev, len));
+    return concluir(dev, r, inicio_us);
+}
+
+int i2c_bus_ler(i2c_dispositivo_t *dev, uint8_t *buf, size_t len, bool nostop) {
+    uint32_t inicio_us = time_us_32();
+    int r = dev->pio ? pio_transferir(dev, NULL, 0, buf, len, nostop)
+                     : i2c_read_timeout_us(dev->porta, dev->endereco, buf, len, nostop, timeout_us(dev, len));
+    return concluir(dev, r, inicio_us);
+}
+
+bool i2c_bus_ler_registradores(i2c_dispositivo_t *dev, uint8_t reg, uint8_t *buf, size_t len) {
+    if (dev->pio) {
+        uint32_t inicio_us = time_us_32();
+        return concluir(dev, pio_transferir(dev, &reg, 1, buf, len, false), inicio_us) == (int)len;
+    }
+    if (i2c_bus_escrever(dev, &reg, 1, true) != 1) return false;
+    return i2c_bus_ler(dev, buf, len, false) == (int)len;
+}
+
+// Dispara a transação de um dispositivo de i2c_bus_*_todos(). Na porta de hardware ela roda
+// aqui mesmo, enquanto as do PIO já disparadas correm por DMA.
+static void disparar(i2c_dispositivo_t *dev, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len) {
+    dev->inicio_us = time_us_32();
+    dev->esperado = (int)(rx_len ? rx_len : tx_len);
+    if (dev->pio) {
+        dev->resultado = pio_i2c_disparar(dev->pio, dev->endereco, tx, tx_len, rx, rx_len, false) ? 0 : PICO_ERROR_GENERIC;
+    } else if (rx_len) {
+        dev->resultado = i2c_bus_ler_registradores(dev, tx[0], rx, rx_len) ? (int)rx_len : PICO_ERROR_GENERIC;
+    } else {
+        dev->resultado = i2c_bus_escrever(dev, tx, tx_len, false);
+    }
+}
+
+static bool esperar(i2c_dispositivo_t *dev, size_t len) {
+    if (!dev->pio) return dev->resultado == dev->esperado; // já contabilizada
+    int r = dev->resultado;
+    if (r == 0) { // o prazo conta desde o disparo
+        uint32_t decorrido = time_us_32() - dev->inicio_us, prazo = timeout_us(dev, len);
+        r = pio_i2c_concluir(dev->pio, make_timeout_time_us(decorrido < prazo ? prazo - decorrido : 0));
+    }
+    return concluir(dev, r, dev->inicio_us) == dev->esperado;
+}
+
+void i2c_bus_escrever_todos(i2c_dispositivo_t *const *devs, size_t n, const uint8_t *buf, size_t len, bool *ok) {
+    for (int pio = 1; pio >= 0; pio--) { // PIO primeiro: correm durante as de hardware
+        for (size_t i = 0; i < n; i++) {
+            if ((devs[i]->pio != NULL) == pio) disparar(devs[i], buf, len, NULL, 0);
+        }
+    }
+    for (size_t i = 0; i < n; i++) ok[i] = esperar(devs[i], len);
+}
+
+void i2c_bus_ler_registradores_todos(i2c_dispositivo_t *const *devs, size_t n, uint8_t reg, uint8_t *bufs,
+                                     size_t len, bool *ok) {
+    for (int pio = 1; pio >= 0; pio--) {
+        for (size_t i = 0; i < n; i++) {
+            if ((devs[i]->pio != NULL) == pio) disparar(devs[i], &reg, 1, bufs + i * len, len);
+        }
+    }
+    for (size_t i = 0; i < n; i++) ok[i] = esperar(devs[i], len + 2);
+}
+
+// Pinos em dreno aberto: nível baixo = saída em 0, nível alto = entrada (pull-up solta a linha)
+static inline void linha(uint pino, bool alto) {
+    gpio_set_dir(pino, alto ? GPIO_IN : GPIO_OUT);
+}
+
+void i2c_bus_recuperar(i2c_dispositivo_t *dev) {
+    uint meio_periodo_us = 500000u / dev->baudrate + 1;
+
+    if (dev->pio) pio_i2c_parar(dev->pio);
+    else i2c_deinit(dev->porta);
+    gpio_init(dev->sda_pin); gpio_pull_up(dev->sda_pin); gpio_put(dev->sda_pin, 0);
+    gpio_init(dev->scl_pin); gpio_pull_up(dev->scl_pin); gpio_put(dev->scl_pin, 0);
+    linha(dev->sda_pin, true);
+    linha(dev->scl_pin, true);
+    busy_wait_us_32(meio_periodo_us); // sem sleep: o sensor é lido de dentro de uma IRQ
+
+    // Um escravo preso no meio de um byte solta SDA em no máximo 9 clocks
+    for (int i = 0; i < 9 && !gpio_get(dev->sda_pin); i++) {
+        linha(dev->scl_pin, false); busy_wait_us_32(meio_periodo_us);
+        linha(dev->scl_pin, true);  busy_wait_us_32(meio_periodo_us);
+    }
+
+    // STOP: SDA sobe com SCL em nível alto
+    linha(dev->scl_pin, false); linha(dev->sda_pin, false); busy_wait_us_32(meio_periodo_us);
+    linha(dev->scl_pin, true);  busy_wait_us_32(meio_periodo_us);
+    linha(dev->sda_pin, true);  busy_wait_us_32(meio_periodo_us);
+
+    i2c_bus_iniciar(dev);
+    dev->falhas_seguidas = 0;
+    dev->contadores.recuperacoes++;
+    metricas_incrementar(METRICA_I2C_RECUPERACOES);
+}
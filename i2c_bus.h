@@ -0,0 +1,95 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "hardware/i2c.h"
+#include "pio_i2c.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t transacoes;
+    uint32_t nacks;
+    uint32_t timeouts;
+    uint32_t recuperacoes;
+} i2c_bus_contadores_t;
+
+/**
+ * @brief Um dispositivo em um barramento I2C: porta, endereço e pinos do barramento,
+ *        mais os contadores de erro daquele dispositivo.
+ *
+ * Com pio preenchido, o barramento é um mestre no PIO (pio_i2c.c) nos pinos do dispositivo
+ * (SCL = SDA + 1) e porta é ignorada: o RP2040 só tem dois blocos I2C, e o PIO dá um
+ * barramento a mais para cada máquina de estados livre.
+ */
+typedef struct {
+    i2c_inst_t *porta;
+    uint8_t endereco;
+    uint sda_pin;
+    uint scl_pin;
+    uint baudrate;
+    i2c_bus_contadores_t contadores;
+    uint8_t falhas_seguidas;
+    pio_i2c_t *pio;       // NULL = bloco I2C de hardware em porta
+    // Transação disparada por i2c_bus_*_todos() e ainda não concluída
+    int esperado;
+    int resultado;        // porta de hardware: a transação já aconteceu no disparo
+    uint32_t inicio_us;
+} i2c_dispositivo_t;
+
+/**
+ * @brief Inicializa a porta I2C (ou a máquina de estados do PIO) e os pinos do dispositivo
+ *        (com pull-up).
+ */
+void i2c_bus_iniciar(i2c_dispositivo_t *dev);
+
+/**
+ * @brief Escreve no dispositivo com timeout proporcional ao tamanho da transação.
+ *        Em timeout o barramento é recuperado antes de retornar.
+ * @return Bytes escritos ou PICO_ERROR_GENERIC (NACK) / PICO_ERROR_TIMEOUT.
+ */
+int i2c_bus_escrever(i2c_dispositivo_t *dev, const uint8_t *buf, size_t len, bool nostop);
+
+/**
+ * @brief Lê do dispositivo, com as mesmas regras de timeout e recuperação da escrita.
+ */
+int i2c_bus_ler(i2c_dispositivo_t *dev, uint8_t *buf, size_t len, bool nostop);
+
+/**
+ * @brief Escreve o endereço do registrador e lê len bytes a partir dele.
+ *        No PIO as duas partes vão numa transação só, com START repetido.
+ * @return true se as duas transações completaram.
+ */
+bool i2c_bus_ler_registradores(i2c_dispositivo_t *dev, uint8_t reg, uint8_t *buf, size_t len);
+
+/**
+ * @brief i2c_bus_escrever() em n dispositivos de uma vez. Os que estão no PIO transferem todos
+ *        ao mesmo tempo, por DMA, enquanto os de porta de hardware são atendidos um a um;
+ *        o tempo total é o do barramento mais lento, não a soma.
+ *
+ * @param ok Recebe, por dispositivo, se a escrita completou.
+ */
+void i2c_bus_escrever_todos(i2c_dispositivo_t *const *devs, size_t n, const uint8_t *buf, size_t len, bool *ok);
+
+/**
+ * @brief i2c_bus_ler_registradores() em n dispositivos de uma vez, como i2c_bus_escrever_todos().
+ *
+ * @param bufs n blocos consecutivos de len bytes, um por dispositivo.
+ */
+void i2c_bus_ler_registradores_todos(i2c_dispositivo_t *const *devs, size_t n, uint8_t reg, uint8_t *bufs,
+                                     size_t len, bool *ok);
+
+/**
+ * @brief Libera um barramento travado: até 9 pulsos em SCL até o escravo soltar SDA,
+ *        condição de STOP e reinicialização da porta.
+ */
+void i2c_bus_recuperar(i2c_dispositivo_t *dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,164 @@
+// intertravamento.c - Relé e LEDs decididos a cada leitura, numa IRQ de timer, sem passar pela rede
+
+#include "config.h"
+#include "energia.h"
+#include "intertravamento.h"
+#include "metricas.h"
+#include "monitor.h"
+#include "mqtt_config.h"
+#include "registro.h"
+
+typedef struct {
+    uint16_t distancia_mm;
+    uint8_t qualidade;
+    uint16_t descartadas; // leituras reprovadas entre a anterior na fila e esta
+    uint32_t t_ms;
+} amostra_t;
+
+// Filas com um produtor (a IRQ) e um consumidor (o laço principal), os dois no core 0: a IRQ
+// só avança 'escrita' e o laço só avança 'leitura'; cheia, a IRQ descarta o item novo.
+static struct {
+    repeating_timer_t timer;
+    volatile bool acionado;
+    uint8_t confirmacoes; // leituras seguidas do lado oposto ao estado atual
+    uint16_t descartadas; // reprovadas desde a última amostra enfileirada
+    volatile uint16_t ultima_mm;
+    uint32_t ultima_us;   // instante da última leitura aprovada
+    volatile bool sem_leitura;
+
+    amostra_t amostras[INTERTRAVAMENTO_FILA_AMOSTRAS];
+    volatile uint32_t amostras_escrita, amostras_leitura;
+
+    intertravamento_registro_t registros[INTERTRAVAMENTO_FILA_REGISTROS];
+    volatile uint32_t registros_escrita, registros_leitura;
+} it;
+
+bool intertravamento_avaliar(uint16_t distancia_mm) {
+    bool oposta = it.acionado ? distancia_mm > INTERTRAVAMENTO_DESLIGA_MM : distancia_mm < INTERTRAVAMENTO_LIGA_MM;
+    if (!oposta) {
+        it.confirmacoes = 0;
+        return false;
+    }
+    if (++it.confirmacoes < INTERTRAVAMENTO_CONFIRMACOES) return false;
+
+    it.confirmacoes = 0;
+    it.acionado = !it.acionado;
+    monitor_acionar_saidas(it.acionado);
+    return true;
+}
+
+bool intertravamento_acionado() {
+    return it.acionado;
+}
+
+bool intertravamento_flash_liberada() {
+    return !it.acionado && !it.sem_leitura && it.ultima_mm > INTERTRAVAMENTO_DESLIGA_MM + INTERTRAVAMENTO_FOLGA_FLASH_MM;
+}
+
+static void registrar(uint16_t distancia_mm, uint32_t inicio_us) {
+    uint32_t atraso_us = time_us_32() - inicio_us;
+    if (it.registros_escrita - it.registros_leitura == INTERTRAVAMENTO_FILA_REGISTROS) return;
+    it.registros[it.registros_escrita % INTERTRAVAMENTO_FILA_REGISTROS] = (intertravamento_registro_t){
+        .t_ms = to_ms_since_boot(get_absolute_time()),
+        .distancia_mm = distancia_mm,
+        .atraso_us = (uint16_t)(atraso_us > UINT16_MAX ? UINT16_MAX : atraso_us),
+        .acionado = it.acionado,
+        .sem_leitura = it.sem_leitura,
+    };
+    __compiler_memory_barrier(); // o registro fica completo antes de o índice aparecer
+    it.registros_escrita++;
+}
+
+static bool ao_tick(repeating_timer_t *timer) {
+    (void)timer;
+    uint32_t inicio_us = time_us_32();
+    uint16_t distancia;
+    uint8_t qualidade;
+    monitor_amostra_t r = monitor_coletar_amostra(&distancia, &qualidade);
+
+    // Sensor mudo, reprovando tudo ou fora do barramento: o nível é desconhecido
+    if (r != MONITOR_AMOSTRA_VALIDA && !it.sem_leitura &&
+        inicio_us - it.ultima_us >= INTERTRAVAMENTO_SEM_LEITURA_MS * 1000u) {
+        it.sem_leitura = true;
+        it.confirmacoes = 0;
+        it.acionado = INTERTRAVAMENTO_ESTADO_SEGURO;
+        monitor_acionar_saidas(it.acionado);
+        metricas_incrementar(METRICA_SEM_LEITURA);
+        registrar(it.ultima_mm, inicio_us);
+    }
+    if (r == MONITOR_AMOSTRA_PENDENTE) return true;
+
+    if (r == MONITOR_AMOSTRA_INVALIDA && it.descartadas < UINT16_MAX) {
+        it.descartadas++; // vai junto com a próxima aprovada, para a confiança da janela
+    } else if (r == MONITOR_AMOSTRA_VALIDA) {
+        // De volta do estado seguro, o relé só sai dele pela histerese e confirmação normais
+        it.sem_leitura = false;
+        it.ultima_us = inicio_us;
+        it.ultima_mm = distancia;
+        if (intertravamento_avaliar(distancia)) {
+            metricas_incrementar(METRICA_ACIONAMENTOS);
+            registrar(distancia, inicio_us);
+        }
+        if (it.amostras_escrita - it.amostras_leitura < INTERTRAVAMENTO_FILA_AMOSTRAS) {
+            it.amostras[it.amostras_escrita % INTERTRAVAMENTO_FILA_AMOSTRAS] =
+                (amostra_t){distancia, qualidade, it.descartadas, to_ms_since_boot(get_absolute_time())};
+            __compiler_memory_barrier();
+            it.amostras_escrita++;
+            it.descartadas = 0;
+        } else {
+            metricas_incrementar(METRICA_AMOSTRAS_PERDIDAS); // o laço ficou preso (rede, flash)
+        }
+    }
+    metricas_registrar_us(METRICA_INTERTRAVAMENTO_US, time_us_32() - inicio_us);
+    return true;
+}
+
+void intertravamento_iniciar() {
+    monitor_acionar_saidas(false);
+    it.ultima_us = time_us_32(); // o prazo sem leitura conta a partir daqui
+    // Período negativo: intervalo contado do início de uma chamada ao início da próxima
+    add_repeating_timer_ms(-INTERTRAVAMENTO_PERIODO_MS, ao_tick, NULL, &it.timer);
+}
+
+bool intertravamento_amostra(uint16_t *distancia_mm, uint8_t *qualidade, uint16_t *descartadas, uint32_t espera_ms) {
+    absolute_time_t limite = make_timeout_time_ms(espera_ms);
+    while (it.amostras_leitura == it.amostras_escrita) {
+        if (time_reached(limite)) return false;
+        energia_dormir_ms(1);
+    }
+    __compiler_memory_barrier();
+    amostra_t a = it.amostras[it.amostras_leitura % INTERTRAVAMENTO_FILA_AMOSTRAS];
+    __compiler_memory_barrier();
+    it.amostras_leitura++;
+    *distancia_mm = a.distancia_mm;
+    *qualidade = a.qualidade;
+    *descartadas = a.descartadas;
+
+    static bool primeira = true;
+    if (primeira) {
+        primeira = false;
+        metricas_definir(METRICA_BOOT_LEITURA_MS, a.t_ms);
+        REGISTRAR(BOOT_LEITURA, a.t_ms);
+    }
+    return true;
+}
+
+bool intertravamento_registro(intertravamento_registro_t *registro) {
+    if (it.registros_leitura == it.registros_escrita) return false;
+    __compiler_memory_barrier();
+    *registro = it.registros[it.registros_leitura % INTERTRAVAMENTO_FILA_REGISTROS];
+    __compiler_memory_barrier();
+    it.registros_leitura++;
+    return true;
+}
+
+void intertravamento_publicar(const intertravamento_registro_t *registro) {
+    char msg[112];
+    snprintf(msg, sizeof(msg), "{\"rele\":%d,\"t_ms\":%lu,\"distancia_mm\":%u,\"atraso_us\":%u,\"sem_leitura\":%d}",
+             registro->acionado, (unsigned long)registro->t_ms, registro->distancia_mm, registro->atraso_us,
+             registro->sem_leitura);
+    if (registro->sem_leitura) REGISTRAR(RELE_SEM_LEITURA, registro->t_ms, registro->acionado);
+    else if (registro->acionado) REGISTRAR(RELE_LIGADO, registro->t_ms, registro->distancia_mm, registro->atraso_us);
+    else REGISTRAR(RELE_DESLIGADO, registro->t_ms, registro->distancia_mm, registro->atraso_us);
+    mqtt_publicar(TOPICO_RELE, msg);
+}
@@ -0,0 +1,68 @@
+// intertravamento.h - Relé e LEDs decididos a cada leitura, numa IRQ de timer, sem passar pela rede
+
+#ifndef INTERTRAVAMENTO_H
+#define INTERTRAVAMENTO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Um acionamento do relé, guardado pela IRQ até o laço principal publicar
+typedef struct {
+    uint32_t t_ms;          // instante em que o GPIO do relé foi escrito
+    uint16_t distancia_mm;  // leitura que confirmou a troca
+    uint16_t atraso_us;     // do início da IRQ que leu a amostra até a escrita no GPIO
+    bool acionado;
+    bool sem_leitura;       // troca forçada pela falta de leituras (distancia_mm é a última aprovada)
+} intertravamento_registro_t;
+
+/**
+ * @brief Liga o timer repetitivo que lê o sensor e decide relé e LEDs dentro da IRQ.
+ *
+ * Deve ser chamada no core 0 depois de monitor_iniciar(); a partir daqui só a IRQ fala com o
+ * sensor. A troca acontece em no máximo INTERTRAVAMENTO_CONFIRMACOES leituras, cada uma a
+ * no máximo (tempo de medição + INTERTRAVAMENTO_PERIODO_MS) da anterior, fora das gravações
+ * da flash (ver intertravamento_flash_liberada()). Sem leitura aprovada por
+ * INTERTRAVAMENTO_SEM_LEITURA_MS, relé e LEDs vão para INTERTRAVAMENTO_ESTADO_SEGURO.
+ */
+void intertravamento_iniciar();
+
+/**
+ * @brief Aplica histerese e confirmação a uma leitura e, se for o caso, troca relé e LEDs.
+ *
+ * @return true se o relé trocou de estado.
+ */
+bool intertravamento_avaliar(uint16_t distancia_mm);
+
+bool intertravamento_acionado();
+
+/**
+ * @brief true se parar as interrupções para gravar a flash não põe o relé em risco agora.
+ *
+ * Exige relé desligado, leitura aprovada recente e a última leitura pelo menos
+ * INTERTRAVAMENTO_FOLGA_FLASH_MM acima de INTERTRAVAMENTO_DESLIGA_MM: durante o apagamento de
+ * um setor o timer não roda, e o nível precisa de mais que isso para chegar ao limiar.
+ */
+bool intertravamento_flash_liberada();
+
+/**
+ * @brief Retira a próxima leitura aprovada feita pela IRQ, esperando até espera_ms por ela.
+ *
+ * @param qualidade   Recebe a nota da leitura (monitor_coletar_amostra()).
+ * @param descartadas Recebe quantas leituras a IRQ reprovou entre a anterior e esta.
+ * @return false se nenhuma leitura chegou no prazo.
+ */
+bool intertravamento_amostra(uint16_t *distancia_mm, uint8_t *qualidade, uint16_t *descartadas, uint32_t espera_ms);
+
+/**
+ * @brief Retira o próximo acionamento registrado pela IRQ.
+ *
+ * @return false se não há acionamento pendente.
+ */
+bool intertravamento_registro(intertravamento_registro_t *registro);
+
+/**
+ * @brief Registra o acionamento no log (REGISTRAR) e publica em TOPICO_RELE.
+ */
+void intertravamento_publicar(const intertravamento_registro_t *registro);
+
+#endif // INTERTRAVAMENTO_H
@@ -0,0 +1,54 @@
+// dispositivo_i2c.hpp - Dispositivo I2C com porta, endereço e pinos fixados em tempo de compilação
+
+#ifndef DISPOSITIVO_I2C_HPP
+#define DISPOSITIVO_I2C_HPP
+
+#include "i2c_bus.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace botosmart {
+
+/**
+ * @brief Um dispositivo no barramento I2C, com a mesma recuperação e contadores de i2c_bus.c.
+ *
+ * Porta, endereço, pinos e velocidade são parâmetros do tipo: cada combinação é um tipo
+ * distinto com seu próprio i2c_dispositivo_t estático, e as chamadas vão direto a i2c_bus_*
+ * sem ponteiro para a configuração nem tabela de funções. Dois dispositivos no mesmo barramento
+ * são dois tipos com a mesma porta e pinos.
+ *
+ * @tparam Porta    i2c0 ou i2c1.
+ * @tparam Endereco Endereço de 7 bits.
+ */
+template <i2c_inst_t *Porta, uint8_t Endereco, uint Sda, uint Scl, uint Baudrate>
+class DispositivoI2C {
+public:
+    static_assert(Endereco >= 0x08 && Endereco <= 0x77, "endereço I2C de 7 bits fora da faixa de uso geral");
+    static_assert(Porta != nullptr, "barramento no PIO só pela API em C (pio_i2c.h)");
+    static_assert(Sda != Scl, "SDA e SCL no mesmo pino");
+    static_assert(Baudrate > 0 && Baudrate <= 1000000, "o RP2040 vai até 1 MHz (Fast-mode Plus)");
+
+    static constexpr uint8_t endereco = Endereco;
+    static constexpr uint baudrate = Baudrate;
+
+    static void iniciar() { i2c_bus_iniciar(&dev); }
+
+    static int escrever(const uint8_t *buf, size_t len, bool nostop = false) {
+        return i2c_bus_escrever(&dev, buf, len, nostop);
+    }
+
+    static int ler(uint8_t *buf, size_t len, bool nostop = false) { return i2c_bus_ler(&dev, buf, len, nostop); }
+
+    static bool ler_registradores(uint8_t reg, uint8_t *buf, size_t len) {
+        return i2c_bus_ler_registradores(&dev, reg, buf, len);
+    }
+
+    static const i2c_bus_contadores_t &contadores() { return dev.contadores; }
+
+private:
+    static inline i2c_dispositivo_t dev = {Porta, Endereco, Sda, Scl, Baudrate, {}, 0, nullptr, 0, 0, 0};
+};
+
+} // namespace botosmart
+
+#endif // DISPOSITIVO_I2C_HPP
@@ -0,0 +1,191 @@
+// ssd1306.hpp - Driver do SSD1306 com barramento e geometria como parâmetros de template
+
+#ifndef SSD1306_HPP
+#define SSD1306_HPP
+
+#include "ssd1306_blit.h"
+#include "ssd1306_font.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace botosmart {
+namespace ssd1306 {
+
+// Comandos usados pelo driver (datasheet do SSD1306, seção 9)
+enum : uint8_t {
+    CMD_MEMORIA = 0x20,          // + modo de endereçamento (0 = horizontal)
+    CMD_COLUNAS = 0x21,          // + coluna inicial e final
+    CMD_PAGINAS = 0x22,          // + página inicial e final
+    CMD_SCROLL_DESLIGA = 0x2E,
+    CMD_LINHA_INICIAL = 0x40,
+    CMD_CONTRASTE = 0x81,        // + contraste
+    CMD_CHARGE_PUMP = 0x8D,      // + 0x14 liga
+    CMD_SEGMENTO_INVERTIDO = 0xA1,
+    CMD_SEGUE_RAM = 0xA4,
+    CMD_NORMAL = 0xA6,
+    CMD_MULTIPLEX = 0xA8,        // + linhas - 1
+    CMD_DESLIGA = 0xAE,
+    CMD_LIGA = 0xAF,
+    CMD_COM_INVERTIDO = 0xC8,
+    CMD_DESLOCAMENTO = 0xD3,     // + deslocamento vertical
+    CMD_RELOGIO = 0xD5,          // + divisor e frequência do oscilador
+    CMD_PRECARGA = 0xD9,         // + períodos de pré-carga
+    CMD_PINOS_COM = 0xDA,        // + configuração dos pinos COM
+    CMD_VCOMH = 0xDB,            // + nível de desseleção
+};
+
+// Byte de controle antes de cada comando avulso e antes dos dados da GDDRAM
+constexpr uint8_t CONTROLE_COMANDO = 0x80;
+constexpr uint8_t CONTROLE_DADOS = 0x40;
+
+/**
+ * @brief Sequência de inicialização para a geometria: o multiplex é a altura e os pinos COM
+ *        são sequenciais nos painéis de 32 linhas e alternados nos de 64.
+ */
+template <uint8_t Altura>
+constexpr std::array<uint8_t, 25> comandos_iniciar() {
+    return {
+        CMD_DESLIGA,
+        CMD_RELOGIO, 0x80,
+        CMD_MULTIPLEX, Altura - 1,
+        CMD_DESLOCAMENTO, 0x00,
+        CMD_LINHA_INICIAL,
+        CMD_CHARGE_PUMP, 0x14,
+        CMD_MEMORIA, 0x00,
+        CMD_SEGMENTO_INVERTIDO,
+        CMD_COM_INVERTIDO,
+        CMD_PINOS_COM, Altura == 32 ? 0x02 : 0x12,
+        CMD_CONTRASTE, 0xFF,
+        CMD_PRECARGA, 0xF1,
+        CMD_VCOMH, 0x40,
+        CMD_SEGUE_RAM,
+        CMD_NORMAL,
+        CMD_LIGA,
+    };
+}
+
+/**
+ * @brief Índice do glifo em font[] (ssd1306_font.h) para cada caractere ASCII: 0 é o espaço,
+ *        A–Z (e a–z) vão para 1..26 e 0–9 para 27..36.
+ */
+constexpr std::array<uint8_t, 128> tabela_fonte() {
+    std::array<uint8_t, 128> t{};
+    for (int c = 'A'; c <= 'Z'; c++) t[c] = static_cast<uint8_t>(c - 'A' + 1);
+    for (int c = 'a'; c <= 'z'; c++) t[c] = static_cast<uint8_t>(c - 'a' + 1);
+    for (int c = '0'; c <= '9'; c++) t[c] = static_cast<uint8_t>(c - '0' + 27);
+    return t;
+}
+
+inline constexpr std::array<uint8_t, 128> indice_fonte = tabela_fonte();
+constexpr int LARGURA_GLIFO = 8;
+
+static_assert(indice_fonte['Z'] == 26 && indice_fonte['9'] == 36, "tabela da fonte fora da ordem de font[]");
+static_assert(sizeof(font) >= (indice_fonte['9'] + 1) * LARGURA_GLIFO, "font[] sem os dígitos");
+
+} // namespace ssd1306
+
+/**
+ * @brief Display SSD1306 num dispositivo I2C (DispositivoI2C), com framebuffer estático do
+ *        tamanho exato da geometria.
+ *
+ * Tudo é estático: cada instanciação tem o próprio quadro e buffer de transmissão, e dois
+ * displays no mesmo firmware (ex.: 128x64 em 0x3C e 128x32 em 0x3D) não dividem nada nem
+ * passam por ponteiro de configuração.
+ *
+ * @tparam Barramento Tipo DispositivoI2C<...> do display.
+ */
+template <class Barramento, uint8_t Largura = 128, uint8_t Altura = 64>
+class Ssd1306 {
+public:
+    static_assert(Largura > 0 && Largura <= 128, "o SSD1306 tem 128 colunas");
+    static_assert(Altura == 32 || Altura == 64, "painéis SSD1306 têm 32 ou 64 linhas");
+
+    static constexpr uint8_t largura = Largura;
+    static constexpr uint8_t altura = Altura;
+    static constexpr uint8_t paginas = Altura / 8;
+    static constexpr size_t tamanho_quadro = static_cast<size_t>(paginas) * Largura;
+
+    static void iniciar() {
+        Barramento::iniciar();
+        constexpr auto sequencia = ssd1306::comandos_iniciar<Altura>();
+        for (uint8_t c : sequencia) comando(c);
+    }
+
+    static void comando(uint8_t cmd) {
+        uint8_t buf[2] = {ssd1306::CONTROLE_COMANDO, cmd};
+        Barramento::escrever(buf, 2);
+    }
+
+    // Envia ao display apenas a janela [col_ini..col_fim] x [pag_ini..pag_fim] do quadro.
+    // Em modo de endereçamento horizontal o controlador percorre a janela página a página,
+    // então os bytes são empacotados na mesma ordem antes de uma única escrita I2C.
+    static void enviar_area(uint8_t col_ini, uint8_t col_fim, uint8_t pag_ini, uint8_t pag_fim) {
+        comando(ssd1306::CMD_COLUNAS);
+        comando(col_ini); comando(col_fim);
+        comando(ssd1306::CMD_PAGINAS);
+        comando(pag_ini); comando(pag_fim);
+
+        size_t n = 1;
+        tx[0] = ssd1306::CONTROLE_DADOS;
+        size_t largura_janela = col_fim - col_ini + 1;
+        for (int p = pag_ini; p <= pag_fim; p++) {
+            std::memcpy(tx + n, buffer + p * Largura + col_ini, largura_janela);
+            n += largura_janela;
+        }
+        Barramento::escrever(tx, n);
+    }
+
+    static void enviar() { enviar_area(0, Largura - 1, 0, paginas - 1); }
+
+    static void limpar() { std::memset(buffer, 0, sizeof(buffer)); }
+
+    static uint8_t *quadro() { return buffer; }
+    static uint8_t *pagina(uint8_t p) { return buffer + p * Largura; }
+
+    static void pixel(int16_t x, int16_t y, bool ligado) {
+        if (x < 0 || x >= Largura || y < 0 || y >= Altura) return;
+        uint8_t &byte = buffer[(y / 8) * Largura + x];
+        if (ligado) byte |= static_cast<uint8_t>(1 << (y % 8));
+        else        byte &= static_cast<uint8_t>(~(1 << (y % 8)));
+    }
+
+    // Segmento vertical entre y0 e y1 (inclusive) na coluna x
+    static void linha_vertical(int16_t x, int16_t y0, int16_t y1) {
+        if (y0 > y1) { int16_t t = y0; y0 = y1; y1 = t; }
+        for (int16_t y = y0; y <= y1; y++) pixel(x, y, true);
+    }
+
+    static void caractere(int16_t x, int16_t y, char c) {
+        if (x < 0 || x >= Largura || y < 0 || y >= Altura) return;
+        auto u = static_cast<unsigned char>(c);
+        const uint8_t *glifo = &font[(u < 128 ? ssd1306::indice_fonte[u] : 0) * ssd1306::LARGURA_GLIFO];
+        for (int i = 0; i < ssd1306::LARGURA_GLIFO; i++) {
+            for (int j = 0; j < 8; j++) {
+                if ((glifo[i] >> j) & 1) pixel(static_cast<int16_t>(x + i), static_cast<int16_t>(y + j), true);
+            }
+        }
+    }
+
+    static void texto(int16_t x, int16_t y, const char *s) {
+        while (*s) {
+            caractere(x, y, *s++);
+            x = static_cast<int16_t>(x + ssd1306::LARGURA_GLIFO);
+        }
+    }
+
+    // Copia um sprite para o quadro (ssd1306_blit.c); 'sujo' recebe a área a enviar
+    static bool desenhar(const ssd1306_sprite_t *sprite, int16_t x, int16_t y,
+                         ssd1306_blit_modo_t modo = SSD1306_BLIT_COPIA, render_area *sujo = nullptr) {
+        return ssd1306_blit(buffer, Largura, Altura, sprite, nullptr, x, y, modo, sujo);
+    }
+
+private:
+    static inline uint8_t buffer[tamanho_quadro];
+    static inline uint8_t tx[tamanho_quadro + 1]; // byte de controle 0x40 + dados
+};
+
+} // namespace botosmart
+
+#endif // SSD1306_HPP
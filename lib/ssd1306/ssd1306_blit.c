@@ -0,0 +1,101 @@
+#include "ssd1306_blit.h"
+#include <assert.h>
+
+/*
+ * Combina um byte (8 pixels verticais) do sprite com um byte do framebuffer.
+ * 'mascara' marca quais bits do byte pertencem ao sprite; os demais ficam intactos.
+ */
+static inline uint8_t combinar(uint8_t destino, uint8_t bits, uint8_t mascara, ssd1306_blit_modo_t modo) {
+    bits &= mascara;
+    switch (modo) {
+        case SSD1306_BLIT_COPIA: return (destino & ~mascara) | bits;
+        case SSD1306_BLIT_OR:    return destino | bits;
+        case SSD1306_BLIT_XOR:   return destino ^ bits;
+        case SSD1306_BLIT_APAGA: return destino & ~bits;
+    }
+    return destino;
+}
+
+/*
+ * Desenha um retângulo de um sprite no framebuffer, um byte de página por vez.
+ * Com destino alinhado (y múltiplo de 8) cada byte do sprite cai em um único byte do
+ * framebuffer; caso contrário é dividido em dois com deslocamento, sem laço por pixel.
+ * O recorte horizontal é feito por coluna e o vertical por página e por máscara de bits.
+ */
+bool ssd1306_blit(uint8_t *quadro, int largura_quadro, int altura_quadro,
+                  const ssd1306_sprite_t *sprite, const ssd1306_retangulo_t *origem,
+                  int16_t x, int16_t y, ssd1306_blit_modo_t modo, struct render_area *sujo) {
+    ssd1306_retangulo_t r = {0, 0, sprite->largura, sprite->altura};
+    if (origem) {
+        r = *origem;
+    }
+    assert((r.y % 8) == 0);
+
+    // Recorta a origem pelos limites do próprio sprite
+    if (r.x < 0) { r.largura += r.x; x -= r.x; r.x = 0; }
+    if (r.x + r.largura > sprite->largura) r.largura = sprite->largura - r.x;
+    if (r.y + r.altura > sprite->altura) r.altura = sprite->altura - r.y;
+
+    // Recorta horizontalmente pelo framebuffer
+    int col_ini = 0, col_fim = r.largura;
+    if (x < 0) col_ini = -x;
+    if (x + col_fim > largura_quadro) col_fim = largura_quadro - x;
+
+    // Linhas de destino visíveis
+    int y_min = y < 0 ? 0 : y;
+    int y_max = y + r.altura - 1;
+    if (y_max > altura_quadro - 1) y_max = altura_quadro - 1;
+
+    if (col_ini >= col_fim || y_min > y_max || r.altura <= 0) {
+        return false;
+    }
+
+    const int paginas_quadro = altura_quadro / 8;
+    const int paginas_sprite = (r.altura + 7) / 8;
+    // Divisão com arredondamento para baixo, válida para y negativo
+    const int pagina_base = (y >= 0) ? (y / 8) : -((7 - y) / 8);
+    const int desloc = y - pagina_base * 8;
+
+    for (int sp = 0; sp < paginas_sprite; sp++) {
+        const uint8_t *linha = sprite->dados + (r.y / 8 + sp) * sprite->largura + r.x;
+
+        // Última página do retângulo pode ser parcial
+        int restantes = r.altura - sp * 8;
+        uint8_t mascara = restantes >= 8 ? 0xFF : (uint8_t)((1u << restantes) - 1);
+
+        int pagina_baixa = pagina_base + sp;
+        uint8_t mascara_baixa = (uint8_t)(mascara << desloc);
+        uint8_t mascara_alta = desloc ? (uint8_t)(mascara >> (8 - desloc)) : 0;
+
+        for (int c = col_ini; c < col_fim; c++) {
+            uint8_t bits = linha[c];
+            uint8_t *coluna = quadro + x + c;
+
+            if (pagina_baixa >= 0 && pagina_baixa < paginas_quadro && mascara_baixa) {
+                uint8_t *b = coluna + pagina_baixa * largura_quadro;
+                *b = combinar(*b, (uint8_t)(bits << desloc), mascara_baixa, modo);
+            }
+            if (mascara_alta && pagina_baixa + 1 >= 0 && pagina_baixa + 1 < paginas_quadro) {
+                uint8_t *b = coluna + (pagina_baixa + 1) * largura_quadro;
+                *b = combinar(*b, (uint8_t)(bits >> (8 - desloc)), mascara_alta, modo);
+            }
+        }
+    }
+
+    if (sujo) {
+        sujo->start_column = x + col_ini;
+        sujo->end_column   = x + col_fim - 1;
+        sujo->start_page   = y_min / 8;
+        sujo->end_page     = y_max / 8;
+        sujo->buffer_length = (sujo->end_column - sujo->start_column + 1) * (sujo->end_page - sujo->start_page + 1);
+    }
+    return true;
+}
+
+/*
+ * Variante para a estrutura ssd1306_t: o framebuffer começa após o byte de controle 0x40.
+ */
+bool ssd1306_blit_bm(ssd1306_t *ssd, const ssd1306_sprite_t *sprite, const ssd1306_retangulo_t *origem,
+                     int16_t x, int16_t y, ssd1306_blit_modo_t modo, struct render_area *sujo) {
+    return ssd1306_blit(ssd->ram_buffer + 1, ssd->width, ssd->height, sprite, origem, x, y, modo, sujo);
+}
@@ -0,0 +1,46 @@
+#ifndef SSD1306_BLIT_H
+#define SSD1306_BLIT_H
+
+#include "ssd1306_i2c.h"  // struct render_area e ssd1306_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Modos de combinação do sprite com o conteúdo do framebuffer
+typedef enum {
+    SSD1306_BLIT_COPIA,   // substitui os pixels cobertos pelo sprite
+    SSD1306_BLIT_OR,      // bits 0 do sprite são transparentes
+    SSD1306_BLIT_XOR,     // inverte o destino onde o sprite tem bits 1
+    SSD1306_BLIT_APAGA,   // apaga o destino onde o sprite tem bits 1 (máscara)
+} ssd1306_blit_modo_t;
+
+// Imagem no mesmo formato da GDDRAM: (altura / 8) páginas de 'largura' bytes,
+// bit 0 de cada byte é o pixel mais alto da página.
+typedef struct {
+    uint8_t largura;
+    uint8_t altura;
+    const uint8_t *dados;
+} ssd1306_sprite_t;
+
+typedef struct {
+    int16_t x, y, largura, altura;
+} ssd1306_retangulo_t;
+
+// Copia 'origem' do sprite (NULL = sprite inteiro; y deve ser múltiplo de 8) para (x, y)
+// do framebuffer, recortando o que ficar fora dele. Não envia nada ao display: se 'sujo'
+// não for NULL recebe a área (alinhada em páginas) que precisa ser renderizada.
+// Retorna false se nada ficou visível.
+bool ssd1306_blit(uint8_t *quadro, int largura_quadro, int altura_quadro,
+                  const ssd1306_sprite_t *sprite, const ssd1306_retangulo_t *origem,
+                  int16_t x, int16_t y, ssd1306_blit_modo_t modo, struct render_area *sujo);
+
+// Mesmo que ssd1306_blit(), usando o buffer e a geometria de um ssd1306_t
+bool ssd1306_blit_bm(ssd1306_t *ssd, const ssd1306_sprite_t *sprite, const ssd1306_retangulo_t *origem,
+                     int16_t x, int16_t y, ssd1306_blit_modo_t modo, struct render_area *sujo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SSD1306_BLIT_H
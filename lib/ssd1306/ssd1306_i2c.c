@@ -289,11 +289,10 @@ void ssd1306_send_data(ssd1306_t *ssd) {
 
 /*
  * Desenha um bitmap (imagem) completo no display.
- * Copia os dados do bitmap para o buffer de vídeo e envia ao display.
+ * Copia os dados do bitmap para o buffer de vídeo e envia ao display uma única vez.
+ * Para sprites, recortes e modos de combinação use ssd1306_blit() (ssd1306_blit.h).
  */
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
-    for (int i = 0; i < ssd->bufsize - 1; i++) {
-        ssd->ram_buffer[i + 1] = bitmap[i];
-        ssd1306_send_data(ssd);
-    }
+    memcpy(ssd->ram_buffer + 1, bitmap, ssd->bufsize - 1);
+    ssd1306_send_data(ssd);
 }
\ No newline at end of file
@@ -42,7 +42,7 @@
 #define MEM_LIBC_MALLOC             0
 #endif
 #define MEM_ALIGNMENT               4
-#define MEM_SIZE                    4000
+#define MEM_SIZE                    8500
 #define MEMP_NUM_TCP_SEG            32
 #define MEMP_NUM_ARP_QUEUE          10
 #define MEMP_NUM_SYS_TIMEOUT        16
@@ -59,7 +59,7 @@
 #define LWIP_NETIF_LINK_CALLBACK    1
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETCONN                0
-#define MEM_STATS                   0
+#define MEM_STATS                   1   // só vale com LWIP_STATS: pico do heap do lwIP em memoria.c
 #define SYS_STATS                   0
 #define MEMP_STATS                  0
 #define LINK_STATS                  0
@@ -74,6 +74,9 @@
 #define LWIP_NETIF_TX_SINGLE_PBUF   1
 #define DHCP_DOES_ARP_CHECK         0
 #define LWIP_DHCP_DOES_ACD_CHECK    0
+// A publicação de métricas (JSON) passa dos 256 bytes padrão do buffer de saída do MQTT;
+// o cliente MQTT (com esse buffer) sai do heap do lwIP, por isso MEM_SIZE acima subiu para 8500
+#define MQTT_OUTPUT_RINGBUF_SIZE    1536
 
 #ifndef NDEBUG
 #define LWIP_DEBUG                  1
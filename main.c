@@ -1,107 +1,116 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
 #include "hardware_oled.h"
+#include "memoria.h"
+#include "display.h"
+#include "captura.h"
 #include "config.h"
+#include "deteccao.h"
+#include "energia.h"
+#include "intertravamento.h"
 #include "mqtt_config.h"
-#include "vl53l0x.h"
-
-typedef enum {
-    ESTADO_ANALISANDO,
-    ESTADO_ALERTA_ATIVO
-} SystemState;
+#include "monitor.h"
+#include "metricas.h"
+#include "ota.h"
+#include "rede.h"
+#include "registro.h"
+#include "servidor_http.h"
 
 int main() {
-    stdio_init_all();
-    sleep_ms(2000); // Dá tempo para o host detectar o USB
+    memoria_iniciar(); // pinta as pilhas antes de qualquer chamada funda e antes do core 1
+    stdio_init_all(); // sem esperar pelo USB: o que sair antes de o host conectar se perde
+    ota_iniciar();    // pode pedir a volta à imagem anterior e reiniciar: antes de qualquer periférico
+    energia_iniciar(); // antes do core 1 e do timer, que trocam estados de display e sensor
 
    hardware_init();
+    display_iniciar(); // a partir daqui o OLED é atualizado pelo core 1
+
+    // Sensor e alerta local primeiro; a rede conecta em segundo plano (rede_processar())
+    monitor_iniciar();
+    intertravamento_iniciar(); // daqui em diante relé e LEDs seguem cada leitura, na IRQ
+    deteccao_iniciar();
+    display_grafico("Analisando");
+    display_icone(OLED_ICONE_OK);
+    SystemState estado_atual = ESTADO_ANALISANDO;
 
-    // Conexão Wi-Fi
-
+    rede_iniciar();
 
-    // Processo de conexão Wi-Fi
-    printf("Conectando ao Wi-Fi...\n");
-    hardware_oled_exibir("Wi-Fi", "Conectando");
+    uint32_t inicio_laco_us = time_us_32();
+    absolute_time_t proximas_metricas = make_timeout_time_ms(METRICAS_PERIODO_MS);
+    static char metricas_msg[METRICAS_JSON_MAX];
+    bool leituras_ok = false; // a última janela teve média: entra na confirmação de uma imagem nova
 
-    while (1) {
-        if (cyw43_arch_init()) {
-            printf("Falha ao inicializar Wi-Fi\n");
-            hardware_oled_exibir("Wi-Fi", "Falha init");
-            sleep_ms(2000); // Aguarda antes de tentar novamente
-            continue;
+    while (true) {
+        memoria_amostrar();
+
+        uint32_t agora_us = time_us_32();
+        uint32_t periodo_janela_ms = (agora_us - inicio_laco_us) / 1000;
+        metricas_registrar_us(METRICA_LACO_US, agora_us - inicio_laco_us);
+        inicio_laco_us = agora_us;
+
+        // Comandos no terminal USB: imprime as métricas na hora, liga/desliga a captura bruta
+        int tecla = getchar_timeout_us(0);
+        if (tecla == METRICAS_COMANDO_USB) {
+            metricas_imprimir();
+        } else if (tecla == CAPTURA_COMANDO_USB) {
+            captura_alternar();
         }
-        cyw43_arch_enable_sta_mode();
-        if (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 30000)) {
-            printf("Falha ao conectar ao Wi-Fi\n");
-            hardware_oled_exibir("Wi-Fi", "Falha conexao");
-            sleep_ms(2000); // Aguarda antes de tentar novamente
-            continue;
+        if (time_reached(proximas_metricas)) {
+            proximas_metricas = make_timeout_time_ms(METRICAS_PERIODO_MS);
+            if (metricas_json(metricas_msg, sizeof(metricas_msg))) {
+                mqtt_publicar(TOPICO_METRICAS, metricas_msg);
+            }
+            energia_publicar();
         }
-        break; // Conectou com sucesso
-    }
-
-    printf("Wi-Fi conectado!\n");
-    hardware_oled_exibir("Wi-Fi", "Conectado");
-    sleep_ms(1000);
-
-    mqtt_iniciar(); // inicializa MQTT
-
-    hardware_oled_exibir("", "   Analisando   ");
-    SystemState estado_atual = ESTADO_ANALISANDO;
-
-    // Inicializa sensor VL53L0X
-    vl53l0x_init(I2C0_PORT);
-    vl53l0x_start_ranging(I2C0_PORT);
-
-    while (true) {
-        cyw43_arch_poll(); // mantém rede viva
-
-        // Variáveis para média das leituras
-        uint32_t soma = 0;
-        uint16_t leituras_validas = 0;
 
         // Leitura de distância
-        uint16_t distancia_mm = 0;
-        for (int i = 0; i < 50; i++) {
-            vl53l0x_start_ranging(I2C0_PORT); // inicia nova medição
-            sleep_ms(5); // tempo para o sensor medir
-            uint16_t dist = 0;
-            if (vl53l0x_read_distance(I2C0_PORT, &dist)) {
-                soma += dist;
-                leituras_validas++;
+        monitor_janela_t janela;
+        monitor_janela_limpar(&janela);
+        for (int i = 0; i < MONITOR_AMOSTRAS_JANELA; i++) {
+            uint16_t dist = 0, descartadas;
+            uint8_t qualidade;
+            if (intertravamento_amostra(&dist, &qualidade, &descartadas, INTERTRAVAMENTO_ESPERA_MS)) {
+                monitor_janela_adicionar(&janela, dist, qualidade);
+                monitor_janela_descartar(&janela, descartadas);
+            }
+            captura_processar();
+            intertravamento_registro_t acionamento;
+            while (intertravamento_registro(&acionamento)) {
+                intertravamento_publicar(&acionamento);
             }
-            sleep_ms(6); // 50 leituras x 6ms = 300ms
+            // Alerta e OTA pedem o rádio sempre acordado; fora disso ele dorme entre publicações
+            rede_politica_radio(intertravamento_acionado() || ota_recebendo(),
+                                MONITOR_PUBLICAR_MEDICOES ? periodo_janela_ms : METRICAS_PERIODO_MS);
+            rede_processar(); // a cada amostra, para a conexão andar sem esperar a janela
+            ota_processar(intertravamento_flash_liberada(), leituras_ok && mqtt_esta_conectado());
         }
 
-        if (leituras_validas > 0) {
-            uint16_t media = soma / leituras_validas;
-            uint16_t media_cm = media / 10;
-            char msg_alerta[50];
-            sprintf(msg_alerta, "%d", media);
-            mqtt_publicar(TOPICO_MEDICOES, msg_alerta);
-            printf("Distância média: %d cm (%d leituras)\n", media_cm, leituras_validas);
+        metricas_definir(METRICA_JANELA_VALIDAS, janela.leituras_validas);
+        metricas_definir(METRICA_CONFIANCA, monitor_janela_confianca(&janela));
+
+        uint16_t media = 0;
+        deteccao_evento_t evento;
+        if (deteccao_processar(&janela, to_ms_since_boot(get_absolute_time()), &evento)) {
+            deteccao_publicar(&evento);
+        }
 
-            if (media_cm < DISTANCIA_LIMIAR_CM) {
-                if (estado_atual != ESTADO_ALERTA_ATIVO) {
-                    mqtt_publicar(TOPICO_ALERTA, "Anomalia Detectada!");
-                    estado_atual = ESTADO_ALERTA_ATIVO;
-                }
-                gpio_put(LED_VERDE_PIN, 0);
-                gpio_put(LED_VERMELHO_PIN, 1);
-                gpio_put(RELER_PIN, 1);
-            } else{
-                if (estado_atual != ESTADO_ANALISANDO) {
-                mqtt_publicar(TOPICO_ALERTA, "Sem Anomalias");
-                estado_atual = ESTADO_ANALISANDO;
-                }
-                gpio_put(LED_VERDE_PIN, 1);
-                gpio_put(LED_VERMELHO_PIN, 0);
-                gpio_put(RELER_PIN, 0);
-                
+        leituras_ok = monitor_janela_media(&janela, &media);
+        if (leituras_ok) {
+#if MONITOR_PUBLICAR_MEDICOES
+            monitor_publicar_medicao(media);
+#endif
+            display_grafico_amostra(media);
+            REGISTRAR(MEDIA_JANELA, media / 10, janela.leituras_validas);
+
+            if (monitor_decidir(&estado_atual, media)) {
+                monitor_publicar_estado(estado_atual);
+                display_icone(estado_atual == ESTADO_ALERTA_ATIVO ? OLED_ICONE_ALERTA : OLED_ICONE_OK);
             }
         }
+        servidor_http_registrar(media, leituras_ok, estado_atual == ESTADO_ALERTA_ATIVO, intertravamento_acionado());
 
-        sleep_ms(500);
+        registro_descarregar(); // no tempo ocioso: a USB lenta não atrasa a janela
+        energia_dormir_ms(500);
     }
 
     return 0;
@@ -0,0 +1,79 @@
+// memoria.c - Pintura das pilhas na partida e leitura das marcas d'água de pilha e heap
+
+#include "config.h"
+#include "memoria.h"
+#include "metricas.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#if PICO_ON_DEVICE
+#include "lwip/stats.h"
+#include <malloc.h>
+#include <unistd.h>
+#endif
+
+#define PADRAO_PILHA     0xDEADBEEFu
+#define MARGEM_PINTURA   16 // palavras abaixo do SP atual que não são pintadas (o quadro desta função)
+
+static memoria_estado_t estado = {.heap_livre_min = UINT32_MAX, .lwip_heap_max = -1};
+
+#if PICO_ON_DEVICE
+// Símbolos do memmap_default.ld: a pilha do core 0 desce do fim do SCRATCH_Y e a do core 1 do
+// fim do SCRATCH_X; abaixo da reserva fica o resto do scratch, até os dados .scratch_x/.scratch_y
+extern uint32_t __StackTop, __StackBottom, __StackOneTop, __StackOneBottom;
+extern uint32_t __scratch_x_end__, __scratch_y_end__;
+extern char end, __StackLimit;
+
+// Sobe da base até a primeira palavra que a pilha já sujou
+static uint32_t profundidade(const uint32_t *base, const uint32_t *topo) {
+    const uint32_t *p = base;
+    while (p < topo && *p == PADRAO_PILHA) p++;
+    return (uint32_t)((uintptr_t)topo - (uintptr_t)p);
+}
+#endif
+
+void memoria_iniciar() {
+#if PICO_ON_DEVICE
+    // Core 1 ainda parado: a pilha dele é pintada inteira
+    for (uint32_t *p = &__scratch_x_end__; p < &__StackOneTop; p++) *p = PADRAO_PILHA;
+
+    // Core 0 só abaixo do SP, com as IRQs desligadas: uma IRQ agora empilharia sobre a pintura
+    uint32_t *sp;
+    __asm volatile("mov %0, sp" : "=r"(sp));
+    uint32_t status = save_and_disable_interrupts();
+    for (uint32_t *p = &__scratch_y_end__; p < sp - MARGEM_PINTURA; p++) *p = PADRAO_PILHA;
+    restore_interrupts(status);
+
+    estado.pilha_reservada[0] = (uint32_t)((uintptr_t)&__StackTop - (uintptr_t)&__StackBottom);
+    estado.pilha_reservada[1] = (uint32_t)((uintptr_t)&__StackOneTop - (uintptr_t)&__StackOneBottom);
+    estado.pilha_limite[0] = (uint32_t)((uintptr_t)&__StackTop - (uintptr_t)&__scratch_y_end__);
+    estado.pilha_limite[1] = (uint32_t)((uintptr_t)&__StackOneTop - (uintptr_t)&__scratch_x_end__);
+    estado.heap_total = (uint32_t)(&__StackLimit - &end);
+#endif
+    memoria_amostrar();
+}
+
+void memoria_amostrar() {
+#if PICO_ON_DEVICE
+    estado.pilha_max[0] = profundidade(&__scratch_y_end__, &__StackTop);
+    estado.pilha_max[1] = profundidade(&__scratch_x_end__, &__StackOneTop);
+
+    // O que o sbrk ainda não entregou ao malloc mais o que foi liberado dentro da arena
+    struct mallinfo m = mallinfo();
+    char *fim_arena = sbrk(0);
+    estado.heap_livre = (uint32_t)(&__StackLimit - fim_arena) + (uint32_t)m.fordblks;
+#if LWIP_STATS && MEM_STATS
+    estado.lwip_heap_max = (int32_t)lwip_stats.mem.max;
+#endif
+#endif
+    // Na simulação não há mapa de memória da placa: tudo fica em zero
+    if (estado.heap_livre < estado.heap_livre_min) estado.heap_livre_min = estado.heap_livre;
+
+    metricas_definir(METRICA_PILHA_CORE0_MAX, (int32_t)estado.pilha_max[0]);
+    metricas_definir(METRICA_PILHA_CORE1_MAX, (int32_t)estado.pilha_max[1]);
+    metricas_definir(METRICA_HEAP_LIVRE_MIN, (int32_t)estado.heap_livre_min);
+    metricas_definir(METRICA_LWIP_HEAP_MAX, estado.lwip_heap_max);
+}
+
+const memoria_estado_t *memoria_estado() {
+    return &estado;
+}
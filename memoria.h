@@ -0,0 +1,35 @@
+// memoria.h - Marca d'água das pilhas dos dois cores e mínimo de heap livre
+
+#ifndef MEMORIA_H
+#define MEMORIA_H
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t pilha_reservada[2]; // PICO_STACK_SIZE / PICO_CORE1_STACK_SIZE, em bytes
+    uint32_t pilha_max[2];       // maior profundidade já usada por core
+    uint32_t pilha_limite[2];    // espaço até o fim do scratch (o que a pilha pode usar sem corromper dados)
+    uint32_t heap_total;         // do fim da .bss ao fim da RAM
+    uint32_t heap_livre;         // nunca pedido ao sbrk + blocos liberados dentro da arena
+    uint32_t heap_livre_min;     // menor heap_livre entre as amostras
+    int32_t lwip_heap_max;       // pico do heap do lwIP (MEM_SIZE); -1 sem MEM_STATS
+} memoria_estado_t;
+
+/**
+ * @brief Pinta as pilhas com um padrão conhecido. Chamar no início do main, antes de lançar
+ *        o core 1: a pilha do core 1 é pintada inteira, a do core 0 só abaixo do ponto atual.
+ */
+void memoria_iniciar();
+
+/**
+ * @brief Mede as pilhas e o heap e atualiza os medidores em metricas.h. Barata o bastante
+ *        para rodar a cada janela; o mínimo de heap livre só vê o que existia nas amostras.
+ */
+void memoria_amostrar();
+
+/**
+ * @brief Último estado medido por memoria_amostrar().
+ */
+const memoria_estado_t *memoria_estado();
+
+#endif // MEMORIA_H
@@ -0,0 +1,126 @@
+// metricas.c - Tabela estática de métricas, uma cópia por core, somadas na leitura
+
+#include "config.h"
+#include "metricas.h"
+#include "texto.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+#define METRICAS_NUM_CORES 2
+
+// Limites superiores (inclusive) das faixas; a última faixa é o estouro
+static const uint32_t faixas_us[] = {100, 300, 1000, 3000, 10000, 30000, 100000, 300000, 1000000};
+#define METRICAS_NUM_FAIXAS (count_of(faixas_us) + 1)
+
+#define METRICA_NOME(id, nome) nome,
+static const char *const nomes_contadores[] = {METRICAS_CONTADORES(METRICA_NOME)};
+static const char *const nomes_medidores[] = {METRICAS_MEDIDORES(METRICA_NOME)};
+static const char *const nomes_histogramas[] = {METRICAS_HISTOGRAMAS(METRICA_NOME)};
+#undef METRICA_NOME
+
+typedef struct {
+    uint32_t faixas[METRICAS_NUM_FAIXAS];
+    uint32_t maximo_us;
+    uint64_t soma_us;
+} histograma_t;
+
+typedef struct {
+    uint32_t contadores[METRICAS_NUM_CONTADORES];
+    histograma_t histogramas[METRICAS_NUM_HISTOGRAMAS];
+} metricas_core_t;
+
+static metricas_core_t por_core[METRICAS_NUM_CORES];
+static volatile int32_t medidores[METRICAS_NUM_MEDIDORES];
+
+void metricas_incrementar(metrica_contador_t contador) {
+    por_core[get_core_num()].contadores[contador]++;
+}
+
+void metricas_definir(metrica_medidor_t medidor, int32_t valor) {
+    medidores[medidor] = valor;
+}
+
+void metricas_registrar_us(metrica_histograma_t histograma, uint32_t duracao_us) {
+    histograma_t *h = &por_core[get_core_num()].histogramas[histograma];
+    uint i = 0;
+    while (i < count_of(faixas_us) && duracao_us > faixas_us[i]) i++;
+    h->faixas[i]++;
+    h->soma_us += duracao_us;
+    if (duracao_us > h->maximo_us) h->maximo_us = duracao_us;
+}
+
+// Leitura sem trava: um valor pode estar uma atualização atrasado, o que basta para relatório
+static uint32_t somar_contador(uint c) {
+    uint32_t total = 0;
+    for (int core = 0; core < METRICAS_NUM_CORES; core++) total += por_core[core].contadores[c];
+    return total;
+}
+
+static histograma_t somar_histograma(uint h) {
+    histograma_t total = {0};
+    for (int core = 0; core < METRICAS_NUM_CORES; core++) {
+        const histograma_t *p = &por_core[core].histogramas[h];
+        for (uint i = 0; i < METRICAS_NUM_FAIXAS; i++) total.faixas[i] += p->faixas[i];
+        total.soma_us += p->soma_us;
+        if (p->maximo_us > total.maximo_us) total.maximo_us = p->maximo_us;
+    }
+    return total;
+}
+
+static uint32_t amostras(const histograma_t *h) {
+    uint32_t n = 0;
+    for (uint i = 0; i < METRICAS_NUM_FAIXAS; i++) n += h->faixas[i];
+    return n;
+}
+
+void metricas_imprimir() {
+    printf("[metricas] t=%lu ms\n", (unsigned long)to_ms_since_boot(get_absolute_time()));
+    for (uint c = 0; c < METRICAS_NUM_CONTADORES; c++) {
+        printf("  %-20s %lu\n", nomes_contadores[c], (unsigned long)somar_contador(c));
+    }
+    for (uint m = 0; m < METRICAS_NUM_MEDIDORES; m++) {
+        printf("  %-20s %ld\n", nomes_medidores[m], (long)medidores[m]);
+    }
+    for (uint h = 0; h < METRICAS_NUM_HISTOGRAMAS; h++) {
+        histograma_t t = somar_histograma(h);
+        uint32_t n = amostras(&t);
+        printf("  %-20s n=%lu media=%lu max=%lu |", nomes_histogramas[h], (unsigned long)n,
+               (unsigned long)(n ? t.soma_us / n : 0), (unsigned long)t.maximo_us);
+        for (uint i = 0; i < METRICAS_NUM_FAIXAS; i++) {
+            if (i < count_of(faixas_us)) printf(" <=%lu:%lu", (unsigned long)faixas_us[i], (unsigned long)t.faixas[i]);
+            else printf(" >:%lu", (unsigned long)t.faixas[i]);
+        }
+        printf("\n");
+    }
+}
+
+// {"t":ms,"c":{...},"g":{...},"faixas_us":[...],"h":{"nome":{"n":..,"media":..,"max":..,"f":[...]}}}
+size_t metricas_json(char *buf, size_t tamanho) {
+    size_t pos = 0;
+    texto_anexar(buf, tamanho, &pos, "{\"t\":%lu,\"c\":{", (unsigned long)to_ms_since_boot(get_absolute_time()));
+    for (uint c = 0; c < METRICAS_NUM_CONTADORES; c++) {
+        texto_anexar(buf, tamanho, &pos, "%s\"%s\":%lu", c ? "," : "", nomes_contadores[c], (unsigned long)somar_contador(c));
+    }
+    texto_anexar(buf, tamanho, &pos, "},\"g\":{");
+    for (uint m = 0; m < METRICAS_NUM_MEDIDORES; m++) {
+        texto_anexar(buf, tamanho, &pos, "%s\"%s\":%ld", m ? "," : "", nomes_medidores[m], (long)medidores[m]);
+    }
+    texto_anexar(buf, tamanho, &pos, "},\"faixas_us\":[");
+    for (uint i = 0; i < count_of(faixas_us); i++) {
+        texto_anexar(buf, tamanho, &pos, "%s%lu", i ? "," : "", (unsigned long)faixas_us[i]);
+    }
+    texto_anexar(buf, tamanho, &pos, "],\"h\":{");
+    for (uint h = 0; h < METRICAS_NUM_HISTOGRAMAS; h++) {
+        histograma_t t = somar_histograma(h);
+        uint32_t n = amostras(&t);
+        texto_anexar(buf, tamanho, &pos, "%s\"%s\":{\"n\":%lu,\"media\":%lu,\"max\":%lu,\"f\":[", h ? "," : "",
+               nomes_histogramas[h], (unsigned long)n, (unsigned long)(n ? t.soma_us / n : 0),
+               (unsigned long)t.maximo_us);
+        for (uint i = 0; i < METRICAS_NUM_FAIXAS; i++) {
+            texto_anexar(buf, tamanho, &pos, "%s%lu", i ? "," : "", (unsigned long)t.faixas[i]);
+        }
+        texto_anexar(buf, tamanho, &pos, "]}");
+    }
+    texto_anexar(buf, tamanho, &pos, "}}");
+    return pos < tamanho ? pos : 0;
+}
@@ -0,0 +1,88 @@
+// metricas.h - Registro estático de contadores, medidores e histogramas de latência
+
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Cada lista gera o enum e a tabela de nomes; acrescentar uma métrica é só acrescentar uma linha.
+#define METRICAS_CONTADORES(X) \
+    X(I2C_TRANSACOES,      "i2c_transacoes") \
+    X(I2C_NACKS,           "i2c_nacks") \
+    X(I2C_TIMEOUTS,        "i2c_timeouts") \
+    X(I2C_RECUPERACOES,    "i2c_recuperacoes") \
+    X(LEITURAS_VALIDAS,    "leituras_validas") \
+    X(LEITURAS_INVALIDAS,  "leituras_invalidas") \
+    X(PUBLICACOES,         "publicacoes") \
+    X(PUBLICACOES_FALHAS,  "publicacoes_falhas") \
+    X(OLED_QUADROS,        "oled_quadros") \
+    X(WIFI_FALHAS,         "wifi_falhas") \
+    X(EVENTOS,             "eventos") \
+    X(ACIONAMENTOS,        "acionamentos") \
+    X(SEM_LEITURA,         "sem_leitura") \
+    X(AMOSTRAS_PERDIDAS,   "amostras_perdidas") \
+    X(CAPTURA_DESCARTES,   "captura_descartes") \
+    X(HTTP_RESPOSTAS,      "http_respostas")
+
+#define METRICAS_MEDIDORES(X) \
+    X(DISTANCIA_MM,        "distancia_mm") \
+    X(JANELA_VALIDAS,      "janela_validas") \
+    X(CONFIANCA,           "confianca") \
+    X(ESTADO,              "estado") \
+    X(RADIO_MODO,          "radio_modo") \
+    X(BOOT_CACHE,          "boot_cache") \
+    X(BOOT_LEITURA_MS,     "boot_leitura_ms") \
+    X(BOOT_REDE_MS,        "boot_rede_ms") \
+    X(BOOT_PUBLICACAO_MS,  "boot_publicacao_ms") \
+    X(PILHA_CORE0_MAX,     "pilha_core0_max") \
+    X(PILHA_CORE1_MAX,     "pilha_core1_max") \
+    X(HEAP_LIVRE_MIN,      "heap_livre_min") \
+    X(LWIP_HEAP_MAX,       "lwip_heap_max")
+
+#define METRICAS_HISTOGRAMAS(X) \
+    X(I2C_US,              "i2c_us") \
+    X(LEITURA_US,          "leitura_us") \
+    X(OLED_QUADRO_US,      "oled_quadro_us") \
+    X(LACO_US,             "laco_us") \
+    X(INTERTRAVAMENTO_US,  "intertravamento_us")
+
+#define METRICA_ENUM(id, nome) METRICA_##id,
+typedef enum { METRICAS_CONTADORES(METRICA_ENUM) METRICAS_NUM_CONTADORES } metrica_contador_t;
+typedef enum { METRICAS_MEDIDORES(METRICA_ENUM) METRICAS_NUM_MEDIDORES } metrica_medidor_t;
+typedef enum { METRICAS_HISTOGRAMAS(METRICA_ENUM) METRICAS_NUM_HISTOGRAMAS } metrica_histograma_t;
+#undef METRICA_ENUM
+
+/**
+ * @brief Soma 1 a um contador.
+ *
+ * Cada core escreve só na sua cópia da tabela, então o incremento é um load/add/store
+ * comum, sem trava (o M0+ não tem instruções atômicas de leitura-modificação-escrita).
+ * Um mesmo contador não deve ser incrementado pela thread e por uma IRQ do mesmo core.
+ */
+void metricas_incrementar(metrica_contador_t contador);
+
+/**
+ * @brief Define o valor atual de um medidor (último valor vence).
+ */
+void metricas_definir(metrica_medidor_t medidor, int32_t valor);
+
+/**
+ * @brief Registra uma duração no histograma (faixas fixas de 100 us a 1 s, mais estouro).
+ */
+void metricas_registrar_us(metrica_histograma_t histograma, uint32_t duracao_us);
+
+/**
+ * @brief Imprime todas as métricas em texto na saída padrão (USB CDC).
+ */
+void metricas_imprimir();
+
+/**
+ * @brief Serializa todas as métricas em JSON compacto para publicação MQTT.
+ *
+ * @return Tamanho escrito, ou 0 se o buffer não comporta.
+ */
+size_t metricas_json(char *buf, size_t tamanho);
+
+#endif // METRICAS_H
@@ -0,0 +1,203 @@
+// monitor.c - Etapas do ciclo de medição, separadas para o laço principal e para o benchmark
+
+#include "config.h"
+#include "captura.h"
+#include "energia.h"
+#include "monitor.h"
+#include "mqtt_config.h"
+#include "vl53l0x.h"
+#include "metricas.h"
+#include "intertravamento.h"
+
+static i2c_dispositivo_t sensor = {
+    .porta = I2C0_PORT,
+    .endereco = VL53L0X_ADDR,
+    .sda_pin = I2C0_SDA_PIN,
+    .scl_pin = I2C0_SCL_PIN,
+    .baudrate = I2C0_BAUDRATE,
+};
+
+#if SENSORES_PIO
+static const uint extras_sda[] = SENSORES_PIO_SDA_PINS;
+static_assert(SENSORES_PIO <= count_of(extras_sda), "faltam pinos em SENSORES_PIO_SDA_PINS");
+static_assert(SENSORES_PIO + 1 <= VL53L0X_MULTI_MAX, "sensores demais para uma leitura conjunta");
+
+static pio_i2c_t extras_pio[SENSORES_PIO];
+static i2c_dispositivo_t extras[SENSORES_PIO];
+static i2c_dispositivo_t *sensores[1 + SENSORES_PIO] = {&sensor}; // o do i2c0 primeiro
+#endif
+
+static uint32_t inicio_medicao_us;
+
+// Todos os sensores medem juntos: o resultado de todos fica pronto no mesmo instante
+static void disparar_medicoes() {
+#if SENSORES_PIO
+    bool ok[count_of(sensores)];
+    vl53l0x_start_ranging_multi(sensores, count_of(sensores), ok);
+#else
+    vl53l0x_start_ranging(&sensor);
+#endif
+    inicio_medicao_us = time_us_32();
+    energia_entrar(ENERGIA_SENSOR_MEDINDO);
+}
+
+void monitor_iniciar() {
+    i2c_bus_iniciar(&sensor);
+    vl53l0x_init(&sensor);
+#if SENSORES_PIO
+    for (int i = 0; i < SENSORES_PIO; i++) {
+        extras[i] = (i2c_dispositivo_t){
+            .endereco = VL53L0X_ADDR,
+            .sda_pin = extras_sda[i],
+            .scl_pin = extras_sda[i] + 1,
+            .baudrate = SENSORES_PIO_BAUDRATE,
+            .pio = &extras_pio[i],
+        };
+        sensores[1 + i] = &extras[i];
+        i2c_bus_iniciar(&extras[i]);
+        vl53l0x_init(&extras[i]);
+    }
+#endif
+    disparar_medicoes();
+}
+
+// Nota da medição com os limites de config.h; 0 = reprovada (fora da média e do relé)
+static uint8_t avaliar(const vl53l0x_medicao_t *medicao) {
+    uint8_t qualidade = vl53l0x_qualidade(medicao, QUALIDADE_SINAL_MIN_MCPS);
+    return qualidade >= QUALIDADE_MINIMA ? qualidade : 0;
+}
+
+bool monitor_ler_amostra(uint16_t *distancia_mm, uint8_t *qualidade) {
+    uint32_t inicio_us = time_us_32();
+    bool ok = vl53l0x_start_ranging(&sensor); // inicia nova medição
+    if (ok) {
+        energia_entrar(ENERGIA_SENSOR_MEDINDO);
+        sleep_ms(5); // tempo para o sensor medir
+        ok = vl53l0x_read_distance(&sensor, distancia_mm, VL53L0X_TIMEOUT_MEDICAO_US);
+        energia_entrar(ENERGIA_SENSOR_OCIOSO);
+        vl53l0x_medicao_t medicao; // já na sombra do driver, sem nova transação
+        ok = ok && vl53l0x_read_measurement(&sensor, &medicao);
+        if (ok) *qualidade = avaliar(&medicao);
+        ok = ok && *qualidade > 0;
+    }
+    metricas_registrar_us(METRICA_LEITURA_US, time_us_32() - inicio_us);
+    metricas_incrementar(ok ? METRICA_LEITURAS_VALIDAS : METRICA_LEITURAS_INVALIDAS);
+    return ok;
+}
+
+#if SENSORES_PIO
+// Bloco de resultado de todos os sensores: o do i2c0 normalmente já veio na consulta (sombra do
+// driver) e os extras no PIO transferem juntos numa rodada. A amostra é a média dos que
+// aprovados, com a nota média deles; a captura continua sendo só do sensor do i2c0.
+static bool ler_todos(uint16_t *distancia_mm, uint8_t *qualidade, bool principal_pronto) {
+    vl53l0x_medicao_t medicoes[count_of(sensores)];
+    bool ok[count_of(sensores)];
+    vl53l0x_read_measurement_multi(sensores, count_of(sensores), medicoes, ok);
+
+    uint32_t soma = 0, soma_qualidade = 0;
+    uint validas = 0;
+    for (uint i = 0; i < count_of(sensores); i++) {
+        uint8_t nota = ok[i] && (i > 0 || principal_pronto) ? avaliar(&medicoes[i]) : 0;
+        if (i == 0) captura_registrar(ok[0] ? &medicoes[0] : NULL, time_us_32(), nota > 0);
+        if (nota) {
+            soma += medicoes[i].distancia_mm;
+            soma_qualidade += nota;
+            validas++;
+        }
+    }
+    if (validas) {
+        *distancia_mm = (uint16_t)(soma / validas);
+        *qualidade = (uint8_t)(soma_qualidade / validas);
+    }
+    return validas > 0;
+}
+#endif
+
+monitor_amostra_t monitor_coletar_amostra(uint16_t *distancia_mm, uint8_t *qualidade) {
+    bool pronto = false;
+    bool ok = vl53l0x_result_ready(&sensor, &pronto);
+    if (ok && !pronto) {
+        if (time_us_32() - inicio_medicao_us < VL53L0X_TIMEOUT_MEDICAO_US) return MONITOR_AMOSTRA_PENDENTE;
+        ok = false; // o sensor não terminou no prazo: começa outra medição
+    }
+    energia_entrar(ENERGIA_SENSOR_OCIOSO);
+#if SENSORES_PIO
+    ok = ler_todos(distancia_mm, qualidade, ok);
+#else
+    // O bloco inteiro veio na consulta acima: ler a medição não volta ao barramento
+    vl53l0x_medicao_t medicao;
+    bool lida = ok && vl53l0x_read_measurement(&sensor, &medicao);
+    if (lida) {
+        *distancia_mm = medicao.distancia_mm;
+        *qualidade = avaliar(&medicao);
+    }
+    ok = lida && *qualidade > 0;
+    captura_registrar(lida ? &medicao : NULL, time_us_32(), ok);
+#endif
+    metricas_registrar_us(METRICA_LEITURA_US, time_us_32() - inicio_medicao_us);
+    metricas_incrementar(ok ? METRICA_LEITURAS_VALIDAS : METRICA_LEITURAS_INVALIDAS);
+
+    disparar_medicoes();
+    return ok ? MONITOR_AMOSTRA_VALIDA : MONITOR_AMOSTRA_INVALIDA;
+}
+
+const i2c_bus_contadores_t *monitor_contadores_i2c() {
+    return &sensor.contadores;
+}
+
+void monitor_janela_limpar(monitor_janela_t *janela) {
+    janela->soma = 0;
+    janela->leituras_validas = 0;
+    janela->min_mm = UINT16_MAX;
+    janela->max_mm = 0;
+    janela->soma_qualidade = 0;
+    janela->leituras_descartadas = 0;
+}
+
+void monitor_janela_adicionar(monitor_janela_t *janela, uint16_t distancia_mm, uint8_t qualidade) {
+    janela->soma += distancia_mm;
+    janela->soma_qualidade += qualidade;
+    janela->leituras_validas++;
+    if (distancia_mm < janela->min_mm) janela->min_mm = distancia_mm;
+    if (distancia_mm > janela->max_mm) janela->max_mm = distancia_mm;
+}
+
+void monitor_janela_descartar(monitor_janela_t *janela, uint16_t leituras) {
+    janela->leituras_descartadas += leituras;
+}
+
+uint8_t monitor_janela_confianca(const monitor_janela_t *janela) {
+    uint32_t total = (uint32_t)janela->leituras_validas + janela->leituras_descartadas;
+    return total ? (uint8_t)(janela->soma_qualidade / total) : 0;
+}
+
+bool monitor_janela_media(const monitor_janela_t *janela, uint16_t *media_mm) {
+    if (janela->leituras_validas == 0) return false;
+    *media_mm = janela->soma / janela->leituras_validas;
+    return true;
+}
+
+void monitor_acionar_saidas(bool alerta) {
+    gpio_put(RELER_PIN, alerta);
+    gpio_put(LED_VERMELHO_PIN, alerta);
+    gpio_put(LED_VERDE_PIN, !alerta);
+}
+
+bool monitor_decidir(SystemState *estado, uint16_t media_mm) {
+    SystemState anterior = *estado;
+    metricas_definir(METRICA_DISTANCIA_MM, media_mm);
+
+    *estado = intertravamento_acionado() ? ESTADO_ALERTA_ATIVO : ESTADO_ANALISANDO;
+    metricas_definir(METRICA_ESTADO, *estado);
+    return *estado != anterior;
+}
+
+void monitor_publicar_medicao(uint16_t media_mm) {
+    char msg[8];
+    snprintf(msg, sizeof(msg), "%u", media_mm);
+    mqtt_publicar(TOPICO_MEDICOES, msg);
+}
+
+void monitor_publicar_estado(SystemState estado) {
+    mqtt_publicar(TOPICO_ALERTA, estado == ESTADO_ALERTA_ATIVO ? "Anomalia Detectada!" : "Sem Anomalias");
+}
@@ -0,0 +1,91 @@
+// monitor.h - Etapas do ciclo de medição (leitura, média, decisão, publicação)
+
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "i2c_bus.h"
+
+typedef enum {
+    ESTADO_ANALISANDO,
+    ESTADO_ALERTA_ATIVO
+} SystemState;
+
+// Acumulador de uma janela de MONITOR_AMOSTRAS_JANELA leituras
+typedef struct {
+    uint32_t soma;
+    uint16_t leituras_validas;
+    uint16_t min_mm;
+    uint16_t max_mm;
+    uint32_t soma_qualidade;
+    uint16_t leituras_descartadas; // reprovadas na qualidade ou com erro, entre as válidas da janela
+} monitor_janela_t;
+
+/**
+ * @brief Inicializa o sensor VL53L0X e dispara a primeira medição.
+ */
+void monitor_iniciar();
+
+/**
+ * @brief Faz uma leitura de distância (inicia a medição, espera o sensor e lê o resultado).
+ *
+ * @param distancia_mm Recebe a distância em milímetros.
+ * @param qualidade    Recebe a nota da leitura (vl53l0x_qualidade), de QUALIDADE_MINIMA a 100.
+ * @return true se a leitura foi obtida e aprovada.
+ */
+bool monitor_ler_amostra(uint16_t *distancia_mm, uint8_t *qualidade);
+
+typedef enum {
+    MONITOR_AMOSTRA_PENDENTE, // medição ainda em andamento
+    MONITOR_AMOSTRA_VALIDA,
+    MONITOR_AMOSTRA_INVALIDA  // erro de I2C, prazo vencido ou nota abaixo de QUALIDADE_MINIMA
+} monitor_amostra_t;
+
+/**
+ * @brief Versão sem espera de monitor_ler_amostra(), para a IRQ do intertravamento.
+ *
+ * Consulta o sensor uma vez; com o resultado pronto (ou vencido o prazo), lê a distância e
+ * dispara a próxima medição. A distância e a nota só valem com MONITOR_AMOSTRA_VALIDA.
+ */
+monitor_amostra_t monitor_coletar_amostra(uint16_t *distancia_mm, uint8_t *qualidade);
+
+void monitor_janela_limpar(monitor_janela_t *janela);
+void monitor_janela_adicionar(monitor_janela_t *janela, uint16_t distancia_mm, uint8_t qualidade);
+void monitor_janela_descartar(monitor_janela_t *janela, uint16_t leituras);
+
+/**
+ * @brief Confiança da janela, de 0 a 100: a nota média de todas as leituras, com as
+ *        descartadas valendo 0.
+ */
+uint8_t monitor_janela_confianca(const monitor_janela_t *janela);
+
+/**
+ * @brief Calcula a média da janela.
+ *
+ * @return false se a janela não tem nenhuma leitura válida.
+ */
+bool monitor_janela_media(const monitor_janela_t *janela, uint16_t *media_mm);
+
+/**
+ * @brief Liga ou desliga relé e LEDs (só escreve nos GPIOs: pode ser chamada de IRQ).
+ */
+void monitor_acionar_saidas(bool alerta);
+
+/**
+ * @brief Atualiza o estado do sistema a partir do relé, decidido leitura a leitura pelo
+ * intertravamento (intertravamento.c), e registra a média da janela.
+ *
+ * @return true se o estado mudou (e o alerta precisa ser publicado).
+ */
+bool monitor_decidir(SystemState *estado, uint16_t media_mm);
+
+/**
+ * @brief Contadores de NACKs, timeouts e recuperações do barramento do sensor.
+ */
+const i2c_bus_contadores_t *monitor_contadores_i2c();
+
+void monitor_publicar_medicao(uint16_t media_mm);
+void monitor_publicar_estado(SystemState estado);
+
+#endif // MONITOR_H
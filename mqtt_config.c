@@ -2,14 +2,71 @@
 
 #include "config.h"
 #include "mqtt_config.h"
+#include "energia.h"
+#include "metricas.h"
+#include "ota.h"
+#include "registro.h"
 #include "lwip/apps/mqtt.h"
+#include "pico/unique_id.h"
 
 static mqtt_client_t *client;
 static volatile bool g_comando_ack_recebido = false; // A "bandeira"
+static volatile bool conectando = false;
+static absolute_time_t proxima_tentativa;
+static bool ja_publicou = false;
+static volatile bool nascimento_pendente = false; // levantada no callback, publicada no laço
+
+// Identidade do nó, montada uma vez: o mesmo firmware serve a frota inteira
+static char id_no[2 * PICO_UNIQUE_BOARD_ID_SIZE_BYTES + 1];
+static char client_id[sizeof(MQTT_CLIENT_PREFIXO) + sizeof(id_no)];
+static char prefixo[sizeof(TOPICO_RAIZ) + sizeof(id_no) + 1];        // TOPICO_RAIZ/<id>/
+static char topico_status[sizeof(prefixo) + sizeof(TOPICO_STATUS) - 1]; // vive enquanto o lwIP monta o CONNECT
+static_assert(sizeof(topico_status) <= TOPICO_MAX, "TOPICO_MAX não comporta o tópico de status");
+
+static const char *const ultima_vontade = "{\"estado\":\"offline\"}";
+
+static void montar_identidade() {
+    if (id_no[0]) return;
+    if (MQTT_ID_FIXO[0]) {
+        snprintf(id_no, sizeof(id_no), "%s", MQTT_ID_FIXO);
+    } else {
+        pico_get_unique_board_id_string(id_no, sizeof(id_no));
+    }
+    snprintf(client_id, sizeof(client_id), MQTT_CLIENT_PREFIXO "%s", id_no);
+    snprintf(prefixo, sizeof(prefixo), TOPICO_RAIZ "/%s/", id_no);
+    snprintf(topico_status, sizeof(topico_status), "%s" TOPICO_STATUS, prefixo);
+    printf("[MQTT] Nó %s, tópicos em %s\n", client_id, prefixo);
+}
+
+const char *mqtt_id_no() {
+    montar_identidade();
+    return id_no;
+}
+
+static bool topico_completo(const char *sufixo, char *topico) {
+    int n = snprintf(topico, TOPICO_MAX, "%s%s", prefixo, sufixo);
+    return n > 0 && n < TOPICO_MAX;
+}
+
+// Sufixo de um tópico recebido, ou NULL se não é deste nó
+static const char *sufixo_do_topico(const char *topico) {
+    size_t n = strlen(prefixo);
+    return strncmp(topico, prefixo, n) == 0 ? topico + n : NULL;
+}
+
+// Tópico da mensagem em recepção: o lwIP informa o tópico uma vez e entrega os dados em fragmentos
+static enum { ENTRADA_CONEXAO, ENTRADA_OTA, ENTRADA_OUTRA } entrada;
 
 static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags) {
+    if (entrada == ENTRADA_OTA) {
+        ota_mensagem_receber(data, len, flags & MQTT_DATA_FLAG_LAST);
+        return;
+    }
+    if (entrada != ENTRADA_CONEXAO) return;
+
     char payload[20];
-    strncpy(payload, (const char *)data, len);
+    if (len >= sizeof(payload)) len = sizeof(payload) - 1;
+    memcpy(payload, data, len);
     payload[len] = '\0';
 
     if (strcmp(payload, "ACK") == 0) {
@@ -18,28 +75,88 @@ static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t f
 }
 
 static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len) {
-    // Apenas para debug, se necessário
+    const char *sufixo = sufixo_do_topico(topic);
+    if (sufixo && strcmp(sufixo, TOPICO_OTA_BLOCO) == 0) {
+        entrada = ENTRADA_OTA;
+        ota_mensagem_iniciar(tot_len);
+    } else {
+        entrada = sufixo && strcmp(sufixo, TOPICO_CONEXAO) == 0 ? ENTRADA_CONEXAO : ENTRADA_OUTRA;
+    }
+}
+
+// Só do laço principal: o anel de saída do cliente MQTT é do lwIP, que roda em IRQ (threadsafe_background)
+static bool enviar(const char *sufixo, const char *mensagem, u8_t retido, mqtt_request_cb_t cb, void *arg) {
+    char topico[TOPICO_MAX];
+    err_t err = ERR_CONN;
+    if (client && topico_completo(sufixo, topico)) {
+        cyw43_arch_lwip_begin();
+        if (mqtt_client_is_connected(client)) {
+            err = mqtt_publish(client, topico, mensagem, strlen(mensagem), 1, retido, cb, arg);
+        }
+        cyw43_arch_lwip_end();
+    }
+    metricas_incrementar(err == ERR_OK ? METRICA_PUBLICACOES : METRICA_PUBLICACOES_FALHAS);
+    if (err == ERR_OK) energia_transmitiu();
+    return err == ERR_OK;
+}
+
+// Mensagem de nascimento: substitui a última vontade retida assim que o nó volta
+static void publicar_nascimento() {
+    char msg[128];
+    snprintf(msg, sizeof(msg), "{\"estado\":\"online\",\"cliente\":\"%s\",\"ip\":\"%s\",\"boot_ms\":%lu}", client_id,
+             ip4addr_ntoa(netif_ip4_addr(&cyw43_state.netif[CYW43_ITF_STA])),
+             (unsigned long)to_ms_since_boot(get_absolute_time()));
+    enviar(TOPICO_STATUS, msg, 1, NULL, NULL);
+}
+
+static void assinar(mqtt_client_t *client, const char *sufixo, u8_t qos) {
+    char topico[TOPICO_MAX];
+    if (topico_completo(sufixo, topico)) mqtt_subscribe(client, topico, qos, NULL, NULL);
 }
 
 static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection_status_t status) {
+    conectando = false;
     if (status == MQTT_CONNECT_ACCEPTED) {
-        printf("[MQTT] Conectado ao broker!\n");
-        mqtt_subscribe(client, TOPICO_CONEXAO, 0, NULL, NULL);
+        REGISTRAR(MQTT_CONECTADO);
+        nascimento_pendente = true; // aqui é IRQ do lwIP: a publicação fica para mqtt_processar()
+        assinar(client, TOPICO_CONEXAO, 0);
+        assinar(client, TOPICO_OTA_BLOCO, 1);
+        ota_conectado();
     } else {
-        printf("[MQTT] Falha na conexao: %d\n", status);
+        REGISTRAR(MQTT_FALHA, status);
     }
 }
 
 void mqtt_iniciar() {
+    if (conectando || mqtt_esta_conectado() || !time_reached(proxima_tentativa)) return;
+    proxima_tentativa = make_timeout_time_ms(MQTT_RETENTATIVA_MS);
+
     ip_addr_t broker_ip;
     ip4addr_aton(MQTT_BROKER_IP, &broker_ip);
 
-    client = mqtt_client_new();
+    if (!client) {
+        montar_identidade();
+        client = mqtt_client_new();
+        mqtt_set_inpub_callback(client, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, NULL);
+    }
     struct mqtt_connect_client_info_t ci = {0};
-    ci.client_id = MQTT_CLIENT_ID;
+    ci.client_id = client_id;
+    ci.keep_alive = MQTT_KEEPALIVE_S;
+    ci.will_topic = topico_status;
+    ci.will_msg = ultima_vontade;
+    ci.will_msg_len = (u8_t)strlen(ultima_vontade);
+    ci.will_qos = 1;
+    ci.will_retain = 1;
 
-    mqtt_set_inpub_callback(client, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, NULL);
-    mqtt_client_connect(client, &broker_ip, MQTT_BROKER_PORT, mqtt_connection_cb, NULL, &ci);
+    cyw43_arch_lwip_begin();
+    conectando = mqtt_client_connect(client, &broker_ip, MQTT_BROKER_PORT, mqtt_connection_cb, NULL, &ci) == ERR_OK;
+    cyw43_arch_lwip_end();
+}
+
+void mqtt_processar() {
+    if (!nascimento_pendente) return;
+    nascimento_pendente = false;
+    publicar_nascimento();
 }
 
 bool mqtt_comando_ack_recebido() {
@@ -50,9 +167,26 @@ bool mqtt_comando_ack_recebido() {
     return false;
 }
 
-void mqtt_publicar(const char *topico, const char *mensagem) {
-    if (!client || !mqtt_client_is_connected(client)) return;
-    mqtt_publish(client, topico, mensagem, strlen(mensagem), 1, 0, NULL, NULL);
+static void publicar(const char *sufixo, const char *mensagem, u8_t retido, mqtt_request_cb_t cb, void *arg) {
+    if (enviar(sufixo, mensagem, retido, cb, arg) && !ja_publicou) {
+        ja_publicou = true;
+        uint32_t ms = to_ms_since_boot(get_absolute_time());
+        metricas_definir(METRICA_BOOT_PUBLICACAO_MS, ms);
+        REGISTRAR(BOOT_PUBLICACAO, ms);
+    }
+}
+
+void mqtt_publicar(const char *sufixo, const char *mensagem) { publicar(sufixo, mensagem, 0, NULL, NULL); }
+
+void mqtt_publicar_retido(const char *sufixo, const char *mensagem) { publicar(sufixo, mensagem, 1, NULL, NULL); }
+
+// PUBACK do broker (ou o pedido expirou), na IRQ do lwIP
+static void confirmado_cb(void *arg, err_t resultado) {
+    if (resultado == ERR_OK) *(volatile bool *)arg = true;
+}
+
+void mqtt_publicar_retido_confirmado(const char *sufixo, const char *mensagem, volatile bool *confirmado) {
+    publicar(sufixo, mensagem, 1, confirmado_cb, (void *)confirmado);
 }
 
 bool mqtt_esta_conectado() { return client && mqtt_client_is_connected(client); }
\ No newline at end of file
@@ -5,9 +5,20 @@
 
 #include <stdbool.h>
 
+// Inicia (ou tenta de novo, no máximo a cada MQTT_RETENTATIVA_MS) a conexão ao broker
+// Na primeira chamada monta client ID e tópicos a partir do id único da placa
 void mqtt_iniciar();
-void mqtt_publicar(const char *topico, const char *mensagem);
+// Publica, do laço, o que os callbacks do lwIP deixaram pendente (mensagem de nascimento)
+void mqtt_processar();
+// 'sufixo' é um dos TOPICO_* de config.h; o tópico publicado é TOPICO_RAIZ/<id>/<sufixo>
+void mqtt_publicar(const char *sufixo, const char *mensagem);
+// O broker guarda a última mensagem e a entrega a quem assinar depois (estado, não evento)
+void mqtt_publicar_retido(const char *sufixo, const char *mensagem);
+// Como mqtt_publicar_retido(); 'confirmado' vira true quando o broker confirma o recebimento
+void mqtt_publicar_retido_confirmado(const char *sufixo, const char *mensagem, volatile bool *confirmado);
 bool mqtt_esta_conectado();
+// Id do nó nos tópicos (id único da placa ou MQTT_ID_FIXO)
+const char *mqtt_id_no();
 
 // A função correta que verifica se o comando 'ACK' foi recebido
 bool mqtt_comando_ack_recebido();
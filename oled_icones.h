@@ -0,0 +1,32 @@
+// oled_icones.h - Logotipo e ícones de estado no formato de página do SSD1306
+
+#ifndef OLED_ICONES_H
+#define OLED_ICONES_H
+
+#include "ssd1306_blit.h"
+
+// Boto (golfinho-do-rio), 32x16
+static const uint8_t icone_boto_dados[] = {
+    0x00, 0x00, 0x80, 0xC0, 0xC0, 0x60, 0xE0, 0xF0, 0xF0, 0xF0, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8,
+    0xFC, 0xFE, 0xFE, 0xFC, 0xF8, 0xF0, 0xF0, 0xF0, 0xE0, 0xE0, 0xE0, 0xC0, 0xC0, 0x00, 0x00, 0x00,
+    0x02, 0x07, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x0F, 0x07, 0x07, 0x07, 0x07, 0x03, 0x03, 0x01, 0x01,
+    0x01, 0x01, 0x01, 0x01, 0x81, 0xC3, 0x43, 0x67, 0x2F, 0x3F, 0x7F, 0xFF, 0x1F, 0x0F, 0x06, 0x00,
+};
+
+// Triângulo de alerta, 16x16
+static const uint8_t icone_alerta_dados[] = {
+    0x00, 0x00, 0x00, 0x80, 0xE0, 0x38, 0x0E, 0xF3, 0xF3, 0x0E, 0x38, 0xE0, 0x80, 0x00, 0x00, 0x00,
+    0x60, 0x78, 0x4E, 0x43, 0x40, 0x40, 0x40, 0x5B, 0x5B, 0x40, 0x40, 0x40, 0x43, 0x4E, 0x78, 0x60,
+};
+
+// Marca de verificação (sem anomalias), 16x16
+static const uint8_t icone_ok_dados[] = {
+    0x80, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xC0, 0xE0, 0x70, 0x38, 0x1C, 0x0C,
+    0x01, 0x03, 0x07, 0x0E, 0x1C, 0x38, 0x1C, 0x0E, 0x07, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const ssd1306_sprite_t icone_boto   = {32, 16, icone_boto_dados};
+static const ssd1306_sprite_t icone_alerta = {16, 16, icone_alerta_dados};
+static const ssd1306_sprite_t icone_ok     = {16, 16, icone_ok_dados};
+
+#endif // OLED_ICONES_H
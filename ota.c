@@ -0,0 +1,355 @@
+// ota.c - Imagem nova no slot B, diário de estado em flash, pedido de troca ao estágio de boot e rollback
+
+#include "config.h"
+#include "ota.h"
+#include "ota_troca.h"
+#include "crc32.h"
+#include "mqtt_config.h"
+#include "hardware/flash.h"
+#include "hardware/watchdog.h"
+#include "pico/flash.h"
+#include <stddef.h>
+#include <string.h>
+
+typedef enum {
+    OTA_OCIOSO,
+    OTA_RECEBENDO,
+    OTA_PRONTA,     // imagem completa e verificada no slot B; troca pendente
+    OTA_EM_TESTE,   // slots trocados, a imagem nova ainda não confirmou
+    OTA_REVERTIDA,  // a imagem nova não confirmou e a anterior voltou
+} ota_fase_t;
+
+static const char *const nomes_fase[] = {"ocioso", "recebendo", "pronta", "em_teste", "revertida"};
+
+static ota_registro_t estado;
+static bool watchdog_ligado;
+static absolute_time_t prazo_confirmacao;
+static bool reversao_pendente;        // o pedido de volta à imagem anterior não pôde ser gravado
+static absolute_time_t prazo_aplicar; // fim da espera pela confirmação do estado "aplicando"
+static volatile bool aplicando_confirmado;
+static const char *evento = "";
+
+static void ota_publicar_estado();
+static const char *montar_estado();
+
+// Recepção: escrito no contexto do lwIP, consumido pelo laço principal via setor_pronto
+static struct {
+    uint8_t setor[FLASH_SECTOR_SIZE];
+    volatile bool setor_pronto;  // setor cheio (ou fim da imagem) esperando gravação
+    volatile bool publicar;      // o transmissor precisa saber onde retomar
+    bool ativa;                  // há uma transferência em andamento
+    uint32_t id, tamanho, crc_imagem;
+    uint32_t base;               // offset na imagem do início de setor[]
+    uint32_t preenchido;         // bytes já confirmados em setor[]
+
+    // mensagem em montagem
+    ota_cabecalho_t cab;
+    uint32_t total;
+    uint32_t recebidos;
+    uint32_t crc;
+    bool valida;
+} rx;
+
+typedef struct {
+    uint32_t offset;   // setor apagado antes da gravação
+    const uint8_t *dados;
+    size_t tamanho;
+} gravacao_t;
+
+// Roda via flash_safe_execute(): XIP parado, o outro core travado, sem interrupções
+static void gravar(void *param) {
+    const gravacao_t *g = param;
+    flash_range_erase(g->offset, FLASH_SECTOR_SIZE);
+    flash_range_program(g->offset, g->dados, g->tamanho);
+}
+
+static void diario_ler() {
+    const ota_registro_t *diario = (const ota_registro_t *)(XIP_BASE + OTA_DIARIO_OFFSET);
+    memset(&estado, 0, sizeof(estado));
+    for (uint i = 0; i < OTA_REGISTROS_POR_SETOR; i++) {
+        const ota_registro_t *r = &diario[i];
+        if (r->magica == 0xFFFFFFFFu) break;
+        // Um registro cortado por queda de energia não passa no CRC e é ignorado
+        if (r->magica == OTA_MAGICA_DIARIO && r->crc == crc32_calcular(r, offsetof(ota_registro_t, crc))) {
+            estado = *r;
+        }
+    }
+}
+
+static void acrescentar_estado(void *param) {
+    (void)param;
+    ota_diario_acrescentar(&estado);
+}
+
+static bool diario_gravar() {
+    return flash_safe_execute(acrescentar_estado, NULL, FLASH_SEGURA_TIMEOUT_MS) == PICO_OK;
+}
+
+static void __attribute__((noreturn)) reiniciar_agora() {
+    watchdog_reboot(0, 0, 0);
+    while (true) {
+    }
+}
+
+// Pede ao estágio de boot a troca dos primeiros setores dos slots A e B e reinicia. A troca em
+// si não roda aqui: o firmware fica no slot A, que ela sobrescreve, e o estágio de boot a retoma
+// de onde parou se a energia cair. Só retorna se o pedido não pôde ser gravado.
+static bool trocar_slots(ota_fase_t nova_fase, uint16_t setores) {
+    static uint8_t pagina[FLASH_PAGE_SIZE];
+    ota_registro_t final = estado;
+    final.fase = nova_fase;
+    final.setores = setores;
+    final.tentativas = 0;
+    ota_troca_preparar(pagina, setores, &final);
+    gravacao_t g = {OTA_PROGRESSO_OFFSET, pagina, FLASH_PAGE_SIZE};
+    if (flash_safe_execute(gravar, &g, FLASH_SEGURA_TIMEOUT_MS) != PICO_OK) return false;
+
+    printf("[ota] Trocando %u setores no estágio de boot (%s)\n", setores, nomes_fase[nova_fase]);
+    watchdog_enable(OTA_WATCHDOG_MS, true); // cobre o reinício até o estágio de boot rearmá-lo
+    reiniciar_agora();
+}
+
+static uint32_t tamanho_imagem_atual() {
+#if PICO_ON_DEVICE
+    extern char __flash_binary_end;
+    return (uint32_t)((uintptr_t)&__flash_binary_end - (XIP_BASE + OTA_SLOT_A_OFFSET));
+#else
+    return 0; // na simulação o slot A só guarda o que uma OTA anterior pôs lá
+#endif
+}
+
+static uint16_t setores_para(uint32_t bytes) {
+    return (uint16_t)((bytes + FLASH_SECTOR_SIZE - 1) / FLASH_SECTOR_SIZE);
+}
+
+void ota_iniciar() {
+    diario_ler();
+    watchdog_disable(); // o estágio de boot o deixa armado depois de uma troca; só a imagem em teste o usa
+
+    switch (estado.fase) {
+    case OTA_RECEBENDO:
+        // Retoma do último setor gravado; o que estava só na RAM é pedido de novo
+        rx.ativa = true;
+        rx.id = estado.id;
+        rx.tamanho = estado.tamanho;
+        rx.crc_imagem = estado.crc_imagem;
+        rx.base = estado.recebido;
+        break;
+
+    case OTA_EM_TESTE:
+        if (estado.tentativas >= OTA_MAX_TENTATIVAS) {
+            printf("[ota] Imagem %08lx não confirmou em %u boots, voltando à anterior\n",
+                   (unsigned long)estado.id, estado.tentativas);
+            trocar_slots(OTA_REVERTIDA, estado.setores);
+            // Não gravou o pedido: esta imagem segue rodando sem contar boot nem watchdog,
+            // e o laço tenta de novo em ota_processar()
+            printf("[ota] Pedido de volta não gravado, tentando no laço\n");
+            reversao_pendente = true;
+            evento = "erro_reversao";
+            break;
+        }
+        estado.tentativas++;
+        diario_gravar();
+        watchdog_enable(OTA_WATCHDOG_MS, true);
+        watchdog_ligado = true;
+        prazo_confirmacao = make_timeout_time_ms(OTA_PRAZO_CONFIRMACAO_MS);
+        break;
+
+    default:
+        break;
+    }
+}
+
+static bool aceitar_cabecalho() {
+    const ota_cabecalho_t *c = &rx.cab;
+    uint32_t dados = rx.total - sizeof(ota_cabecalho_t);
+    if (c->magica != OTA_MAGICA_BLOCO || c->tamanho == 0 || c->tamanho > OTA_SLOT_TAMANHO) return false;
+
+    // O slot B guarda a imagem anterior até a nova confirmar
+    if (estado.fase == OTA_EM_TESTE) {
+        rx.publicar = true;
+        return false;
+    }
+
+    if (!rx.ativa || c->id != rx.id) {
+        if (c->offset != 0) {
+            rx.publicar = true;
+            return false;
+        }
+        // Imagem nova: recomeça; o diário muda quando o primeiro setor for gravado
+        rx.ativa = true;
+        rx.id = c->id;
+        rx.tamanho = c->tamanho;
+        rx.crc_imagem = c->crc_imagem;
+        rx.base = 0;
+        rx.preenchido = 0;
+    }
+    if (c->tamanho != rx.tamanho || c->crc_imagem != rx.crc_imagem) return false;
+
+    // Duplicado (QoS 1) ou fora de ordem: o transmissor recebe o estado e retoma de lá
+    if (c->offset != rx.base + rx.preenchido) {
+        rx.publicar = true;
+        return false;
+    }
+    return rx.preenchido + dados <= FLASH_SECTOR_SIZE && c->offset + dados <= c->tamanho;
+}
+
+void ota_mensagem_iniciar(uint32_t tamanho_total) {
+    rx.total = tamanho_total;
+    rx.recebidos = 0;
+    rx.crc = 0;
+    // Enquanto o setor anterior não foi gravado, nada novo entra no buffer
+    rx.valida = !rx.setor_pronto && tamanho_total > sizeof(ota_cabecalho_t) &&
+                tamanho_total - sizeof(ota_cabecalho_t) <= FLASH_SECTOR_SIZE;
+}
+
+void ota_mensagem_receber(const uint8_t *dados, uint16_t tamanho, bool ultimo) {
+    // O cabeçalho pode chegar dividido entre fragmentos
+    while (tamanho && rx.recebidos < sizeof(ota_cabecalho_t)) {
+        ((uint8_t *)&rx.cab)[rx.recebidos++] = *dados++;
+        tamanho--;
+        if (rx.recebidos == sizeof(ota_cabecalho_t)) rx.valida = rx.valida && aceitar_cabecalho();
+    }
+
+    if (tamanho && rx.valida) {
+        uint32_t pos = rx.preenchido + rx.recebidos - sizeof(ota_cabecalho_t);
+        if (pos + tamanho <= FLASH_SECTOR_SIZE) {
+            memcpy(rx.setor + pos, dados, tamanho);
+            rx.crc = crc32_atualizar(rx.crc, dados, tamanho);
+        } else {
+            rx.valida = false;
+        }
+    }
+    rx.recebidos += tamanho;
+
+    if (!ultimo) return;
+    if (!rx.valida || rx.recebidos != rx.total || rx.crc != rx.cab.crc_bloco) {
+        if (rx.ativa) rx.publicar = true;
+        return;
+    }
+    rx.preenchido += rx.total - sizeof(ota_cabecalho_t);
+    if (rx.preenchido == FLASH_SECTOR_SIZE || rx.base + rx.preenchido == rx.tamanho) rx.setor_pronto = true;
+}
+
+static void verificar_imagem() {
+    uint32_t crc = crc32_calcular((const void *)(XIP_BASE + OTA_SLOT_B_OFFSET), estado.tamanho);
+    rx.ativa = false;
+    if (crc == estado.crc_imagem) {
+        printf("[ota] Imagem %08lx completa e verificada\n", (unsigned long)estado.id);
+        estado.fase = OTA_PRONTA;
+        evento = "";
+    } else {
+        printf("[ota] CRC da imagem %08lx não confere, descartada\n", (unsigned long)estado.id);
+        estado.fase = OTA_OCIOSO;
+        estado.recebido = 0;
+        evento = "erro_crc";
+    }
+}
+
+static void gravar_setor() {
+    memset(rx.setor + rx.preenchido, 0xFF, FLASH_SECTOR_SIZE - rx.preenchido);
+    uint32_t destino = OTA_SLOT_B_OFFSET + rx.base;
+    gravacao_t g = {destino, rx.setor, FLASH_SECTOR_SIZE};
+    if (flash_safe_execute(gravar, &g, FLASH_SEGURA_TIMEOUT_MS) != PICO_OK) return; // tenta na próxima volta
+
+    estado.fase = OTA_RECEBENDO;
+    estado.id = rx.id;
+    estado.tamanho = rx.tamanho;
+    estado.crc_imagem = rx.crc_imagem;
+    estado.recebido = rx.base + rx.preenchido;
+    estado.tentativas = 0;
+    rx.base += FLASH_SECTOR_SIZE;
+    rx.preenchido = 0;
+    if (estado.recebido == estado.tamanho) verificar_imagem();
+    diario_gravar();
+
+    rx.setor_pronto = false;
+    rx.publicar = true;
+}
+
+static void confirmar() {
+    printf("[ota] Imagem %08lx confirmada\n", (unsigned long)estado.id);
+    estado.fase = OTA_OCIOSO;
+    estado.tentativas = 0;
+    diario_gravar();
+    watchdog_disable();
+    watchdog_ligado = false;
+    evento = "confirmada";
+    rx.publicar = true;
+}
+
+void ota_processar(bool pode_gravar, bool saudavel) {
+    if (watchdog_ligado) watchdog_update();
+
+    // O setor pronto segura o próximo bloco (ota_mensagem_iniciar()): o transmissor só espera
+    if (rx.setor_pronto && pode_gravar) gravar_setor();
+
+    switch (estado.fase) {
+    case OTA_PRONTA:
+        if (!pode_gravar || !mqtt_esta_conectado()) break;
+        // "aplicando" sai primeiro; a troca espera o PUBACK (ou o prazo) sem prender o laço
+        if (strcmp(evento, "aplicando") != 0) {
+            evento = "aplicando";
+            aplicando_confirmado = false;
+            prazo_aplicar = make_timeout_time_ms(OTA_ESPERA_PUBLICACAO_MS);
+            mqtt_publicar_retido_confirmado(TOPICO_OTA_ESTADO, montar_estado(), &aplicando_confirmado);
+            break;
+        }
+        if (!aplicando_confirmado && !time_reached(prazo_aplicar)) break;
+        {
+            uint32_t maior = estado.tamanho > tamanho_imagem_atual() ? estado.tamanho : tamanho_imagem_atual();
+            trocar_slots(OTA_EM_TESTE, setores_para(maior));
+        }
+        evento = "erro_troca"; // o pedido não foi gravado: tenta na próxima volta
+        rx.publicar = true;
+        break;
+
+    case OTA_EM_TESTE:
+        if (reversao_pendente) {
+            if (pode_gravar) trocar_slots(OTA_REVERTIDA, estado.setores);
+            break;
+        }
+        if (!pode_gravar) {
+            // Com o nível alto a confirmação não pode gravar o diário e reiniciar soltaria o
+            // relé: o prazo recomeça até o intertravamento liberar a flash. Um travamento ainda
+            // cai no watchdog, alimentado só por este laço.
+            prazo_confirmacao = make_timeout_time_ms(OTA_PRAZO_CONFIRMACAO_MS);
+        } else if (saudavel) {
+            confirmar();
+        } else if (time_reached(prazo_confirmacao)) {
+            printf("[ota] Sem confirmação no prazo, reiniciando\n");
+            reiniciar_agora(); // o próximo boot conta mais uma tentativa
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if (rx.publicar) {
+        rx.publicar = false;
+        ota_publicar_estado();
+    }
+}
+
+static const char *montar_estado() {
+    static char msg[128];
+    bool recebendo = ota_recebendo();
+    snprintf(msg, sizeof(msg), "{\"id\":%lu,\"fase\":\"%s\",\"proximo\":%lu,\"tamanho\":%lu,\"evento\":\"%s\"}",
+             (unsigned long)(recebendo ? rx.id : estado.id), recebendo ? "recebendo" : nomes_fase[estado.fase],
+             (unsigned long)(recebendo ? rx.base + rx.preenchido : estado.recebido),
+             (unsigned long)(recebendo ? rx.tamanho : estado.tamanho), evento);
+    return msg;
+}
+
+static void ota_publicar_estado() {
+    mqtt_publicar_retido(TOPICO_OTA_ESTADO, montar_estado());
+}
+
+void ota_conectado() {
+    rx.publicar = true;
+}
+
+bool ota_recebendo() {
+    return rx.ativa && estado.fase != OTA_EM_TESTE;
+}
@@ -0,0 +1,66 @@
+// ota.h - Atualização remota: imagem recebida em blocos via MQTT, gravada no slot de espera
+
+#ifndef OTA_H
+#define OTA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Cabeçalho de cada bloco publicado em TOPICO_OTA_BLOCO (little-endian),
+ *        seguido pelos dados. Um bloco nunca atravessa a fronteira de um setor de 4 KB.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t magica;      // OTA_MAGICA_BLOCO
+    uint32_t id;          // identifica a imagem; um id novo recomeça a transferência
+    uint32_t tamanho;     // tamanho total da imagem (.bin)
+    uint32_t crc_imagem;  // CRC-32 da imagem inteira
+    uint32_t offset;      // posição deste bloco na imagem
+    uint32_t crc_bloco;   // CRC-32 dos dados deste bloco
+} ota_cabecalho_t;
+
+#define OTA_MAGICA_BLOCO 0x3141544Fu // "OTA1"
+
+/**
+ * @brief Lê o diário de OTA e trata o boot: conta a tentativa de uma imagem em teste (liga o
+ *        watchdog) ou, esgotadas as tentativas, pede a volta à imagem anterior.
+ *
+ * A troca de slots em si é do estágio de boot (boot/boot_ota.c), antes do firmware. Chamar no
+ * início de main(), antes dos periféricos e do core 1: o pedido de volta grava a flash e
+ * reinicia sem retornar.
+ */
+void ota_iniciar();
+
+/**
+ * @brief Início de uma mensagem em TOPICO_OTA_BLOCO (contexto do lwIP).
+ */
+void ota_mensagem_iniciar(uint32_t tamanho_total);
+
+/**
+ * @brief Fragmento da mensagem atual, como entregue pelo cliente MQTT (contexto do lwIP).
+ *        Só copia para o buffer do setor; a flash é gravada em ota_processar().
+ */
+void ota_mensagem_receber(const uint8_t *dados, uint16_t tamanho, bool ultimo);
+
+/**
+ * @brief Trabalho do laço principal: grava o setor completo, publica o progresso,
+ *        verifica a imagem e aplica a troca; confirma ou desiste de uma imagem em teste.
+ *
+ * @param pode_gravar    false enquanto parar as interrupções para gravar a flash (setor, diário,
+ *                       troca de slots) puser o intertravamento em risco: tudo isso espera.
+ * @param saudavel       o nó está funcionando (MQTT conectado e leituras válidas): confirma a imagem em teste.
+ */
+void ota_processar(bool pode_gravar, bool saudavel);
+
+/**
+ * @brief Conexão ao broker estabelecida: o estado (retido) é republicado em TOPICO_OTA_ESTADO
+ *        na próxima ota_processar(), para o transmissor saber de onde retomar.
+ */
+void ota_conectado();
+
+/**
+ * @brief true enquanto uma imagem está chegando (a rede deve ficar em baixa latência).
+ */
+bool ota_recebendo();
+
+#endif // OTA_H
@@ -0,0 +1,110 @@
+// ota_troca.c - Troca de slots retomável e diário da OTA, comuns ao firmware e ao estágio de boot
+
+#include "ota_troca.h"
+#include "crc32.h"
+#include <stddef.h>
+#include <string.h>
+
+static_assert(OTA_SLOT_TAMANHO % FLASH_SECTOR_SIZE == 0, "o slot deve ter setores inteiros");
+static_assert(OTA_BOOT_TAMANHO % FLASH_SECTOR_SIZE == 0, "o estágio de boot deve ter setores inteiros");
+static_assert(OTA_SLOT_B_OFFSET + OTA_SLOT_TAMANHO <= OTA_RASCUNHO_OFFSET, "o slot B invade o rascunho da troca");
+static_assert(sizeof(ota_registro_t) == 32, "registro do diário com padding inesperado");
+
+// Setor de progresso: página 0 com o pedido e, no último byte, a marca de concluída; a partir
+// da página 1, um byte por passo (0xFF pendente, 0x00 feito). Marcar só leva bits de 1 para 0,
+// então o setor é apagado uma vez por troca, no pedido.
+#define OTA_MAGICA_TROCA 0x5441524Fu
+#define PASSOS_POR_SETOR 3
+#define POS_CONCLUIDA    (FLASH_PAGE_SIZE - 1)
+#define POS_PASSOS       FLASH_PAGE_SIZE
+
+typedef struct {
+    uint32_t magica;
+    uint16_t setores;
+    uint16_t reservado;
+    ota_registro_t final;  // acrescentado ao diário quando a troca termina
+    uint32_t crc;
+} pedido_t;
+
+static_assert(sizeof(pedido_t) < POS_CONCLUIDA, "o pedido invade a marca de concluída");
+static_assert(POS_PASSOS + PASSOS_POR_SETOR * (OTA_SLOT_TAMANHO / FLASH_SECTOR_SIZE) <= FLASH_SECTOR_SIZE,
+              "os passos da troca não cabem no setor de progresso");
+
+static uint8_t setor_ram[FLASH_SECTOR_SIZE];
+static uint8_t pagina_ram[FLASH_PAGE_SIZE];
+
+static const uint8_t *flash(uint32_t offset) {
+    return (const uint8_t *)(XIP_BASE + offset);
+}
+
+static const pedido_t *pedido() {
+    return (const pedido_t *)flash(OTA_PROGRESSO_OFFSET);
+}
+
+// Grava um byte 0x00 numa página; o resto da página em 0xFF não altera o que já está nela
+static void marcar(uint32_t offset) {
+    memset(pagina_ram, 0xFF, sizeof(pagina_ram));
+    pagina_ram[offset % FLASH_PAGE_SIZE] = 0x00;
+    flash_range_program(offset - offset % FLASH_PAGE_SIZE, pagina_ram, FLASH_PAGE_SIZE);
+}
+
+void ota_diario_acrescentar(ota_registro_t *registro) {
+    registro->magica = OTA_MAGICA_DIARIO;
+    registro->crc = crc32_calcular(registro, offsetof(ota_registro_t, crc));
+
+    const ota_registro_t *diario = (const ota_registro_t *)flash(OTA_DIARIO_OFFSET);
+    uint32_t i = 0;
+    while (i < OTA_REGISTROS_POR_SETOR && diario[i].magica != 0xFFFFFFFFu) i++;
+    if (i == OTA_REGISTROS_POR_SETOR) {
+        flash_range_erase(OTA_DIARIO_OFFSET, FLASH_SECTOR_SIZE);
+        i = 0;
+    }
+    uint32_t pos = i * sizeof(ota_registro_t);
+    memset(pagina_ram, 0xFF, sizeof(pagina_ram));
+    memcpy(pagina_ram + pos % FLASH_PAGE_SIZE, registro, sizeof(*registro));
+    flash_range_program(OTA_DIARIO_OFFSET + pos - pos % FLASH_PAGE_SIZE, pagina_ram, FLASH_PAGE_SIZE);
+}
+
+void ota_troca_preparar(uint8_t *pagina, uint16_t setores, const ota_registro_t *final) {
+    pedido_t p = {.magica = OTA_MAGICA_TROCA, .setores = setores, .final = *final};
+    p.crc = crc32_calcular(&p, offsetof(pedido_t, crc));
+    memset(pagina, 0xFF, FLASH_PAGE_SIZE);
+    memcpy(pagina, &p, sizeof(p));
+}
+
+bool ota_troca_pendente() {
+    const pedido_t *p = pedido();
+    // Um pedido cortado por queda de energia não passa no CRC: a troca nem começou
+    return p->magica == OTA_MAGICA_TROCA && p->crc == crc32_calcular(p, offsetof(pedido_t, crc)) &&
+           p->setores <= OTA_SLOT_TAMANHO / FLASH_SECTOR_SIZE && flash(OTA_PROGRESSO_OFFSET)[POS_CONCLUIDA] == 0xFF;
+}
+
+// Copia um setor inteiro pela RAM: a origem é lida antes de o destino ser apagado
+static void copiar_setor(uint32_t destino, uint32_t origem) {
+    memcpy(setor_ram, flash(origem), FLASH_SECTOR_SIZE);
+    flash_range_erase(destino, FLASH_SECTOR_SIZE);
+    flash_range_program(destino, setor_ram, FLASH_SECTOR_SIZE);
+}
+
+void ota_troca_executar(void (*alimentar)(void)) {
+    pedido_t p = *pedido(); // cópia na RAM: o XIP some durante cada apagamento
+    const uint8_t *passos = flash(OTA_PROGRESSO_OFFSET + POS_PASSOS);
+
+    for (uint32_t n = 0; n < (uint32_t)p.setores * PASSOS_POR_SETOR; n++) {
+        if (passos[n] != 0xFF) continue;
+        alimentar();
+        uint32_t a = OTA_SLOT_A_OFFSET + n / PASSOS_POR_SETOR * FLASH_SECTOR_SIZE;
+        uint32_t b = OTA_SLOT_B_OFFSET + n / PASSOS_POR_SETOR * FLASH_SECTOR_SIZE;
+        switch (n % PASSOS_POR_SETOR) {
+        case 0: copiar_setor(OTA_RASCUNHO_OFFSET, a); break;
+        case 1: copiar_setor(a, b); break;
+        default: copiar_setor(b, OTA_RASCUNHO_OFFSET); break;
+        }
+        marcar(OTA_PROGRESSO_OFFSET + POS_PASSOS + n);
+    }
+
+    // Se cair entre as duas gravações, o próximo boot acrescenta o mesmo registro de novo
+    alimentar();
+    ota_diario_acrescentar(&p.final);
+    marcar(OTA_PROGRESSO_OFFSET + POS_CONCLUIDA);
+}
@@ -0,0 +1,72 @@
+// ota_troca.h - Mapa da flash da OTA e troca de slots retomável, feita pelo estágio de boot (boot/)
+
+#ifndef OTA_TROCA_H
+#define OTA_TROCA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "hardware/flash.h"
+
+// Mapa da flash (2 MB): estágio de boot | slot A (imagem em execução) | slot B (espera) | ... |
+// setor de rascunho | progresso da troca | diário OTA | cache de boot.
+// O estágio de boot nunca é regravado pela OTA; o firmware é ligado para rodar do slot A.
+#define OTA_BOOT_TAMANHO           (32 * 1024)  // igual a BOTOSMART_OTA_BOOT_KB no CMakeLists.txt
+#define OTA_SLOT_TAMANHO           (960 * 1024) // igual a BOTOSMART_OTA_SLOT_KB no CMakeLists.txt
+#define OTA_SLOT_A_OFFSET          ((uint32_t)OTA_BOOT_TAMANHO)
+#define OTA_SLOT_B_OFFSET          (OTA_SLOT_A_OFFSET + (uint32_t)OTA_SLOT_TAMANHO)
+#define OTA_RASCUNHO_OFFSET        ((uint32_t)(PICO_FLASH_SIZE_BYTES - 4 * FLASH_SECTOR_SIZE))
+#define OTA_PROGRESSO_OFFSET       ((uint32_t)(PICO_FLASH_SIZE_BYTES - 3 * FLASH_SECTOR_SIZE))
+#define OTA_DIARIO_OFFSET          ((uint32_t)(PICO_FLASH_SIZE_BYTES - 2 * FLASH_SECTOR_SIZE))
+#define OTA_TROCA_WATCHDOG_MS      8000 // watchdog do estágio de boot entre passos da troca
+
+// O diário é um setor de registros acrescentados em sequência; vale o último íntegro.
+// Só quando o setor enche ele é apagado, o que poupa a flash.
+#define OTA_MAGICA_DIARIO 0x4F544144u
+typedef struct {
+    uint32_t magica;
+    uint8_t fase;
+    uint8_t tentativas;   // boots da imagem em teste
+    uint16_t setores;     // setores trocados entre os slots, para poder desfazer
+    uint32_t id;
+    uint32_t tamanho;
+    uint32_t crc_imagem;
+    uint32_t recebido;    // bytes já gravados no slot B
+    uint32_t reservado;
+    uint32_t crc;
+} ota_registro_t;
+
+#define OTA_REGISTROS_POR_SETOR (FLASH_SECTOR_SIZE / sizeof(ota_registro_t))
+
+/**
+ * @brief Fecha o registro (mágica e CRC) e acrescenta no diário, apagando o setor se cheio.
+ *
+ * Chama flash_range_* direto: no firmware, só de dentro de flash_safe_execute().
+ */
+void ota_diario_acrescentar(ota_registro_t *registro);
+
+/**
+ * @brief Monta a primeira página do setor de progresso: troca dos primeiros 'setores' dos
+ *        slots A e B que, concluída, acrescenta 'final' ao diário.
+ *
+ * Gravada com o setor de progresso recém-apagado, é o pedido de troca ao estágio de boot.
+ */
+void ota_troca_preparar(uint8_t *pagina, uint16_t setores, const ota_registro_t *final);
+
+/**
+ * @brief true se o setor de progresso tem um pedido íntegro ainda não concluído.
+ */
+bool ota_troca_pendente();
+
+/**
+ * @brief Executa, a partir do passo em que parou, a troca pedida em ota_troca_preparar().
+ *
+ * Cada setor passa por três passos (slot A → rascunho, slot B → slot A, rascunho → slot B),
+ * e cada passo concluído é marcado no setor de progresso sem apagá-lo. A origem de um passo
+ * só é apagada depois de ele ser marcado, então uma queda de energia em qualquer ponto é
+ * retomada no próximo boot, repetindo no máximo o passo interrompido.
+ *
+ * @param alimentar chamada antes de cada passo (watchdog).
+ */
+void ota_troca_executar(void (*alimentar)(void));
+
+#endif // OTA_TROCA_H
@@ -0,0 +1,205 @@
+// pio_i2c.c - Mestre I2C no PIO: a transação vira uma lista de comandos que o DMA entrega à
+// máquina de estados, e os bytes do barramento voltam por outro canal de DMA
+
+#include "pio_i2c.h"
+#include "pio_i2c.pio.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include <string.h>
+
+#define ICOUNT_LSB  10
+#define FINAL_LSB   9
+#define DADO_LSB    1
+#define NAK_LSB     0
+
+// Offset do programa em cada PIO + 1; 0 = ainda não carregado. Todos os barramentos de um
+// mesmo PIO dividem a mesma cópia do programa.
+static uint8_t programa[NUM_PIOS];
+
+static const uint8_t START[] = {PIO_I2C_SCL1_SDA0, PIO_I2C_SCL0_SDA0};
+static const uint8_t START_REPETIDO[] = {PIO_I2C_SCL0_SDA1, PIO_I2C_SCL1_SDA1, PIO_I2C_SCL1_SDA0, PIO_I2C_SCL0_SDA0};
+static const uint8_t STOP[] = {PIO_I2C_SCL0_SDA0, PIO_I2C_SCL1_SDA0, PIO_I2C_SCL1_SDA1};
+
+// Pedido de n instruções seguido delas
+static size_t linhas(uint16_t *c, const uint8_t *seq, size_t n) {
+    c[0] = (uint16_t)((n - 1) << ICOUNT_LSB);
+    for (size_t i = 0; i < n; i++) c[1 + i] = pio_i2c_linhas_program_instructions[seq[i]];
+    return n + 1;
+}
+
+static inline uint16_t byte_i2c(uint8_t dado, bool final, bool nak) {
+    return (uint16_t)(dado << DADO_LSB | (uint16_t)final << FINAL_LSB | (uint16_t)nak << NAK_LSB);
+}
+
+static bool reservar(pio_i2c_t *bus) {
+    for (uint i = 0; i < NUM_PIOS; i++) {
+        PIO pio = pio_get_instance(i);
+        if (!programa[i] && !pio_can_add_program(pio, &pio_i2c_program)) continue;
+        int sm = pio_claim_unused_sm(pio, false);
+        if (sm < 0) continue;
+
+        int tx = dma_claim_unused_channel(false);
+        int rx = dma_claim_unused_channel(false);
+        if (tx < 0 || rx < 0) {
+            if (tx >= 0) dma_channel_unclaim((uint)tx);
+            if (rx >= 0) dma_channel_unclaim((uint)rx);
+            pio_sm_unclaim(pio, (uint)sm);
+            return false;
+        }
+        if (!programa[i]) programa[i] = (uint8_t)(pio_add_program(pio, &pio_i2c_program) + 1);
+
+        bus->pio = (uint8_t)i;
+        bus->sm = (uint8_t)sm;
+        bus->dma_tx = (uint8_t)tx;
+        bus->dma_rx = (uint8_t)rx;
+        bus->reservado = true;
+        return true;
+    }
+    return false;
+}
+
+bool pio_i2c_iniciar(pio_i2c_t *bus, uint sda_pin, uint scl_pin, uint baudrate) {
+    if (scl_pin != sda_pin + 1) return false; // o programa espera o SCL no pino seguinte
+    if (!bus->reservado && !reservar(bus)) return false;
+    bus->sda_pin = sda_pin;
+    bus->baudrate = baudrate;
+    bus->sem_stop = false;
+    bus->em_andamento = false;
+    pio_i2c_program_init(pio_get_instance(bus->pio), bus->sm, programa[bus->pio] - 1u, sda_pin, scl_pin, baudrate);
+    return true;
+}
+
+void pio_i2c_parar(pio_i2c_t *bus) {
+    if (!bus->reservado) return;
+    PIO pio = pio_get_instance(bus->pio);
+    dma_channel_abort(bus->dma_tx);
+    dma_channel_abort(bus->dma_rx);
+    pio_sm_set_enabled(pio, bus->sm, false);
+    pio_interrupt_clear(pio, bus->sm);
+    gpio_set_oeover(bus->sda_pin, GPIO_OVERRIDE_NORMAL);
+    gpio_set_oeover(bus->sda_pin + 1, GPIO_OVERRIDE_NORMAL);
+    bus->sem_stop = false;
+    bus->em_andamento = false;
+}
+
+bool pio_i2c_disparar(pio_i2c_t *bus, uint8_t endereco, const uint8_t *tx, size_t tx_len, uint8_t *rx,
+                      size_t rx_len, bool nostop) {
+    if (!bus->reservado || bus->em_andamento || !(tx_len + rx_len) || tx_len + rx_len > PIO_I2C_DADOS_MAX) {
+        return false;
+    }
+
+    // Só o último byte da transação aceita NAK: antes dele, NAK = escravo ausente ou ocupado
+    uint16_t *c = bus->comandos;
+    size_t n = bus->sem_stop ? linhas(c, START_REPETIDO, count_of(START_REPETIDO)) : linhas(c, START, count_of(START));
+    if (tx_len) {
+        c[n++] = byte_i2c((uint8_t)(endereco << 1), false, true);
+        for (size_t i = 0; i < tx_len; i++) c[n++] = byte_i2c(tx[i], !rx_len && i == tx_len - 1, true);
+    }
+    if (rx_len) {
+        if (tx_len) n += linhas(c + n, START_REPETIDO, count_of(START_REPETIDO));
+        c[n++] = byte_i2c((uint8_t)(endereco << 1 | 1), false, true);
+        // 0xFF solta o SDA para o escravo; o mestre dá ACK em todos menos no último
+        for (size_t i = 0; i < rx_len; i++) c[n++] = byte_i2c(0xFF, i == rx_len - 1, i == rx_len - 1);
+    }
+    if (!nostop) n += linhas(c + n, STOP, count_of(STOP));
+
+    bus->recebidos = (uint8_t)((tx_len ? 1 + tx_len : 0) + (rx_len ? 1 + rx_len : 0));
+    bus->descartar = (uint8_t)(bus->recebidos - rx_len);
+    bus->destino = rx_len ? rx : NULL;
+    bus->sem_stop = nostop;
+    bus->em_andamento = true;
+
+    PIO pio = pio_get_instance(bus->pio);
+    pio_sm_clear_fifos(pio, bus->sm);
+    pio_interrupt_clear(pio, bus->sm);
+
+    // Recepção primeiro: o primeiro byte volta assim que o endereço sai
+    dma_channel_config crx = dma_channel_get_default_config(bus->dma_rx);
+    channel_config_set_transfer_data_size(&crx, DMA_SIZE_8);
+    channel_config_set_read_increment(&crx, false);
+    channel_config_set_write_increment(&crx, true);
+    channel_config_set_dreq(&crx, pio_get_dreq(pio, bus->sm, false));
+    dma_channel_configure(bus->dma_rx, &crx, bus->rx, &pio->rxf[bus->sm], bus->recebidos, true);
+
+    // Meia palavra na fila TX: o barramento a replica nas duas metades e o OSR (deslocando para
+    // a esquerda, autopull de 16) pega a de cima
+    dma_channel_config ctx = dma_channel_get_default_config(bus->dma_tx);
+    channel_config_set_transfer_data_size(&ctx, DMA_SIZE_16);
+    channel_config_set_read_increment(&ctx, true);
+    channel_config_set_write_increment(&ctx, false);
+    channel_config_set_dreq(&ctx, pio_get_dreq(pio, bus->sm, true));
+    dma_channel_configure(bus->dma_tx, &ctx, &pio->txf[bus->sm], c, n, true);
+    return true;
+}
+
+// A máquina terminou tudo o que estava na fila quando volta a esperar por ela
+static inline bool fila_tx_parada(PIO pio, uint sm) {
+    return pio->fdebug & (1u << (PIO_FDEBUG_TXSTALL_LSB + sm));
+}
+
+static inline void limpar_parada(PIO pio, uint sm) {
+    pio->fdebug = 1u << (PIO_FDEBUG_TXSTALL_LSB + sm);
+}
+
+// Depois de um NAK: descarta o resto da transação, volta ao início do programa e manda o STOP
+static void abortar(pio_i2c_t *bus, PIO pio) {
+    dma_channel_abort(bus->dma_tx);
+    dma_channel_abort(bus->dma_rx);
+    pio_sm_drain_tx_fifo(pio, bus->sm);
+    pio_sm_exec(pio, bus->sm, pio_encode_jmp(programa[bus->pio] - 1u + pio_i2c_offset_entry_point));
+    pio_interrupt_clear(pio, bus->sm);
+
+    uint16_t stop[count_of(STOP) + 1];
+    size_t n = linhas(stop, STOP, count_of(STOP));
+    limpar_parada(pio, bus->sm);
+    for (size_t i = 0; i < n; i++) {
+        while (pio_sm_is_tx_fifo_full(pio, bus->sm)) tight_loop_contents();
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+        *(io_rw_16 *)&pio->txf[bus->sm] = stop[i];
+#pragma GCC diagnostic pop
+    }
+    // O STOP são poucos ciclos; sem o SCL preso, termina antes do limite
+    absolute_time_t limite = make_timeout_time_us(100);
+    while (!pio_sm_is_tx_fifo_empty(pio, bus->sm) || !fila_tx_parada(pio, bus->sm)) {
+        if (time_reached(limite)) break;
+    }
+    pio_sm_clear_fifos(pio, bus->sm);
+}
+
+int pio_i2c_concluir(pio_i2c_t *bus, absolute_time_t limite) {
+    if (!bus->em_andamento) return PICO_ERROR_GENERIC;
+    PIO pio = pio_get_instance(bus->pio);
+    uint sm = bus->sm;
+    bool esperando_parada = false;
+
+    while (true) {
+        if (pio_interrupt_get(pio, sm)) {
+            abortar(bus, pio);
+            bus->em_andamento = false;
+            bus->sem_stop = false;
+            return PICO_ERROR_GENERIC;
+        }
+        if (!dma_channel_is_busy(bus->dma_rx) && !dma_channel_is_busy(bus->dma_tx)) {
+            // Todos os comandos já estão na fila: falta o último ACK e o STOP
+            if (!esperando_parada) {
+                limpar_parada(pio, sm);
+                esperando_parada = true;
+            } else if (pio_sm_is_tx_fifo_empty(pio, sm) && fila_tx_parada(pio, sm)) {
+                break;
+            }
+        }
+        if (time_reached(limite)) {
+            bus->em_andamento = false;
+            bus->sem_stop = false;
+            return PICO_ERROR_TIMEOUT;
+        }
+        tight_loop_contents();
+    }
+
+    bus->em_andamento = false;
+    if (!bus->destino) return bus->recebidos - 1; // só escrita: endereço + dados
+    size_t len = (size_t)(bus->recebidos - bus->descartar);
+    memcpy(bus->destino, bus->rx + bus->descartar, len);
+    return (int)len;
+}
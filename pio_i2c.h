@@ -0,0 +1,81 @@
+// pio_i2c.h - Mestre I2C em máquina de estados do PIO, com a transação inteira entregue por DMA
+
+#ifndef PIO_I2C_H
+#define PIO_I2C_H
+
+#include "pico/stdlib.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bytes escritos mais lidos numa transação; a maior é registrador + bloco de resultado do
+// VL53L0X (1 + 12 bytes)
+#define PIO_I2C_DADOS_MAX    16
+// Palavras da fila TX: START repetido (5), 2 endereços, os dados, outro START repetido e STOP (4)
+#define PIO_I2C_COMANDOS_MAX (PIO_I2C_DADOS_MAX + 16)
+
+/**
+ * @brief Um barramento I2C num par de GPIOs qualquer (SCL = SDA + 1), servido por uma
+ *        máquina de estados do PIO e dois canais de DMA.
+ *
+ * A transação é montada inteira em palavras de comando e entregue à máquina por DMA; outro
+ * canal recolhe os bytes do barramento. Depois de disparada, nada dela passa pela CPU até
+ * pio_i2c_concluir(): barramentos diferentes correm ao mesmo tempo, cada um no seu ritmo.
+ * Os campos são internos; a estrutura começa zerada (estática).
+ */
+typedef struct {
+    uint sda_pin;
+    uint baudrate;
+    bool reservado;      // máquina de estados e canais de DMA já reservados
+    uint8_t pio;         // 0 ou 1
+    uint8_t sm;
+    uint8_t dma_tx;
+    uint8_t dma_rx;
+    bool sem_stop;       // a transação anterior terminou sem STOP: a próxima começa com START repetido
+    bool em_andamento;
+    uint8_t recebidos;   // bytes que o DMA de recepção ainda vai entregar
+    uint8_t descartar;   // endereços e bytes escritos no início de recebidos
+    uint8_t *destino;
+    uint16_t comandos[PIO_I2C_COMANDOS_MAX];
+    uint8_t rx[PIO_I2C_DADOS_MAX + 2];   // tudo o que passou pelo barramento, endereços inclusive
+} pio_i2c_t;
+
+/**
+ * @brief Reserva uma máquina de estados (carregando o programa no PIO se preciso) e os
+ *        canais de DMA na primeira chamada, e (re)configura a máquina e os pinos.
+ *        Chamadas seguintes no mesmo barramento reaproveitam o que já foi reservado.
+ * @return false se não há máquina de estados, memória de instruções ou DMA livres.
+ */
+bool pio_i2c_iniciar(pio_i2c_t *bus, uint sda_pin, uint scl_pin, uint baudrate);
+
+/**
+ * @brief Para a máquina de estados e devolve os pinos ao GPIO (para a recuperação do barramento
+ *        em i2c_bus_recuperar()). pio_i2c_iniciar() religa.
+ */
+void pio_i2c_parar(pio_i2c_t *bus);
+
+/**
+ * @brief Dispara uma transação e retorna sem esperar: escreve tx (se tx_len > 0) e, se
+ *        rx_len > 0, lê rx_len bytes em rx com START repetido entre as duas partes.
+ *        nostop deixa o barramento com o escravo para a próxima transação.
+ * @return false se tx_len + rx_len passa de PIO_I2C_DADOS_MAX.
+ */
+bool pio_i2c_disparar(pio_i2c_t *bus, uint8_t endereco, const uint8_t *tx, size_t tx_len, uint8_t *rx,
+                      size_t rx_len, bool nostop);
+
+/**
+ * @brief Espera a transação disparada terminar, no máximo até limite. Num NAK o barramento
+ *        já volta livre (STOP enviado); num timeout fica como está, para a recuperação.
+ * @return Bytes lidos (ou escritos, sem leitura), PICO_ERROR_GENERIC (NAK) ou PICO_ERROR_TIMEOUT.
+ */
+int pio_i2c_concluir(pio_i2c_t *bus, absolute_time_t limite);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PIO_I2C_H
@@ -0,0 +1,306 @@
+// rede.c - Máquina de estados do Wi-Fi: varredura ou cache, join, DHCP ou IP fixo, e MQTT
+
+#include "config.h"
+#include "rede.h"
+#include "boot_cache.h"
+#include "energia.h"
+#include "intertravamento.h"
+#include "metricas.h"
+#include "mqtt_config.h"
+#include "servidor_http.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/dhcp.h"
+#include <string.h>
+
+#define IP_ESTATICO_CONFIGURADO (sizeof(REDE_IP_ESTATICO) > 1)
+
+typedef enum {
+    REDE_DESLIGADA,   // rádio ainda não iniciado
+    REDE_VARRENDO,
+    REDE_ASSOCIANDO,  // join e, se for o caso, DHCP
+    REDE_CONECTADA,
+    REDE_ESPERANDO,   // pausa antes de tentar de novo
+} rede_fase_t;
+
+static struct {
+    rede_fase_t fase;
+    absolute_time_t limite;    // timeout da fase atual ou fim da espera
+    boot_cache_t cache;        // BSSID/canal a usar no próximo join
+    bool cache_valida;         // a cache ainda não falhou nesta inicialização
+    boot_cache_t cache_nova;   // associação a gravar quando o intertravamento liberar a flash
+    bool cache_gravar;
+    bool cache_apagar;
+    bool ip_fixo;              // endereço aplicado sem DHCP (estático ou concessão da cache)
+    volatile bool varredura_achou;
+    int16_t melhor_rssi;
+    absolute_time_t conectou_em;
+    absolute_time_t sem_mqtt_desde; // última vez visto conectado ao broker (ou o join)
+    bool ja_conectou;
+
+    bool baixa_latencia;
+    uint32_t intervalo_publicacao_ms;
+    int modo_radio;            // modo aplicado no chip; -1 = desconhecido (reassociou)
+} rede;
+
+static const char *const nomes_modo[RADIO_NUM_MODOS] = {"desempenho", "economia", "economia máxima"};
+
+static const uint32_t valores_pm[RADIO_NUM_MODOS] = {
+    [RADIO_DESEMPENHO] = cyw43_pm_value(CYW43_NO_POWERSAVE_MODE, 10, 0, 0, 0),
+    [RADIO_ECONOMIA] = cyw43_pm_value(CYW43_PM2_POWERSAVE_MODE, REDE_PM2_RETORNO_MS, 1, 1, REDE_PM_ESCUTA_ASSOCIACAO),
+    [RADIO_ECONOMIA_MAXIMA] = cyw43_pm_value(CYW43_PM1_POWERSAVE_MODE, 10, 0, REDE_PM_DTIM_MAXIMA,
+                                             REDE_PM_ESCUTA_ASSOCIACAO),
+};
+
+static struct netif *sta() {
+    return &cyw43_state.netif[CYW43_ITF_STA];
+}
+
+static void aplicar_ip_fixo(uint32_t ip, uint32_t mascara, uint32_t gateway) {
+    ip4_addr_t a, m, g;
+    ip4_addr_set_u32(&a, ip);
+    ip4_addr_set_u32(&m, mascara);
+    ip4_addr_set_u32(&g, gateway);
+    cyw43_arch_lwip_begin();
+    dhcp_stop(sta());
+    netif_set_addr(sta(), &a, &m, &g);
+    cyw43_arch_lwip_end();
+    rede.ip_fixo = true;
+}
+
+static void usar_dhcp() {
+    cyw43_arch_lwip_begin();
+    dhcp_start(sta());
+    cyw43_arch_lwip_end();
+    rede.ip_fixo = false;
+}
+
+static void esperar() {
+    rede.fase = REDE_ESPERANDO;
+    rede.limite = make_timeout_time_ms(REDE_ESPERA_RETENTATIVA_MS);
+}
+
+// Chamado pelo driver para cada AP encontrado; guarda o de melhor sinal da nossa rede
+static int resultado_varredura(void *env, const cyw43_ev_scan_result_t *r) {
+    (void)env;
+    if (r->ssid_len != strlen(WIFI_SSID) || memcmp(r->ssid, WIFI_SSID, r->ssid_len) != 0) return 0;
+    if (!rede.varredura_achou || r->rssi > rede.melhor_rssi) {
+        memcpy(rede.cache.bssid, r->bssid, sizeof(rede.cache.bssid));
+        rede.cache.canal = (uint8_t)r->channel;
+        rede.melhor_rssi = r->rssi;
+        rede.varredura_achou = true;
+    }
+    return 0;
+}
+
+static void varrer() {
+    cyw43_wifi_scan_options_t opcoes = {0};
+    opcoes.ssid_len = strlen(WIFI_SSID);
+    memcpy(opcoes.ssid, WIFI_SSID, opcoes.ssid_len);
+
+    rede.varredura_achou = false;
+    if (cyw43_wifi_scan(&cyw43_state, &opcoes, NULL, resultado_varredura) != 0) {
+        esperar();
+        return;
+    }
+    rede.fase = REDE_VARRENDO;
+    rede.limite = make_timeout_time_ms(REDE_TIMEOUT_VARREDURA_MS);
+}
+
+// Com BSSID e canal o chip não varre antes de associar
+static void associar() {
+    int r = cyw43_wifi_join(&cyw43_state, strlen(WIFI_SSID), (const uint8_t *)WIFI_SSID, strlen(WIFI_PASSWORD),
+                            (const uint8_t *)WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, rede.cache.bssid,
+                            rede.cache.canal);
+    if (r != 0) {
+        esperar();
+        return;
+    }
+    rede.fase = REDE_ASSOCIANDO;
+    rede.limite = make_timeout_time_ms(REDE_TIMEOUT_ASSOCIACAO_MS);
+}
+
+static void iniciar_conexao() {
+    energia_entrar(ENERGIA_RADIO_DESEMPENHO); // varredura e join com o rádio sempre acordado
+    if (rede.cache_valida) associar();
+    else varrer();
+}
+
+static radio_modo_t escolher_modo() {
+    if (REDE_RADIO_MODO_FIXO >= 0) return (radio_modo_t)REDE_RADIO_MODO_FIXO;
+    if (rede.baixa_latencia) return RADIO_DESEMPENHO;
+    // O handshake com o broker não deve esperar o rádio acordar, mas com o broker fora do ar
+    // as tentativas seguintes (a cada MQTT_RETENTATIVA_MS) vão com economia
+    if (mqtt_esta_conectado()) {
+        rede.sem_mqtt_desde = get_absolute_time();
+    } else if (absolute_time_diff_us(rede.sem_mqtt_desde, get_absolute_time()) < REDE_DESEMPENHO_SEM_MQTT_MS * 1000ll) {
+        return RADIO_DESEMPENHO;
+    }
+    return rede.intervalo_publicacao_ms > REDE_PM_LIMIAR_MAXIMA_MS ? RADIO_ECONOMIA_MAXIMA : RADIO_ECONOMIA;
+}
+
+static void atualizar_modo_radio() {
+    radio_modo_t modo = escolher_modo();
+    if ((int)modo == rede.modo_radio) return;
+    if (cyw43_wifi_pm(&cyw43_state, valores_pm[modo]) != 0) return; // tenta de novo na próxima volta
+    rede.modo_radio = modo;
+    energia_entrar(ENERGIA_RADIO_DESEMPENHO + modo);
+    metricas_definir(METRICA_RADIO_MODO, modo);
+    printf("[rede] Rádio em modo %s\n", nomes_modo[modo]);
+}
+
+static void conectou() {
+    rede.fase = REDE_CONECTADA;
+    rede.modo_radio = -1; // o join restaura o modo padrão do driver
+    energia_entrar(ENERGIA_RADIO_ECONOMIA);
+    rede.conectou_em = get_absolute_time();
+    rede.sem_mqtt_desde = rede.conectou_em;
+    uint32_t ms = to_ms_since_boot(rede.conectou_em);
+    printf("[rede] Wi-Fi conectado em %lu ms (%s), IP %s\n", (unsigned long)ms,
+           rede.cache_valida ? "cache" : "varredura", ip4addr_ntoa(netif_ip4_addr(sta())));
+    if (!rede.ja_conectou) {
+        rede.ja_conectou = true;
+        metricas_definir(METRICA_BOOT_REDE_MS, ms);
+    }
+
+    boot_cache_t nova = {0};
+    strncpy(nova.ssid, WIFI_SSID, sizeof(nova.ssid) - 1);
+    cyw43_wifi_get_bssid(&cyw43_state, nova.bssid);
+    nova.canal = rede.cache.canal;
+    if (!IP_ESTATICO_CONFIGURADO) {
+        nova.ip = ip4_addr_get_u32(netif_ip4_addr(sta()));
+        nova.mascara = ip4_addr_get_u32(netif_ip4_netmask(sta()));
+        nova.gateway = ip4_addr_get_u32(netif_ip4_gw(sta()));
+    }
+    if (REDE_CACHE_HABILITADA) {
+        rede.cache_nova = nova;
+        rede.cache_gravar = true;
+        rede.cache_apagar = false; // o setor novo substitui o velho
+    }
+}
+
+// Gravar a flash para as interrupções, e com elas o intertravamento: a cache espera a liberação
+static void gravar_cache() {
+    if (!(rede.cache_gravar || rede.cache_apagar) || !intertravamento_flash_liberada()) return;
+    if (rede.cache_apagar) {
+        rede.cache_apagar = !boot_cache_apagar();
+    } else if (boot_cache_salvar(&rede.cache_nova)) {
+        rede.cache = rede.cache_nova;
+        rede.cache_valida = true;
+        rede.cache_gravar = false;
+    }
+}
+
+// A cache não serviu (AP trocou de canal, foi substituído...): descarta e faz o caminho completo
+static void falhou_associacao() {
+    cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+    metricas_incrementar(METRICA_WIFI_FALHAS);
+    if (!rede.cache_valida) {
+        printf("[rede] Falha ao conectar ao Wi-Fi\n");
+        esperar();
+        return;
+    }
+
+    printf("[rede] Cache de associação falhou, varrendo\n");
+    rede.cache_valida = false;
+    rede.cache_apagar = true;
+    if (rede.ip_fixo && !IP_ESTATICO_CONFIGURADO) usar_dhcp();
+    varrer();
+}
+
+void rede_iniciar() {
+    rede.fase = REDE_DESLIGADA;
+    rede.modo_radio = -1;
+    rede.limite = get_absolute_time();
+    rede.cache_valida = REDE_CACHE_HABILITADA && boot_cache_ler(&rede.cache) &&
+                        strncmp(rede.cache.ssid, WIFI_SSID, sizeof(rede.cache.ssid)) == 0;
+    metricas_definir(METRICA_BOOT_CACHE, rede.cache_valida);
+    if (rede.cache_valida) {
+        printf("[rede] Cache de flash: canal %u, %s\n", rede.cache.canal,
+               rede.cache.ip ? "com concessão DHCP" : "sem concessão");
+    }
+}
+
+void rede_processar() {
+    // Antes de cyw43_arch_init() não há contexto assíncrono para sondar
+    if (rede.fase != REDE_DESLIGADA) cyw43_arch_poll(); // mantém a rede viva
+    gravar_cache();
+
+    switch (rede.fase) {
+    case REDE_DESLIGADA:
+        if (!time_reached(rede.limite)) break;
+        if (cyw43_arch_init()) {
+            printf("[rede] Falha ao inicializar Wi-Fi\n");
+            rede.limite = make_timeout_time_ms(REDE_ESPERA_RETENTATIVA_MS);
+            break;
+        }
+        cyw43_arch_enable_sta_mode(); // liga o cliente DHCP
+        servidor_http_iniciar();
+
+        if (IP_ESTATICO_CONFIGURADO) {
+            ip4_addr_t ip, mascara, gateway;
+            ip4addr_aton(REDE_IP_ESTATICO, &ip);
+            ip4addr_aton(REDE_MASCARA_ESTATICA, &mascara);
+            ip4addr_aton(REDE_GATEWAY_ESTATICO, &gateway);
+            aplicar_ip_fixo(ip4_addr_get_u32(&ip), ip4_addr_get_u32(&mascara), ip4_addr_get_u32(&gateway));
+        } else if (rede.cache_valida && rede.cache.ip) {
+            aplicar_ip_fixo(rede.cache.ip, rede.cache.mascara, rede.cache.gateway);
+        }
+        iniciar_conexao();
+        break;
+
+    case REDE_VARRENDO:
+        if (cyw43_wifi_scan_active(&cyw43_state) && !time_reached(rede.limite)) break;
+        if (rede.varredura_achou) {
+            associar();
+        } else {
+            printf("[rede] Rede %s não encontrada\n", WIFI_SSID);
+            esperar();
+        }
+        break;
+
+    case REDE_ASSOCIANDO: {
+        int status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+        if (status == CYW43_LINK_UP) conectou();
+        else if (status < 0 || time_reached(rede.limite)) falhou_associacao();
+        break;
+    }
+
+    case REDE_CONECTADA:
+        if (cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) != CYW43_LINK_UP) {
+            printf("[rede] Conexão Wi-Fi perdida\n");
+            cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+            iniciar_conexao();
+            break;
+        }
+        atualizar_modo_radio();
+        if (mqtt_esta_conectado()) {
+            mqtt_processar();
+            break;
+        }
+
+        // Concessão reaproveitada que não alcança o broker: provavelmente expirou
+        if (rede.ip_fixo && !IP_ESTATICO_CONFIGURADO &&
+            time_reached(delayed_by_ms(rede.conectou_em, REDE_TIMEOUT_MQTT_MS))) {
+            printf("[rede] Broker inalcançável com a concessão salva, pedindo DHCP\n");
+            usar_dhcp();
+            rede.fase = REDE_ASSOCIANDO;
+            rede.limite = make_timeout_time_ms(REDE_TIMEOUT_ASSOCIACAO_MS);
+            break;
+        }
+        mqtt_iniciar(); // não faz nada se já há uma conexão em andamento
+        break;
+
+    case REDE_ESPERANDO:
+        if (time_reached(rede.limite)) iniciar_conexao();
+        break;
+    }
+}
+
+bool rede_conectada() {
+    return rede.fase == REDE_CONECTADA;
+}
+
+void rede_politica_radio(bool baixa_latencia, uint32_t intervalo_publicacao_ms) {
+    rede.baixa_latencia = baixa_latencia;
+    rede.intervalo_publicacao_ms = intervalo_publicacao_ms;
+}
@@ -0,0 +1,45 @@
+// rede.h - Conexão Wi-Fi e MQTT em segundo plano, com cache de associação em flash
+
+#ifndef REDE_H
+#define REDE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Liga o rádio e dispara a primeira tentativa de conexão, sem esperar por ela.
+ *
+ * Com uma cache válida em flash (mesmo SSID) o join vai direto ao BSSID e canal salvos e,
+ * se houver, reaproveita a última concessão DHCP (ou REDE_IP_ESTATICO), pulando a varredura
+ * e o DHCP. Sem cache, ou se a cache falhar, faz a varredura normal e grava uma cache nova.
+ */
+void rede_iniciar();
+
+/**
+ * @brief Avança a máquina de estados da conexão. Chamar a cada volta do laço principal;
+ *        nunca bloqueia além das chamadas curtas ao driver.
+ */
+void rede_processar();
+
+/**
+ * @brief true quando o Wi-Fi tem endereço IP.
+ */
+bool rede_conectada();
+
+typedef enum {
+    RADIO_DESEMPENHO,       // sem economia: menor latência, maior consumo
+    RADIO_ECONOMIA,         // PM2: dorme REDE_PM2_RETORNO_MS após o tráfego, acorda a cada DTIM
+    RADIO_ECONOMIA_MAXIMA,  // PM1: dorme logo após cada pacote, acorda a cada REDE_PM_DTIM_MAXIMA DTIMs
+    RADIO_NUM_MODOS
+} radio_modo_t;
+
+/**
+ * @brief Informa a demanda da aplicação; o modo de economia do rádio é escolhido a partir dela.
+ *
+ * Com baixa_latencia (alerta ativo, OTA chegando) o rádio fica sem economia; fora disso usa
+ * economia máxima quando as publicações estão a mais de REDE_PM_LIMIAR_MAXIMA_MS uma da outra.
+ * O modo só é trocado no chip quando muda, em rede_processar().
+ */
+void rede_politica_radio(bool baixa_latencia, uint32_t intervalo_publicacao_ms);
+
+#endif // REDE_H
@@ -0,0 +1,92 @@
+// registro.c - Uma fila de palavras por core; a formatação fica para registro_descarregar()
+
+#include "registro.h"
+#include "captura.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+#define REGISTRO_NUM_CORES 2
+#define REGISTRO_TIPO_QUADRO 2 // quadro da USB, ao lado das amostras da captura (tipo 1)
+
+static_assert((REGISTRO_FILA_PALAVRAS & (REGISTRO_FILA_PALAVRAS - 1)) == 0, "a fila deve ser potência de 2");
+
+// Cada mensagem: cabeçalho (id | argumentos << 16), time_us_32() e os argumentos
+typedef struct {
+    uint32_t palavras[REGISTRO_FILA_PALAVRAS];
+    volatile uint32_t escrita, leitura; // em palavras, crescem sem parar
+    volatile uint32_t perdidos;         // só cresce; o consumidor lembra quantos já informou
+} fila_t;
+
+static fila_t filas[REGISTRO_NUM_CORES];
+static uint32_t perdidos_informados[REGISTRO_NUM_CORES];
+
+#if !REGISTRO_SAIDA_BINARIA
+#define X(id, nivel, formato) formato,
+static const char *const formatos[] = {
+#include "registro.def"
+};
+#undef X
+#endif
+
+void registro_gravar(registro_id_t id, const uint32_t *args, uint32_t num_args) {
+    fila_t *f = &filas[get_core_num()];
+    // Só o core dono escreve na fila; desligar as interrupções basta contra uma IRQ no meio
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t e = f->escrita;
+    if (REGISTRO_FILA_PALAVRAS - (e - f->leitura) < 2 + num_args) {
+        f->perdidos++;
+    } else {
+        f->palavras[e++ % REGISTRO_FILA_PALAVRAS] = id | num_args << 16;
+        f->palavras[e++ % REGISTRO_FILA_PALAVRAS] = time_us_32();
+        for (uint32_t i = 0; i < num_args; i++) f->palavras[e++ % REGISTRO_FILA_PALAVRAS] = args[i];
+        __compiler_memory_barrier(); // a mensagem fica completa antes de o índice aparecer
+        f->escrita = e;
+    }
+    restore_interrupts(irq);
+}
+
+static void emitir(uint32_t id, uint core, uint32_t t_us, const uint32_t *a, uint32_t n) {
+#if REGISTRO_SAIDA_BINARIA
+    // id u16 | core u8 | argumentos u8 | t_us u32 | argumentos u32..., little-endian
+    uint8_t payload[8 + 4 * REGISTRO_MAX_ARGS];
+    uint32_t palavras[2 + REGISTRO_MAX_ARGS] = {id | core << 16 | n << 24, t_us};
+    for (uint32_t i = 0; i < n; i++) palavras[2 + i] = a[i];
+    for (uint32_t i = 0; i < 2 + n; i++) {
+        for (int b = 0; b < 4; b++) payload[4 * i + b] = (uint8_t)(palavras[i] >> (8 * b));
+    }
+    captura_quadro(REGISTRO_TIPO_QUADRO, payload, (uint8_t)(8 + 4 * n));
+#else
+    (void)core;
+    (void)t_us;
+    uint32_t v[REGISTRO_MAX_ARGS] = {0};
+    for (uint32_t i = 0; i < n; i++) v[i] = a[i];
+    // Argumentos a mais são ignorados pelo printf; todos os formatos esperam int de 32 bits
+    static_assert(REGISTRO_MAX_ARGS == 6, "ajuste a chamada abaixo");
+    printf(formatos[id], (unsigned)v[0], (unsigned)v[1], (unsigned)v[2], (unsigned)v[3], (unsigned)v[4],
+           (unsigned)v[5]);
+    putchar('\n');
+#endif
+}
+
+void registro_descarregar() {
+    for (uint core = 0; core < REGISTRO_NUM_CORES; core++) {
+        fila_t *f = &filas[core];
+        uint32_t perdidos = f->perdidos;
+        if (perdidos != perdidos_informados[core]) {
+            uint32_t a[] = {perdidos - perdidos_informados[core], core};
+            perdidos_informados[core] = perdidos;
+            emitir(REG_REGISTRO_PERDIDOS, core, time_us_32(), a, count_of(a));
+        }
+        while (f->leitura != f->escrita) {
+            __compiler_memory_barrier();
+            uint32_t l = f->leitura;
+            uint32_t cabecalho = f->palavras[l++ % REGISTRO_FILA_PALAVRAS];
+            uint32_t t_us = f->palavras[l++ % REGISTRO_FILA_PALAVRAS];
+            uint32_t n = cabecalho >> 16, args[REGISTRO_MAX_ARGS];
+            for (uint32_t i = 0; i < n; i++) args[i] = f->palavras[l++ % REGISTRO_FILA_PALAVRAS];
+            __compiler_memory_barrier();
+            f->leitura = l; // a partir daqui o produtor pode reusar as palavras
+            emitir(cabecalho & 0xFFFF, core, t_us, args, n);
+        }
+    }
+}
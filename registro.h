@@ -0,0 +1,51 @@
+// registro.h - Registro adiado: o ponto de chamada grava só id e argumentos numa fila em RAM
+
+#ifndef REGISTRO_H
+#define REGISTRO_H
+
+#include <stdint.h>
+#include "config.h"
+
+#define REGISTRO_DEPURACAO 0
+#define REGISTRO_INFO      1
+#define REGISTRO_AVISO     2
+#define REGISTRO_ERRO      3
+
+#define X(id, nivel, formato) REG_##id,
+typedef enum {
+#include "registro.def"
+    REGISTRO_NUM_MENSAGENS
+} registro_id_t;
+#undef X
+
+#define X(id, nivel, formato) REG_NIVEL_##id = REGISTRO_##nivel,
+enum {
+#include "registro.def"
+};
+#undef X
+
+/**
+ * @brief Registra uma mensagem de registro.def: REGISTRAR(RELE_LIGADO, t_ms, mm, us).
+ *
+ * Mensagens abaixo de REGISTRO_NIVEL_MINIMO somem na compilação. As demais custam uma
+ * cópia de (2 + argumentos) palavras com as interrupções desligadas; serve em IRQ e nos dois
+ * cores. Nada é formatado aqui.
+ */
+#define REGISTRAR(id, ...)                                                                            \
+    do {                                                                                              \
+        if (REG_NIVEL_##id >= REGISTRO_NIVEL_MINIMO) {                                                \
+            const uint32_t registro_args_[] = {0, ##__VA_ARGS__}; /* o 0 permite nenhum argumento */  \
+            _Static_assert(sizeof(registro_args_) / 4 - 1 <= REGISTRO_MAX_ARGS, "argumentos demais"); \
+            registro_gravar(REG_##id, registro_args_ + 1, sizeof(registro_args_) / 4 - 1);            \
+        }                                                                                             \
+    } while (0)
+
+void registro_gravar(registro_id_t id, const uint32_t *args, uint32_t num_args);
+
+/**
+ * @brief Esvazia as filas: formata e imprime cada mensagem ou, com REGISTRO_SAIDA_BINARIA,
+ *        envia o id e os argumentos num quadro da USB. Chamar no core 0, no tempo ocioso.
+ */
+void registro_descarregar();
+
+#endif // REGISTRO_H
@@ -0,0 +1,287 @@
+// servidor_http.c - Servidor HTTP mínimo sobre a API raw TCP do lwIP, para leitura local do nó
+//
+// Tudo aqui roda no contexto do lwIP (IRQ de fundo do cyw43 na placa), menos
+// servidor_http_registrar(), que copia o resultado da janela com o lwIP travado. Cada
+// requisição é respondida por inteiro numa escrita e a conexão é fechada logo em seguida:
+// o FIN vai no mesmo segmento dos dados.
+
+#include "config.h"
+#include "servidor_http.h"
+#include "metricas.h"
+#include "mqtt_config.h"
+#include "texto.h"
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/tcp.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LINHA_MAX        64          // "GET /historico HTTP/1.1" e folga
+#define RESPOSTA_MAX     TCP_MSS     // resposta inteira num segmento
+#define CABECALHO_MAX    128         // reservado no início do buffer da resposta
+#define PAGINA_MAX       1024
+#define POLL_INTERVALO   2           // em ciclos de 500 ms do temporizador lento do TCP
+
+static_assert(METRICAS_JSON_MAX <= RESPOSTA_MAX - CABECALHO_MAX, "as métricas não cabem numa resposta");
+
+typedef struct {
+    struct tcp_pcb *pcb;  // NULL = livre
+    uint8_t ociosa;       // polls sem a linha da requisição completa
+    uint8_t n;
+    char linha[LINHA_MAX];
+} conexao_t;
+
+static struct tcp_pcb *escuta;
+static conexao_t conexoes[HTTP_CONEXOES];
+
+// Resultado da última janela; escrito pelo laço principal, com o lwIP travado depois que o
+// servidor abre (antes disso ninguém lê, e sem cyw43_arch_init() não há trava)
+static struct {
+    uint32_t seq;  // muda a cada janela: a página em cache é refeita na próxima visita
+    uint32_t t_ms;
+    uint16_t nivel_mm;
+    bool valida;
+    bool alerta;
+    bool rele;
+    uint16_t hist_mm[HTTP_HISTORICO];
+    uint32_t hist_t_ms[HTTP_HISTORICO];
+    uint16_t hist_ini;
+    uint16_t hist_n;
+} estado;
+
+// A página muda só uma vez por janela; entre janelas é servida pronta
+static char pagina[PAGINA_MAX];
+static size_t pagina_len;
+static uint32_t pagina_seq = UINT32_MAX;
+
+// Cabeçalho escrito logo antes do corpo, para a resposta sair de um buffer contíguo
+static char resposta[RESPOSTA_MAX];
+#define CORPO (resposta + CABECALHO_MAX)
+#define CORPO_MAX (RESPOSTA_MAX - CABECALHO_MAX)
+
+void servidor_http_registrar(uint16_t media_mm, bool valida, bool alerta, bool rele) {
+    uint32_t agora_ms = (uint32_t)(time_us_64() / 1000);
+    bool travar = escuta != NULL; // 'escuta' só muda no laço principal
+    if (travar) cyw43_arch_lwip_begin();
+    estado.seq++;
+    estado.t_ms = agora_ms;
+    estado.valida = valida;
+    estado.alerta = alerta;
+    estado.rele = rele;
+    if (valida) {
+        estado.nivel_mm = media_mm;
+        uint16_t i = (uint16_t)((estado.hist_ini + estado.hist_n) % HTTP_HISTORICO);
+        estado.hist_mm[i] = media_mm;
+        estado.hist_t_ms[i] = agora_ms;
+        if (estado.hist_n < HTTP_HISTORICO) estado.hist_n++;
+        else estado.hist_ini = (uint16_t)((estado.hist_ini + 1) % HTTP_HISTORICO);
+    }
+    if (travar) cyw43_arch_lwip_end();
+}
+
+// {"id":..,"t":ms,"nivel_mm":..,"leitura_valida":..,"alerta":..,"rele":..,"mqtt":..,"janelas":..}
+static size_t json_status(char *buf, size_t tamanho) {
+    size_t pos = 0;
+    texto_anexar(buf, tamanho, &pos,
+           "{\"id\":\"%s\",\"t\":%lu,\"nivel_mm\":%u,\"leitura_valida\":%s,\"alerta\":%s,\"rele\":%s,"
+           "\"mqtt\":%s,\"janelas\":%lu}",
+           mqtt_id_no(), (unsigned long)estado.t_ms, estado.nivel_mm, estado.valida ? "true" : "false",
+           estado.alerta ? "true" : "false", estado.rele ? "true" : "false",
+           mqtt_esta_conectado() ? "true" : "false", (unsigned long)estado.seq);
+    return pos < tamanho ? pos : 0;
+}
+
+// {"t":ms,"amostras":[[t_ms,mm],...]} da mais antiga para a mais nova; as mais antigas saem
+// se não couberem
+static size_t json_historico(char *buf, size_t tamanho) {
+    const size_t por_amostra = sizeof("[4294967295,65535],") - 1;
+    uint16_t n = estado.hist_n;
+    while (n && 48 + (size_t)n * por_amostra > tamanho) n--;
+
+    size_t pos = 0;
+    texto_anexar(buf, tamanho, &pos, "{\"t\":%lu,\"amostras\":[", (unsigned long)estado.t_ms);
+    for (uint16_t k = estado.hist_n - n; k < estado.hist_n; k++) {
+        uint16_t i = (uint16_t)((estado.hist_ini + k) % HTTP_HISTORICO);
+        texto_anexar(buf, tamanho, &pos, "%s[%lu,%u]", k == estado.hist_n - n ? "" : ",",
+               (unsigned long)estado.hist_t_ms[i], estado.hist_mm[i]);
+    }
+    texto_anexar(buf, tamanho, &pos, "]}");
+    return pos < tamanho ? pos : 0;
+}
+
+static size_t html_pagina(char *buf, size_t tamanho) {
+    size_t pos = 0;
+    texto_anexar(buf, tamanho, &pos,
+           "<!DOCTYPE html><html><head><meta charset=\"utf-8\">"
+           "<meta http-equiv=\"refresh\" content=\"%d\"><title>BotoSmart %s</title></head><body>"
+           "<h1>BotoSmart %s</h1><table>",
+           HTTP_RECARGA_PAGINA_S, mqtt_id_no(), mqtt_id_no());
+    if (estado.hist_n) {
+        texto_anexar(buf, tamanho, &pos, "<tr><td>Nível</td><td>%u mm%s</td></tr>", estado.nivel_mm,
+               estado.valida ? "" : " (última janela sem leitura válida)");
+    } else {
+        texto_anexar(buf, tamanho, &pos, "<tr><td>Nível</td><td>sem leitura</td></tr>");
+    }
+    texto_anexar(buf, tamanho, &pos,
+           "<tr><td>Estado</td><td>%s</td></tr><tr><td>Relé</td><td>%s</td></tr>"
+           "<tr><td>Broker MQTT</td><td>%s</td></tr><tr><td>Atualizado</td><td>%lu s após o boot</td></tr>"
+           "</table><p><a href=\"/status\">status</a> · <a href=\"/historico\">histórico</a> · "
+           "<a href=\"/metricas\">métricas</a></p></body></html>",
+           estado.alerta ? "ALERTA" : "normal", estado.rele ? "acionado" : "desligado",
+           mqtt_esta_conectado() ? "conectado" : "desconectado", (unsigned long)(estado.t_ms / 1000));
+    return pos < tamanho ? pos : 0;
+}
+
+// Escreve o cabeçalho colado antes do corpo já montado em CORPO e devolve o início da resposta
+static const char *com_cabecalho(int codigo, const char *tipo, size_t corpo_len, size_t *total) {
+    static const char *const razoes[] = {[0] = "OK", [1] = "Not Found", [2] = "Method Not Allowed",
+                                         [3] = "Bad Request", [4] = "Internal Server Error"};
+    int r = codigo == 200 ? 0 : codigo == 404 ? 1 : codigo == 405 ? 2 : codigo == 400 ? 3 : 4;
+    char cab[CABECALHO_MAX];
+    int n = snprintf(cab, sizeof(cab),
+                     "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %u\r\n"
+                     "Cache-Control: no-store\r\nConnection: close\r\n\r\n",
+                     codigo, razoes[r], tipo, (unsigned)corpo_len);
+    if (n <= 0 || n >= (int)sizeof(cab)) n = 0;
+    memcpy(CORPO - n, cab, (size_t)n);
+    *total = (size_t)n + corpo_len;
+    return CORPO - n;
+}
+
+static const char *erro(int codigo, size_t *total) {
+    size_t n = (size_t)snprintf(CORPO, CORPO_MAX, "%d\n", codigo);
+    return com_cabecalho(codigo, "text/plain", n, total);
+}
+
+// Monta a resposta para a linha da requisição; devolve ponteiro e tamanho
+static const char *responder(const char *linha, size_t *total) {
+    if (strncmp(linha, "GET ", 4) != 0) return erro(strchr(linha, ' ') ? 405 : 400, total);
+    const char *caminho = linha + 4;
+    size_t n = strcspn(caminho, " ?");
+    size_t len;
+
+    if (n == 1 && caminho[0] == '/') {
+        if (pagina_seq != estado.seq) {
+            pagina_len = html_pagina(pagina, sizeof(pagina));
+            pagina_seq = estado.seq;
+        }
+        if (!pagina_len || pagina_len > CORPO_MAX) return erro(500, total);
+        memcpy(CORPO, pagina, pagina_len);
+        return com_cabecalho(200, "text/html; charset=utf-8", pagina_len, total);
+    }
+    if (n == 7 && strncmp(caminho, "/status", n) == 0) len = json_status(CORPO, CORPO_MAX);
+    else if (n == 10 && strncmp(caminho, "/historico", n) == 0) len = json_historico(CORPO, CORPO_MAX);
+    else if (n == 9 && strncmp(caminho, "/metricas", n) == 0) len = metricas_json(CORPO, CORPO_MAX);
+    else return erro(404, total);
+
+    if (!len) return erro(500, total);
+    return com_cabecalho(200, "application/json", len, total);
+}
+
+static err_t fechar(conexao_t *c) {
+    struct tcp_pcb *pcb = c->pcb;
+    c->pcb = NULL;
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_err(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+static err_t atender(conexao_t *c) {
+    size_t total;
+    const char *dados = responder(c->linha, &total);
+    // A cópia para o lwIP deixa o buffer livre para a próxima requisição antes do ACK
+    if (tcp_write(c->pcb, dados, (u16_t)total, TCP_WRITE_FLAG_COPY) != ERR_OK) {
+        struct tcp_pcb *pcb = c->pcb;
+        c->pcb = NULL;
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    metricas_incrementar(METRICA_HTTP_RESPOSTAS);
+    return fechar(c); // o FIN entra no segmento que ainda não saiu
+}
+
+static err_t ao_receber(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+    conexao_t *c = arg;
+    if (!p) return fechar(c); // o cliente fechou
+    if (err != ERR_OK) {
+        pbuf_free(p);
+        return err;
+    }
+    u16_t cabe = (u16_t)(sizeof(c->linha) - 1 - c->n);
+    u16_t copiados = pbuf_copy_partial(p, c->linha + c->n, p->tot_len < cabe ? p->tot_len : cabe, 0);
+    tcp_recved(pcb, p->tot_len);
+    pbuf_free(p);
+    c->n = (uint8_t)(c->n + copiados);
+    c->linha[c->n] = '\0';
+
+    char *fim = strstr(c->linha, "\r\n");
+    if (fim) {
+        *fim = '\0';
+        return atender(c);
+    }
+    if (c->n == sizeof(c->linha) - 1) { // linha longa demais
+        strcpy(c->linha, "?");
+        return atender(c);
+    }
+    return ERR_OK;
+}
+
+static err_t ao_sondar(void *arg, struct tcp_pcb *pcb) {
+    (void)pcb;
+    conexao_t *c = arg;
+    if (++c->ociosa * POLL_INTERVALO >= HTTP_TIMEOUT_S * 2) return fechar(c);
+    return ERR_OK;
+}
+
+static void ao_erro(void *arg, err_t err) {
+    (void)err;
+    conexao_t *c = arg;
+    if (c) c->pcb = NULL; // o lwIP já liberou o PCB
+}
+
+static err_t ao_aceitar(void *arg, struct tcp_pcb *pcb, err_t err) {
+    (void)arg;
+    if (err != ERR_OK || !pcb) return ERR_VAL;
+    conexao_t *c = NULL;
+    for (int i = 0; i < HTTP_CONEXOES && !c; i++) {
+        if (!conexoes[i].pcb) c = &conexoes[i];
+    }
+    if (!c) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    c->pcb = pcb;
+    c->ociosa = 0;
+    c->n = 0;
+    tcp_setprio(pcb, TCP_PRIO_MIN); // sem PCB livre, o lwIP derruba estas antes da do MQTT
+    tcp_nagle_disable(pcb);
+    tcp_arg(pcb, c);
+    tcp_recv(pcb, ao_receber);
+    tcp_err(pcb, ao_erro);
+    tcp_poll(pcb, ao_sondar, POLL_INTERVALO);
+    return ERR_OK;
+}
+
+void servidor_http_iniciar() {
+    if (escuta) return;
+    cyw43_arch_lwip_begin();
+    struct tcp_pcb *pcb = tcp_new_ip_type(IPADDR_TYPE_ANY);
+    if (pcb && tcp_bind(pcb, IP_ANY_TYPE, HTTP_PORTA) == ERR_OK) {
+        escuta = tcp_listen_with_backlog(pcb, HTTP_CONEXOES);
+    }
+    if (escuta) {
+        tcp_accept(escuta, ao_aceitar);
+    } else if (pcb) {
+        tcp_close(pcb); // tcp_listen só libera o PCB original quando dá certo
+    }
+    cyw43_arch_lwip_end();
+
+    if (escuta) printf("[http] Servidor na porta %d\n", HTTP_PORTA);
+    else printf("[http] Falha ao abrir a porta %d\n", HTTP_PORTA);
+}
@@ -0,0 +1,28 @@
+// servidor_http.h - Estado, histórico e métricas do nó em HTTP na rede local (API raw TCP do lwIP)
+
+#ifndef SERVIDOR_HTTP_H
+#define SERVIDOR_HTTP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Começa a escutar em HTTP_PORTA. Chamar depois de cyw43_arch_init(); chamadas
+ *        seguintes não fazem nada. O servidor atende em qualquer endereço que a interface ganhar.
+ *
+ * Rotas (GET): / página de estado, /status, /historico e /metricas em JSON. Cada resposta é
+ * montada inteira e enviada numa escrita seguida do FIN, o que cabe num segmento TCP.
+ */
+void servidor_http_iniciar();
+
+/**
+ * @brief Atualiza o que o servidor mostra com o resultado de uma janela de medição.
+ *
+ * @param media_mm Média da janela (só entra no histórico se valida).
+ * @param valida   A janela teve leituras válidas suficientes para a média.
+ * @param alerta   Estado de alerta do monitor.
+ * @param rele     Relé acionado pelo intertravamento.
+ */
+void servidor_http_registrar(uint16_t media_mm, bool valida, bool alerta, bool rele);
+
+#endif // SERVIDOR_HTTP_H
@@ -0,0 +1,14 @@
+// texto.c - Montagem de JSON e HTML em buffer fixo, sem alocação
+
+#include "texto.h"
+#include <stdarg.h>
+#include <stdio.h>
+
+void texto_anexar(char *buf, size_t tamanho, size_t *pos, const char *fmt, ...) {
+    if (*pos >= tamanho) return;
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf + *pos, tamanho - *pos, fmt, args);
+    va_end(args);
+    *pos += n > 0 ? (size_t)n : 0;
+}
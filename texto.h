@@ -0,0 +1,17 @@
+// texto.h - Montagem de JSON e HTML em buffer fixo, sem alocação
+
+#ifndef TEXTO_H
+#define TEXTO_H
+
+#include <stddef.h>
+
+/**
+ * @brief Formata como printf no fim do texto em buf[*pos] e avança *pos.
+ *
+ * Se não couber, o texto fica truncado (sempre terminado em '\0') e *pos passa de 'tamanho',
+ * então as chamadas seguintes não escrevem nada; quem monta compara *pos com 'tamanho' no fim.
+ */
+void texto_anexar(char *buf, size_t tamanho, size_t *pos, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+#endif // TEXTO_H
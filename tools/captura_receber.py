@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""Recebe a captura bruta do VL53L0X (captura.c) pela USB e grava CSV ou Parquet.
+
+Com a captura ligada (tecla 'c' no terminal, ou --iniciar), cada medição sai num quadro
+binário de 22 bytes, little-endian:
+  0xA5 0x5A | tipo=1 | tamanho=16 | seq u32 | t_us u32 | distancia_mm u16 | status u8 |
+  flags u8 | sinal u16 (MCPS 9.7) | ambiente u16 (MCPS 9.7) | CRC-16/CCITT de tipo..payload
+
+O texto que o firmware continua imprimindo fica entre os quadros e é descartado. Buracos no
+seq são medições que a fila da placa descartou ou quadros corrompidos no caminho.
+
+Uso:
+  tools/captura_receber.py /dev/ttyACM0 --iniciar -o captura.csv
+  tools/captura_receber.py /dev/ttyACM0 --iniciar --segundos 600 -o captura.parquet
+  echo c | ./build-host/botosmart_host | tools/captura_receber.py - -o captura.csv
+
+A porta serial precisa de pyserial (pip install pyserial); Parquet precisa de pyarrow.
+"""
+import argparse
+import csv
+import struct
+import sys
+import time
+
+from quadros import TIPO_AMOSTRA, Leitor
+
+PAYLOAD = struct.Struct("<IIHBBHH")
+FLAG_ERRO = 0x01
+FLAG_ACEITA = 0x02
+COLUNAS = ["seq", "t_us", "distancia_mm", "status", "erro", "aceita", "sinal_mcps", "ambiente_mcps"]
+
+
+class Decodificador:
+    def __init__(self):
+        self.leitor = Leitor()
+        self.quadros = 0
+        self.perdidos = 0
+        self.seq_esperado = None
+
+    def alimentar(self, dados):
+        # Outros tipos (mensagens do registro adiado) são ignorados aqui
+        for tipo, payload in self.leitor.alimentar(dados):
+            if tipo == TIPO_AMOSTRA and len(payload) == PAYLOAD.size:
+                yield self.amostra(payload)
+
+    def amostra(self, payload):
+        seq, t_us, dist, status, flags, sinal, ambiente = PAYLOAD.unpack(payload)
+        if self.seq_esperado is not None and seq > self.seq_esperado:
+            self.perdidos += seq - self.seq_esperado
+        self.seq_esperado = seq + 1
+        self.quadros += 1
+        return [seq, t_us, dist, status, int(bool(flags & FLAG_ERRO)), int(bool(flags & FLAG_ACEITA)),
+                round(sinal / 128, 4), round(ambiente / 128, 4)]
+
+
+def abrir_entrada(caminho, iniciar):
+    if caminho == "-":
+        if iniciar:
+            sys.exit("--iniciar só vale para porta serial; na simulação use: echo c | botosmart_host")
+        return sys.stdin.buffer.raw.read, None
+    import serial  # pyserial
+    porta = serial.Serial(caminho, 115200, timeout=0.2)
+    if iniciar:
+        porta.write(b"c")
+    return lambda n: porta.read(n), porta
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("entrada", help="porta serial (ex.: /dev/ttyACM0) ou - para a entrada padrão")
+    ap.add_argument("-o", "--saida", required=True, help="arquivo .csv ou .parquet")
+    ap.add_argument("--iniciar", action="store_true", help="manda 'c' à placa no início e no fim (liga/desliga)")
+    ap.add_argument("--segundos", type=float, help="para depois deste tempo (padrão: até EOF ou Ctrl+C)")
+    args = ap.parse_args()
+
+    parquet = args.saida.endswith(".parquet")
+    linhas = []
+    arquivo = None if parquet else open(args.saida, "w", newline="")
+    escritor = None if parquet else csv.writer(arquivo)
+    if escritor:
+        escritor.writerow(COLUNAS)
+
+    ler, porta = abrir_entrada(args.entrada, args.iniciar)
+    dec = Decodificador()
+    fim = time.monotonic() + args.segundos if args.segundos else None
+    try:
+        while fim is None or time.monotonic() < fim:
+            dados = ler(4096)
+            if not dados:
+                if porta is None:
+                    break  # EOF
+                continue
+            for linha in dec.alimentar(dados):
+                if parquet:
+                    linhas.append(linha)
+                else:
+                    escritor.writerow(linha)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if porta is not None:
+            if args.iniciar:
+                porta.write(b"c")
+            porta.close()
+
+    if parquet:
+        import pyarrow as pa
+        import pyarrow.parquet as pq
+        pq.write_table(pa.table({c: [l[i] for l in linhas] for i, c in enumerate(COLUNAS)}), args.saida)
+    else:
+        arquivo.close()
+    print(f"{dec.quadros} quadros, {dec.perdidos} medições faltando no seq, {dec.leitor.invalidos} quadros inválidos, "
+          f"{dec.leitor.descartados} bytes de texto descartados", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Orçamento de memória por módulo a partir do mapa do link (botosmart.elf.map).
+
+Soma as seções de entrada de cada objeto nas colunas:
+  flash  .text, .rodata e demais seções só de leitura
+  data   .data e .scratch_x/.scratch_y: ocupam a RAM e também a flash (cópia inicial)
+  bss    .bss, .uninitialized_data, tabela de vetores na RAM
+e fecha com o total da RAM: estática, heap (do fim da .bss ao fim da RAM, de onde sai o malloc)
+e as pilhas reservadas nos scratch de cada core. O uso real das pilhas e o mínimo de heap livre
+em campo saem em memoria.c (medidores pilha_core0_max, pilha_core1_max e heap_livre_min).
+
+O CMake roda este script depois de cada build do firmware. Avulso:
+  tools/orcamento_memoria.py build/botosmart.elf.map
+  tools/orcamento_memoria.py build/botosmart.elf.map --todos --json orcamento.json
+"""
+import argparse
+import json
+import os
+import re
+import sys
+
+MODULOS_PADRAO = 25
+
+SECAO_SAIDA = re.compile(r"^(\.[\w.]+|[A-Za-z_][\w.]*)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+))?")
+SECAO_ENTRADA = re.compile(r"^ (\S+)(?:\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(.+))?)?\s*$")
+CONTINUACAO = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(.+))?\s*$")
+SIMBOLO = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+(\w+) = ")
+REGIAO = re.compile(r"^(\w+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+
+
+def coluna(secao_saida):
+    """Coluna do relatório para uma seção de saída, ou None se não ocupa memória da placa."""
+    if secao_saida in (".data", ".tdata") or secao_saida.startswith(".scratch_"):
+        return "data"
+    if secao_saida in (".bss", ".tbss", ".uninitialized_data", ".ram_vector_table"):
+        return "bss"
+    if secao_saida in (".heap", ".stack_dummy", ".stack1_dummy") or secao_saida.startswith((".debug", ".comment")):
+        return None  # heap e pilhas entram no resumo; depuração não vai para a placa
+    if secao_saida.startswith((".text", ".rodata", ".ARM", ".binary_info", ".boot2", ".flash_", ".init", ".fini",
+                               ".eh_frame", ".gcc_except")):
+        return "flash"
+    return None
+
+
+def modulo(arquivo):
+    """Nome curto do dono de uma seção: fonte do projeto, biblioteca do SDK ou arquivo .a."""
+    arquivo = arquivo.strip()
+    m = re.search(r"([^/\\]+\.a)\(", arquivo)
+    if m:
+        return m.group(1)
+    caminho = arquivo.replace("\\", "/")
+    m = re.search(r"/src/(?:rp2_common|common|rp2040|rp2350|host)/(\w+)/", caminho)
+    if m:
+        return "sdk:" + m.group(1)
+    m = re.search(r"/lib/(lwip|cyw43-driver|btstack|mbedtls|tinyusb)/", caminho)
+    if m:
+        return "sdk:" + m.group(1)
+    nome = os.path.basename(caminho)
+    return re.sub(r"\.(c|cpp|cc|S|s)\.(obj|o)$|\.(obj|o)$", "", nome)
+
+
+def ler_mapa(caminho):
+    modulos = {}
+    simbolos = {}
+    regioes = {}
+    estado = "inicio"
+    saida = None
+    pendente = None  # nome de seção de entrada longo demais, com endereço na linha seguinte
+
+    def somar(dono, tamanho):
+        col = coluna(saida) if saida else None
+        if col and tamanho:
+            linha = modulos.setdefault(dono, {"flash": 0, "data": 0, "bss": 0})
+            linha[col] += tamanho
+
+    with open(caminho, encoding="utf-8", errors="replace") as f:
+        for linha in f:
+            linha = linha.rstrip("\n")
+            if linha.startswith("Memory Configuration"):
+                estado = "regioes"
+                continue
+            if linha.startswith("Linker script and memory map"):
+                estado = "mapa"
+                continue
+            if estado == "regioes":
+                m = REGIAO.match(linha)
+                if m and m.group(1) != "Name":
+                    regioes[m.group(1)] = (int(m.group(2), 16), int(m.group(3), 16))
+                continue
+            if estado != "mapa" or not linha:
+                continue
+
+            m = SIMBOLO.match(linha)
+            if m:
+                simbolos[m.group(2)] = int(m.group(1), 16)
+                continue
+            if pendente is not None:
+                m = CONTINUACAO.match(linha)
+                pendente = None
+                if m:
+                    somar(modulo(m.group(3)) if m.group(3) else "(ligador)", int(m.group(2), 16))
+                    continue
+            if not linha[0].isspace():
+                m = SECAO_SAIDA.match(linha)
+                if m and m.group(1).startswith("."):
+                    saida = m.group(1)
+                continue
+            m = SECAO_ENTRADA.match(linha)
+            if not m or m.group(1).startswith("*("):
+                continue
+            if m.group(2) is None:
+                pendente = m.group(1)
+                continue
+            if m.group(1) == "*fill*":
+                dono = "(preenchimento)"
+            else:
+                dono = modulo(m.group(4)) if m.group(4) else "(ligador)"
+            somar(dono, int(m.group(3), 16))
+    return modulos, simbolos, regioes
+
+
+def resumo(modulos, simbolos, regioes):
+    total = {c: sum(l[c] for l in modulos.values()) for c in ("flash", "data", "bss")}
+    r = {"flash": total["flash"] + total["data"], "ram_estatica": total["data"] + total["bss"]}
+    if "RAM" in regioes:
+        origem, tamanho = regioes["RAM"]
+        r["ram"] = tamanho
+        fim_estatico = simbolos.get("__end__", simbolos.get("end"))
+        if fim_estatico is not None:
+            r["heap"] = origem + tamanho - fim_estatico
+    if "FLASH" in regioes:
+        r["flash_total"] = regioes["FLASH"][1]
+    for core, (topo, base) in enumerate((("__StackTop", "__StackBottom"), ("__StackOneTop", "__StackOneBottom"))):
+        if topo in simbolos and base in simbolos:
+            r[f"pilha_core{core}"] = simbolos[topo] - simbolos[base]
+    return r
+
+
+def kib(n):
+    return f"{n / 1024:.1f} KiB"
+
+
+def imprimir(modulos, r, todos, saida):
+    ordem = sorted(modulos.items(), key=lambda kv: (kv[1]["data"] + kv[1]["bss"], kv[1]["flash"]), reverse=True)
+    if not todos:
+        ordem = ordem[:MODULOS_PADRAO]
+    print(f"{'módulo':<28} {'flash':>8} {'data':>7} {'bss':>7} {'ram':>7}", file=saida)
+    for nome, l in ordem:
+        print(f"{nome:<28} {l['flash']:>8} {l['data']:>7} {l['bss']:>7} {l['data'] + l['bss']:>7}", file=saida)
+    if not todos and len(modulos) > MODULOS_PADRAO:
+        print(f"... mais {len(modulos) - MODULOS_PADRAO} módulos (--todos)", file=saida)
+
+    linha = f"Flash: {kib(r['flash'])}"
+    if "flash_total" in r:
+        linha += f" de {kib(r['flash_total'])} ({100 * r['flash'] / r['flash_total']:.1f}%)"
+    print(linha, file=saida)
+    linha = f"RAM estática: {kib(r['ram_estatica'])}"
+    if "ram" in r:
+        linha += f" de {kib(r['ram'])} ({100 * r['ram_estatica'] / r['ram']:.1f}%)"
+    if "heap" in r:
+        linha += f", heap para malloc {kib(r['heap'])}"
+    print(linha, file=saida)
+    pilhas = [f"core {c} {r[f'pilha_core{c}']} B" for c in (0, 1) if f"pilha_core{c}" in r]
+    if pilhas:
+        print("Pilhas reservadas: " + ", ".join(pilhas), file=saida)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("mapa", help="arquivo .map gerado pelo link (ex.: build/botosmart.elf.map)")
+    ap.add_argument("--todos", action="store_true", help=f"lista todos os módulos (padrão: os {MODULOS_PADRAO} maiores em RAM)")
+    ap.add_argument("--json", metavar="ARQUIVO", help="grava também módulos e resumo em JSON")
+    args = ap.parse_args()
+
+    modulos, simbolos, regioes = ler_mapa(args.mapa)
+    if not modulos:
+        sys.exit(f"{args.mapa}: nenhuma seção reconhecida (é o .map do GNU ld?)")
+    r = resumo(modulos, simbolos, regioes)
+    imprimir(modulos, r, args.todos, sys.stdout)
+    if args.json:
+        with open(args.json, "w", encoding="utf-8") as f:
+            json.dump({"modulos": modulos, "resumo": r}, f, indent=1, ensure_ascii=False)
+
+
+if __name__ == "__main__":
+    main()
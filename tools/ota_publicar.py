@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""Envia uma imagem de firmware (.bin) ao nó pela atualização remota via MQTT (ota.c).
+
+A imagem vai em blocos em monitor/<nó>/ota/bloco, um setor de 4 KB por vez: o nó grava o
+setor na flash e publica (retido) o progresso em monitor/<nó>/ota/estado, e só então vai o
+próximo. O estado retido diz de onde retomar, então a ferramenta pode ser interrompida e
+chamada de novo, e o nó pode cair ou reiniciar no meio sem perder o que já foi gravado.
+
+Cada bloco: cabeçalho de 24 bytes (little-endian) seguido dos dados
+  magica "OTA1" | id | tamanho da imagem | CRC-32 da imagem | offset | CRC-32 do bloco
+
+Uso:
+  tools/ota_publicar.py build/botosmart.bin --no E6614103E7452D2F --broker 192.168.0.10 --confirmar
+
+O id do nó é o que ele publica em monitor/<nó>/status; para a frota, chame uma vez por nó.
+
+Depende de paho-mqtt (pip install paho-mqtt).
+"""
+import argparse
+import json
+import queue
+import struct
+import sys
+import time
+import zlib
+
+import paho.mqtt.client as mqtt
+
+TOPICO_RAIZ = "monitor"  # TOPICO_RAIZ em config.h
+MAGICA = 0x3141544F
+SETOR = 4096
+SLOT_MAX = 960 * 1024  # OTA_SLOT_TAMANHO em ota_troca.h
+
+
+def novo_cliente(client_id):
+    try:
+        return mqtt.Client(mqtt.CallbackAPIVersion.VERSION2, client_id=client_id)
+    except AttributeError:  # paho-mqtt 1.x
+        return mqtt.Client(client_id=client_id)
+
+
+def blocos_do_setor(imagem, ident, crc_imagem, inicio, tam_bloco):
+    """Blocos de 'inicio' até o fim do setor (ou da imagem); nenhum atravessa a fronteira."""
+    fim = min(len(imagem), (inicio // SETOR + 1) * SETOR)
+    off = inicio
+    while off < fim:
+        dados = imagem[off:min(off + tam_bloco, fim)]
+        cab = struct.pack("<6I", MAGICA, ident, len(imagem), crc_imagem, off, zlib.crc32(dados))
+        yield cab + dados
+        off += len(dados)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("imagem", help="arquivo .bin gerado pelo build (não o .uf2)")
+    ap.add_argument("--no", required=True, help="id do nó (16 dígitos hex, ou MQTT_ID_FIXO)")
+    ap.add_argument("--broker", default="localhost")
+    ap.add_argument("--porta", type=int, default=1883)
+    ap.add_argument("--id", type=lambda s: int(s, 0), help="id da imagem (padrão: CRC-32 do arquivo)")
+    ap.add_argument("--bloco", type=int, default=1024, help="bytes de dados por mensagem (padrão 1024)")
+    ap.add_argument("--timeout", type=float, default=10, help="segundos sem progresso antes de reenviar o setor")
+    ap.add_argument("--confirmar", action="store_true",
+                    help="espera o nó trocar de imagem, reiniciar e confirmar (ou reverter)")
+    ap.add_argument("--max-espera", type=float, default=3600, help="desiste depois de tantos segundos")
+    args = ap.parse_args()
+
+    with open(args.imagem, "rb") as f:
+        imagem = f.read()
+    if not imagem or len(imagem) > SLOT_MAX:
+        sys.exit(f"imagem com {len(imagem)} bytes: o slot comporta até {SLOT_MAX}")
+    if not 0 < args.bloco <= SETOR:
+        sys.exit("--bloco deve estar entre 1 e 4096")
+    crc_imagem = zlib.crc32(imagem)
+    ident = args.id if args.id is not None else crc_imagem
+    print(f"imagem {args.imagem}: {len(imagem)} bytes, crc {crc_imagem:08x}, id {ident:08x}")
+
+    topico_bloco = f"{TOPICO_RAIZ}/{args.no}/ota/bloco"
+    topico_estado = f"{TOPICO_RAIZ}/{args.no}/ota/estado"
+
+    estados = queue.Queue()
+    cliente = novo_cliente(f"ota_publicar-{args.no}")
+    cliente.on_connect = lambda c, *_: c.subscribe(topico_estado, qos=1)
+    cliente.on_message = lambda c, u, msg: estados.put(msg.payload)
+    cliente.connect(args.broker, args.porta)
+    cliente.loop_start()
+
+    limite = time.monotonic() + args.max_espera
+    enviado_de = None  # início do último setor enviado
+    ultimo_envio = 0.0
+    aplicando = False
+    fase = None
+
+    def enviar(inicio):
+        nonlocal enviado_de, ultimo_envio
+        for bloco in blocos_do_setor(imagem, ident, crc_imagem, inicio, args.bloco):
+            cliente.publish(topico_bloco, bloco, qos=1)
+        enviado_de, ultimo_envio = inicio, time.monotonic()
+        print(f"\r{inicio * 100 // len(imagem):3d}%  {inicio}/{len(imagem)} bytes", end="", flush=True)
+
+    try:
+        while time.monotonic() < limite:
+            try:
+                estado = json.loads(estados.get(timeout=1))
+            except queue.Empty:
+                # Sem resposta: o nó perdeu blocos ou está desconectado; reenvia o setor
+                if fase == "recebendo" and enviado_de is not None and time.monotonic() - ultimo_envio > args.timeout:
+                    enviar(enviado_de)
+                continue
+            except ValueError:
+                continue
+
+            fase, evento = estado.get("fase"), estado.get("evento", "")
+            if estado.get("id") != ident:
+                if fase == "em_teste":
+                    print(f"o nó está testando outra imagem ({estado.get('id'):08x}); aguardando")
+                    continue
+                fase = "recebendo"
+                if enviado_de != 0 or time.monotonic() - ultimo_envio > args.timeout:
+                    enviar(0)
+                continue
+
+            if fase == "recebendo":
+                proximo = estado.get("proximo", 0)
+                if proximo != enviado_de or time.monotonic() - ultimo_envio > args.timeout:
+                    enviar(proximo)
+            elif fase == "pronta":
+                if not aplicando:
+                    print(f"\rimagem completa e verificada pelo nó; a troca ocorre fora de alerta")
+                if not args.confirmar:
+                    return 0
+                aplicando = True
+            elif fase == "em_teste":
+                print("nó reiniciou com a imagem nova; aguardando confirmação")
+                aplicando = True
+            elif fase == "revertida":
+                print("a imagem nova não confirmou e o nó voltou à anterior")
+                return 1
+            elif fase == "ocioso":
+                if evento == "erro_crc":
+                    print("\rCRC da imagem no nó não confere; envie de novo")
+                    return 1
+                if evento == "confirmada" or aplicando:
+                    print("\rimagem confirmada pelo nó")
+                    return 0
+                print("\reste id já foi instalado e confirmado; use outro --id para reenviar")
+                return 0
+        print("\ntempo esgotado")
+        return 1
+    finally:
+        cliente.loop_stop()
+        cliente.disconnect()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
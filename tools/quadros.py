@@ -0,0 +1,49 @@
+"""Quadros binários que a placa escreve na USB (captura.c), misturados ao texto do printf.
+
+  0xA5 0x5A | tipo u8 | tamanho u8 | payload | CRC-16/CCITT (little-endian) de tipo..payload
+
+Tipos: 1 = amostra da captura bruta, 2 = mensagem do registro adiado.
+"""
+import binascii
+import struct
+
+SINCRONIA = b"\xA5\x5A"
+TIPO_AMOSTRA = 1
+TIPO_REGISTRO = 2
+
+
+class Leitor:
+    """Separa quadros válidos do resto do fluxo; o que não é quadro vai para texto(bytes)."""
+
+    def __init__(self, texto=None):
+        self.buf = bytearray()
+        self.texto = texto or (lambda dados: None)
+        self.invalidos = 0  # sincronia que não fechou com o CRC (ou quadro corrompido)
+        self.descartados = 0  # bytes fora de quadro
+
+    def _pular(self, n):
+        self.descartados += n
+        self.texto(bytes(self.buf[:n]))
+        del self.buf[:n]
+
+    def alimentar(self, dados):
+        """Gera (tipo, payload) para cada quadro completo e válido."""
+        self.buf += dados
+        while True:
+            i = self.buf.find(SINCRONIA)
+            if i < 0:
+                # Guarda o último byte: pode ser a primeira metade da sincronia
+                self._pular(len(self.buf) - (1 if self.buf[-1:] == SINCRONIA[:1] else 0))
+                return
+            self._pular(i)
+            if len(self.buf) < 4 or len(self.buf) < 4 + self.buf[3] + 2:
+                return
+            n = self.buf[3]
+            quadro = bytes(self.buf[:4 + n + 2])
+            if binascii.crc_hqx(quadro[2:4 + n], 0xFFFF) != struct.unpack_from("<H", quadro, 4 + n)[0]:
+                # Procura a próxima sincronia a partir do byte seguinte
+                self.invalidos += 1
+                self._pular(1)
+                continue
+            del self.buf[:len(quadro)]
+            yield quadro[2], quadro[4:4 + n]
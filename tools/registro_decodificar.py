@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Terminal para o registro adiado em modo binário (REGISTRO_SAIDA_BINARIA 1 em config.h).
+
+A placa manda só o id da mensagem e os argumentos (quadros tipo 2, ver quadros.py); os
+formatos vêm de registro.def, lido daqui, então o arquivo precisa ser o da mesma versão do
+firmware. O texto que o firmware ainda imprime direto passa como está.
+
+Payload do tipo 2, little-endian: id u16 | core u8 | argumentos u8 | t_us u32 | args u32...
+O t_us é o time_us_32() da placa no momento da chamada e volta a zero a cada ~71 min.
+
+Uso:
+  tools/registro_decodificar.py /dev/ttyACM0
+  ./build-host/botosmart_host | tools/registro_decodificar.py -
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+
+from quadros import TIPO_REGISTRO, Leitor
+
+DEF_PADRAO = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "registro.def")
+CONVERSAO = re.compile(r"%[-+ #0]*\d*(?:\.\d+)?(?:hh|h|ll|l)?([diuxXc%])")
+
+
+def ler_formatos(caminho):
+    """Lista de (id, nível, formato) na ordem de registro.def: a posição é o id."""
+    formatos = []
+    with open(caminho, encoding="utf-8") as f:
+        for linha in f:
+            m = re.match(r'\s*X\(\s*(\w+)\s*,\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)', linha)
+            if m:
+                formatos.append((m.group(1), m.group(2), bytes(m.group(3), "utf-8").decode("unicode_escape")
+                                 .encode("latin-1").decode("utf-8")))
+    return formatos
+
+
+def formatar(formato, args):
+    """printf com argumentos de 32 bits; %d e %i são com sinal."""
+    convertidos = []
+    for i, m in enumerate(c for c in CONVERSAO.finditer(formato) if c.group(1) != "%"):
+        v = args[i] if i < len(args) else 0
+        if m.group(1) in "di" and v >= 1 << 31:
+            v -= 1 << 32
+        convertidos.append(v)
+    return formato % tuple(convertidos)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("entrada", help="porta serial (ex.: /dev/ttyACM0) ou - para a entrada padrão")
+    ap.add_argument("--def", dest="definicoes", default=DEF_PADRAO, help="registro.def do firmware gravado")
+    args = ap.parse_args()
+
+    formatos = ler_formatos(args.definicoes)
+    saida = sys.stdout.buffer
+    leitor = Leitor(texto=saida.write)
+    if args.entrada == "-":
+        ler, porta = sys.stdin.buffer.raw.read, None
+    else:
+        import serial  # pyserial
+        porta = serial.Serial(args.entrada, 115200, timeout=0.2)
+        ler = porta.read
+
+    try:
+        while True:
+            dados = ler(4096)
+            if not dados:
+                if porta is None:
+                    break  # EOF
+                continue
+            for tipo, payload in leitor.alimentar(dados):
+                if tipo != TIPO_REGISTRO or len(payload) < 8:
+                    continue
+                ident, core, n, t_us = struct.unpack_from("<HBBI", payload)
+                valores = list(struct.unpack_from(f"<{n}I", payload, 8))
+                if ident < len(formatos):
+                    nome, nivel, formato = formatos[ident]
+                    texto = formatar(formato, valores)
+                else:
+                    nivel, texto = "?", f"mensagem {ident} desconhecida {valores} (registro.def desatualizado?)"
+                saida.write(f"{t_us / 1e6:12.6f} c{core} {nivel:<5} {texto}\n".encode())
+            saida.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if porta is not None:
+            porta.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Servidor HTTP local que faz o papel do Apps Script da planilha, para testar o fluxo do Node-RED.
+
+Aceita o POST em lote do fluxo ({"linhas": [...]}), responde como Node-RED/planilha.gs
+({"ok": true, "linhas": n}) e acrescenta as linhas num CSV. Falhas podem ser forçadas para
+exercitar a repetição com espera e a fila em disco:
+
+  tools/stub_planilha.py --porta 8081 --falhas 5         # as 5 primeiras requisições dão 503
+  tools/stub_planilha.py --taxa-falhas 0.3               # 30% das requisições dão 503
+  curl -X POST localhost:8081/fora   /   curl -X POST localhost:8081/volta   # liga/desliga a queda
+
+No fluxo, aponte a variável URL_PLANILHA da aba para http://localhost:8081/exec.
+"""
+import argparse
+import csv
+import json
+import random
+import sys
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+COLUNAS = ["id", "inicio", "fim", "n", "min_mm", "max_mm", "media_mm"]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--porta", type=int, default=8081)
+    ap.add_argument("--csv", default="planilha.csv", help="arquivo onde as linhas recebidas são acrescentadas")
+    ap.add_argument("--falhas", type=int, default=0, help="número de requisições iniciais que falham")
+    ap.add_argument("--taxa-falhas", type=float, default=0.0, help="probabilidade de cada requisição falhar")
+    args = ap.parse_args()
+
+    estado = {"falhas": args.falhas, "fora": False, "requisicoes": 0, "linhas": 0}
+
+    class Planilha(BaseHTTPRequestHandler):
+        def responder(self, codigo, corpo):
+            dados = json.dumps(corpo).encode()
+            self.send_response(codigo)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(dados)))
+            self.end_headers()
+            self.wfile.write(dados)
+
+        def do_POST(self):
+            corpo = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+            if self.path in ("/fora", "/volta"):
+                estado["fora"] = self.path == "/fora"
+                return self.responder(200, {"ok": True, "fora": estado["fora"]})
+
+            estado["requisicoes"] += 1
+            if estado["fora"] or estado["falhas"] > 0 or random.random() < args.taxa_falhas:
+                estado["falhas"] = max(0, estado["falhas"] - 1)
+                print(f"#{estado['requisicoes']}: 503 (falha forçada)", flush=True)
+                return self.responder(503, {"ok": False, "erro": "falha forçada"})
+            try:
+                linhas = json.loads(corpo)["linhas"]
+            except (ValueError, KeyError, TypeError):
+                return self.responder(400, {"ok": False, "erro": "esperado {\"linhas\": [...]}"})
+
+            with open(args.csv, "a", newline="") as f:
+                w = csv.DictWriter(f, fieldnames=COLUNAS, extrasaction="ignore")
+                if f.tell() == 0:
+                    w.writeheader()
+                w.writerows(linhas)
+            estado["linhas"] += len(linhas)
+            print(f"#{estado['requisicoes']}: {len(linhas)} linhas (total {estado['linhas']})", flush=True)
+            self.responder(200, {"ok": True, "linhas": len(linhas)})
+
+        def log_message(self, *_):
+            pass
+
+    print(f"stub da planilha em http://localhost:{args.porta}/exec -> {args.csv}", flush=True)
+    try:
+        ThreadingHTTPServer(("", args.porta), Planilha).serve_forever()
+    except KeyboardInterrupt:
+        return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
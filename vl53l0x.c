@@ -2,37 +2,217 @@
 #include "pico/stdlib.h"
 #include <string.h>
 
-static inline bool write_reg(i2c_inst_t *i2c, uint8_t reg, uint8_t val) {
+#define REG_SYSRANGE_START      0x00
+#define REG_RESULT_RANGE_STATUS 0x14
+#define REG_MODO_I2C            0x88
+#define TAM_BLOCO               12 // 0x14..0x1F: status, SPADs, taxas e distância
+#define CONFIG_CACHE            4
+
+// Sombra de um sensor: o que o driver já sabe do chip sem perguntar a ele. Os registradores
+// de configuração guardam o último valor gravado com sucesso; o bloco de resultado vem inteiro
+// na consulta que encontra a medição pronta e vale até o próximo disparo.
+typedef struct {
+    const i2c_dispositivo_t *dev;
+    uint8_t config_reg[CONFIG_CACHE];
+    uint8_t config_val[CONFIG_CACHE];
+    uint8_t num_config;
+    bool medindo;          // disparada e ainda não vista pronta
+    uint32_t inicio_us;
+    bool bloco_valido;
+    uint8_t bloco[TAM_BLOCO];
+} sombra_t;
+
+static sombra_t sombras[VL53L0X_MULTI_MAX];
+
+// NULL para um dispositivo que não passou por vl53l0x_init() (ou sem sombra livre): sem cache
+static sombra_t *sombra(const i2c_dispositivo_t *dev) {
+    for (size_t i = 0; i < count_of(sombras); i++) {
+        if (sombras[i].dev == dev) return &sombras[i];
+    }
+    return NULL;
+}
+
+// Depois de um erro de I2C o chip pode ter reiniciado: a configuração volta a ser desconhecida
+static void esquecer(sombra_t *s) {
+    if (!s) return;
+    s->num_config = 0;
+    s->medindo = false;
+    s->bloco_valido = false;
+}
+
+static inline bool write_reg(i2c_dispositivo_t *dev, uint8_t reg, uint8_t val) {
     uint8_t buf[] = {reg, val};
-    return i2c_write_blocking(i2c, VL53L0X_I2C_ADDR, buf, 2, false) == 2;
+    return i2c_bus_escrever(dev, buf, 2, false) == 2;
 }
 
-static inline bool read_reg16(i2c_inst_t *i2c, uint8_t reg, uint16_t *val) {
-    uint8_t buf[2];
-    if (i2c_write_blocking(i2c, VL53L0X_I2C_ADDR, &reg, 1, true) != 1) return false;
-    if (i2c_read_blocking(i2c, VL53L0X_I2C_ADDR, buf, 2, false) != 2) return false;
-    *val = (buf[0] << 8) | buf[1];
+// Grava um registrador de configuração só se o chip ainda não tem esse valor
+static bool escrever_config(i2c_dispositivo_t *dev, uint8_t reg, uint8_t val) {
+    sombra_t *s = sombra(dev);
+    uint8_t i = 0;
+    if (s) {
+        while (i < s->num_config && s->config_reg[i] != reg) i++;
+        if (i < s->num_config && s->config_val[i] == val) return true;
+    }
+    if (!write_reg(dev, reg, val)) {
+        esquecer(s);
+        return false;
+    }
+    if (s && i < CONFIG_CACHE) {
+        s->config_reg[i] = reg;
+        s->config_val[i] = val;
+        if (i == s->num_config) s->num_config++;
+    }
     return true;
 }
 
-bool vl53l0x_init(i2c_inst_t *i2c) {
+static void decodificar_medicao(const uint8_t *buf, vl53l0x_medicao_t *medicao) {
+    medicao->pronto = buf[0] & 0x01;
+    medicao->status = (buf[0] >> 3) & 0x0F;
+    medicao->sinal_mcps = (buf[6] << 8) | buf[7];
+    medicao->ambiente_mcps = (buf[8] << 8) | buf[9];
+    medicao->distancia_mm = (buf[10] << 8) | buf[11];
+}
+
+// Guarda na sombra o bloco lido do chip; só o de uma medição pronta fica valendo
+static void registrar_bloco(sombra_t *s, const uint8_t *bloco) {
+    if (!s) return;
+    if (bloco != s->bloco) memcpy(s->bloco, bloco, TAM_BLOCO);
+    if (bloco[0] & 0x01) {
+        s->bloco_valido = true;
+        s->medindo = false;
+    }
+}
+
+static bool ler_bloco(i2c_dispositivo_t *dev, sombra_t *s, uint8_t *bloco) {
+    if (!i2c_bus_ler_registradores(dev, REG_RESULT_RANGE_STATUS, bloco, TAM_BLOCO)) {
+        esquecer(s);
+        return false;
+    }
+    registrar_bloco(s, bloco);
+    return true;
+}
+
+static void iniciou(sombra_t *s, bool ok) {
+    if (!s) return;
+    if (!ok) {
+        esquecer(s);
+        return;
+    }
+    s->medindo = true;
+    s->inicio_us = time_us_32();
+    s->bloco_valido = false;
+}
+
+bool vl53l0x_init(i2c_dispositivo_t *dev) {
+    sombra_t *s = sombra(dev);
+    if (!s && (s = sombra(NULL))) s->dev = dev;
     sleep_ms(10);
-    return write_reg(i2c, 0x88, 0x00);
+    return escrever_config(dev, REG_MODO_I2C, 0x00);
 }
 
-bool vl53l0x_start_ranging(i2c_inst_t *i2c) {
-    return write_reg(i2c, 0x00, 0x01);
+bool vl53l0x_start_ranging(i2c_dispositivo_t *dev) {
+    // Em modo single-shot 0x00 é o gatilho (o bit volta a zero sozinho): sempre vai ao chip
+    bool ok = write_reg(dev, REG_SYSRANGE_START, 0x01);
+    iniciou(sombra(dev), ok);
+    return ok;
 }
 
-bool vl53l0x_read_distance(i2c_inst_t *i2c, uint16_t *distance) {
-    uint8_t status;
-    int tries = 100;
-    while (tries--) {
-        i2c_write_blocking(i2c, VL53L0X_I2C_ADDR, (uint8_t[]){0x14}, 1, true);
-        i2c_read_blocking(i2c, VL53L0X_I2C_ADDR, &status, 1, false);
-        if (status & 0x01) break;
-        sleep_ms(10);
+bool vl53l0x_result_ready(i2c_dispositivo_t *dev, bool *ready) {
+    sombra_t *s = sombra(dev);
+    if (s && s->bloco_valido) {
+        *ready = true;
+        return true;
     }
+    // A medição disparada não termina antes do orçamento: consultar antes só ocupa o barramento
+    if (s && s->medindo && time_us_32() - s->inicio_us < VL53L0X_ORCAMENTO_US) {
+        *ready = false;
+        return true;
+    }
+    // Consulta já com o bloco inteiro: pronta, a leitura do resultado não volta ao barramento
+    uint8_t local[TAM_BLOCO];
+    uint8_t *bloco = s ? s->bloco : local;
+    if (!ler_bloco(dev, s, bloco)) return false;
+    *ready = bloco[0] & 0x01;
+    return true;
+}
+
+bool vl53l0x_read_measurement(i2c_dispositivo_t *dev, vl53l0x_medicao_t *medicao) {
+    sombra_t *s = sombra(dev);
+    if (s && s->bloco_valido) {
+        decodificar_medicao(s->bloco, medicao);
+        return true;
+    }
+    uint8_t buf[TAM_BLOCO];
+    if (!ler_bloco(dev, s, buf)) return false;
+    decodificar_medicao(buf, medicao);
+    return true;
+}
+
+uint8_t vl53l0x_qualidade(const vl53l0x_medicao_t *medicao, uint16_t sinal_min_mcps) {
+    // Falhas de fase e de sigma devolvem distâncias plausíveis: só o status as separa
+    if (!medicao->pronto || medicao->status != VL53L0X_STATUS_VALIDO) return 0;
+    if (medicao->distancia_mm >= VL53L0X_SEM_ALVO_MM || medicao->sinal_mcps < sinal_min_mcps) return 0;
+    uint32_t retorno = (uint32_t)medicao->sinal_mcps + medicao->ambiente_mcps;
+    if (!retorno) return 0;
+    return (uint8_t)((100u * medicao->sinal_mcps + retorno / 2) / retorno);
+}
+
+bool vl53l0x_read_result(i2c_dispositivo_t *dev, uint16_t *distance) {
+    vl53l0x_medicao_t medicao;
+    if (!vl53l0x_read_measurement(dev, &medicao)) return false;
+    *distance = medicao.distancia_mm;
+    return true;
+}
 
-    return read_reg16(i2c, 0x1E, distance);
-}
\ No newline at end of file
+void vl53l0x_start_ranging_multi(i2c_dispositivo_t *const *devs, size_t n, bool *ok) {
+    const uint8_t buf[] = {REG_SYSRANGE_START, 0x01};
+    i2c_bus_escrever_todos(devs, n, buf, sizeof(buf), ok);
+    for (size_t i = 0; i < n; i++) iniciou(sombra(devs[i]), ok[i]);
+}
+
+void vl53l0x_read_measurement_multi(i2c_dispositivo_t *const *devs, size_t n, vl53l0x_medicao_t *medicoes, bool *ok) {
+    if (n > VL53L0X_MULTI_MAX) n = VL53L0X_MULTI_MAX;
+
+    // Só os que ainda não têm o bloco na sombra vão ao barramento, todos na mesma rodada
+    i2c_dispositivo_t *pendentes[VL53L0X_MULTI_MAX];
+    size_t indice[VL53L0X_MULTI_MAX], np = 0;
+    for (size_t i = 0; i < n; i++) {
+        sombra_t *s = sombra(devs[i]);
+        ok[i] = s && s->bloco_valido;
+        if (ok[i]) {
+            decodificar_medicao(s->bloco, &medicoes[i]);
+        } else {
+            indice[np] = i;
+            pendentes[np++] = devs[i];
+        }
+    }
+    if (!np) return;
+
+    uint8_t buf[VL53L0X_MULTI_MAX][TAM_BLOCO];
+    bool lidos[VL53L0X_MULTI_MAX];
+    i2c_bus_ler_registradores_todos(pendentes, np, REG_RESULT_RANGE_STATUS, buf[0], sizeof(buf[0]), lidos);
+    for (size_t j = 0; j < np; j++) {
+        size_t i = indice[j];
+        sombra_t *s = sombra(devs[i]);
+        ok[i] = lidos[j];
+        if (!ok[i]) {
+            esquecer(s);
+            continue;
+        }
+        registrar_bloco(s, buf[j]);
+        decodificar_medicao(buf[j], &medicoes[i]);
+    }
+}
+
+bool vl53l0x_read_distance(i2c_dispositivo_t *dev, uint16_t *distance, uint32_t timeout_us) {
+    absolute_time_t limite = make_timeout_time_us(timeout_us);
+    bool pronto;
+    while (true) {
+        if (!vl53l0x_result_ready(dev, &pronto)) return false;
+        if (pronto) break;
+        if (time_reached(limite)) return false;
+        sleep_us(VL53L0X_INTERVALO_POLL_US);
+    }
+
+    return vl53l0x_read_result(dev, distance);
+}
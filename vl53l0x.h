@@ -1,13 +1,55 @@
 #ifndef VL53L0X_H
 #define VL53L0X_H
 
-#include "hardware/i2c.h"
+#include "i2c_bus.h"
 #include <stdbool.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define VL53L0X_I2C_ADDR 0x29
+#define VL53L0X_INTERVALO_POLL_US 10000
+#define VL53L0X_ORCAMENTO_US 33000 // orçamento de tempo padrão depois do reset: a medição não termina antes
+#define VL53L0X_SEM_ALVO_MM 8190 // distância devolvida quando nada volta dentro do alcance
+#define VL53L0X_MULTI_MAX 8       // sensores por chamada das funções _multi
+#define VL53L0X_STATUS_VALIDO 11  // status de medição "faixa válida"; os demais são falhas (sinal, sigma, fase...)
+
+// Bloco de resultado completo (0x14..0x1F)
+typedef struct {
+    uint16_t distancia_mm;
+    uint16_t sinal_mcps;     // taxa de retorno do alvo, ponto fixo 9.7 (MCPS × 128)
+    uint16_t ambiente_mcps;  // taxa de luz ambiente, ponto fixo 9.7
+    uint8_t status;          // status de medição do sensor (VL53L0X_STATUS_VALIDO)
+    bool pronto;             // o sensor terminou a medição (bit 0 de 0x14)
+} vl53l0x_medicao_t;
+
+// O driver guarda uma sombra de até VL53L0X_MULTI_MAX sensores (os que passaram por
+// vl53l0x_init()): configuração já gravada, instante do disparo e o último bloco de resultado.
+// Um erro de I2C no sensor apaga a sombra dele.
+bool vl53l0x_init(i2c_dispositivo_t *dev);
+bool vl53l0x_start_ranging(i2c_dispositivo_t *dev);
+// Espera a medição por no máximo timeout_us; false em erro de I2C ou se a medição não terminou
+bool vl53l0x_read_distance(i2c_dispositivo_t *dev, uint16_t *distance, uint32_t timeout_us);
+// Versão sem espera, para IRQ: consulta uma vez se a medição terminou (false só em erro de I2C).
+// Antes de VL53L0X_ORCAMENTO_US desde o disparo responde "não" sem ir ao barramento; depois lê
+// o bloco de resultado inteiro numa transação.
+bool vl53l0x_result_ready(i2c_dispositivo_t *dev, bool *ready);
+// As duas leituras usam o bloco da consulta que achou a medição pronta, sem nova transação
+bool vl53l0x_read_result(i2c_dispositivo_t *dev, uint16_t *distance);
+bool vl53l0x_read_measurement(i2c_dispositivo_t *dev, vl53l0x_medicao_t *medicao);
+// Nota de 0 a 100 da medição: 0 se não terminou, se o status não é VL53L0X_STATUS_VALIDO, se
+// não há alvo ou se o sinal fica abaixo de sinal_min_mcps (9.7); senão a fração do retorno que
+// é sinal, sinal / (sinal + ambiente)
+uint8_t vl53l0x_qualidade(const vl53l0x_medicao_t *medicao, uint16_t sinal_min_mcps);
+
+// Vários sensores de uma vez (até VL53L0X_MULTI_MAX): os que estão em barramentos no PIO
+// transferem ao mesmo tempo (i2c_bus_*_todos). ok recebe o resultado de cada um.
+void vl53l0x_start_ranging_multi(i2c_dispositivo_t *const *devs, size_t n, bool *ok);
+void vl53l0x_read_measurement_multi(i2c_dispositivo_t *const *devs, size_t n, vl53l0x_medicao_t *medicoes, bool *ok);
 
-bool vl53l0x_init(i2c_inst_t *i2c);
-bool vl53l0x_start_ranging(i2c_inst_t *i2c);
-bool vl53l0x_read_distance(i2c_inst_t *i2c, uint16_t *distance);
+#ifdef __cplusplus
+}
+#endif
 
-#endif
\ No newline at end of file
+#endif